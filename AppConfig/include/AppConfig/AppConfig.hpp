@@ -1,6 +1,9 @@
 #pragma once
 
+#include <ContentStore/ContentStore.hpp>
 #include <IConfigStorage/IConfigStorage.hpp>
+#include <Metrics/Metrics.hpp>
+#include <memory>
 #include <mutex>
 
 /**
@@ -8,7 +11,13 @@
  * @brief Thread-safe implementation of application configuration storage
  *
  * Implements IConfigStorage interface with mutex protection for thread safety.
- * Stores configuration parameters in memory as key-value pairs.
+ * Stores configuration parameters in memory as compact ConfigValue objects;
+ * sdbus::Variant values are only built when a caller asks for them.
+ * The initial parameters are interned in the ContentStore and shared with
+ * every application loaded with the same contents; the first change copies
+ * them into a private map (copy-on-write).
+ * Contended lock acquisitions are timed into the
+ * `config_storage_lock_wait_seconds` histogram.
  */
 class AppConfig : public IConfigStorage
 {
@@ -22,14 +31,28 @@ class AppConfig : public IConfigStorage
 
     /**
      * @brief Get all configuration parameters (thread-safe)
-     * @return All of current parameters
+     * @return All of current parameters, converted to variants
      */
     std::map<std::string, sdbus::Variant> getAllParameters() const override;
 
+    /**
+     * @brief Visit all parameters under the lock, without copying them (thread-safe)
+     * @param visitor Receives each key and value
+     */
+    void forEachParameter(const ParameterVisitor&) const override;
+
+    /**
+     * @brief Get one configuration parameter (thread-safe)
+     * @param key Parameter name
+     * @return Value, or std::nullopt if the key is not set
+     */
+    std::optional<ConfigValue> getParameter(const std::string&) const override;
+
     /**
      * @brief Set a configuration parameter (thread-safe)
      * @param key Parameter name
      * @param value New parameter value
+     * @throw std::runtime_error If the value is not of a basic D-Bus type
      */
     void setParameter(const std::string&, const sdbus::Variant&) override;
 
@@ -40,7 +63,15 @@ class AppConfig : public IConfigStorage
     [[nodiscard]] inline std::string getAppName() const override { return app_name_; }
 
    private:
+    /**
+     * @brief Lock the storage, timing the wait only when the mutex is contended
+     * @return Owning lock
+     */
+    std::unique_lock<std::mutex> acquireLock() const;
+
     mutable std::mutex mutex_;
     std::string app_name_;
-    std::map<std::string, sdbus::Variant> parameters_;
+    std::shared_ptr<const ContentStore::Parameters> parameters_;
+    ContentStore::Parameters* private_parameters_ = nullptr;  // Set once parameters_ is no longer shared
+    LatencyHistogram& lock_wait_;
 };
@@ -1,18 +1,57 @@
 #include "AppConfig/AppConfig.hpp"
 
 AppConfig::AppConfig(std::string app_name, std::map<std::string, sdbus::Variant> config)
-    : app_name_(std::move(app_name)), parameters_(std::move(config))
+    : app_name_(std::move(app_name)),
+      lock_wait_(MetricsRegistry::instance().histogram("config_storage_lock_wait_seconds", {{"app", app_name_}}))
 {
+    ContentStore::Parameters parameters;
+    for (const auto& [key, value] : config) parameters.emplace(key, ConfigValue::fromVariant(value));
+    parameters_ = ContentStore::instance().internParameters(std::move(parameters));
+}
+
+std::unique_lock<std::mutex> AppConfig::acquireLock() const
+{
+    std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+    if (!lock.owns_lock())
+    {
+        ScopedTimer timer(&lock_wait_);
+        lock.lock();
+    }
+    return lock;
 }
 
 std::map<std::string, sdbus::Variant> AppConfig::getAllParameters() const
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return parameters_;
+    auto lock = acquireLock();
+    std::map<std::string, sdbus::Variant> result;
+    for (const auto& [key, value] : *parameters_) result.emplace_hint(result.end(), key, value.toVariant());
+    return result;
+}
+
+void AppConfig::forEachParameter(const ParameterVisitor& visitor) const
+{
+    auto lock = acquireLock();
+    for (const auto& [key, value] : *parameters_) visitor(key, value);
+}
+
+std::optional<ConfigValue> AppConfig::getParameter(const std::string& key) const
+{
+    auto lock = acquireLock();
+    if (const auto it = parameters_->find(key); it != parameters_->end())
+        return it->second;
+    return std::nullopt;
 }
 
 void AppConfig::setParameter(const std::string& key, const sdbus::Variant& value)
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    parameters_[key] = value;
+    auto converted = ContentStore::instance().internValue(ConfigValue::fromVariant(value));
+    auto lock = acquireLock();
+    if (!private_parameters_)
+    {
+        // The interned parameters may be shared with other applications
+        auto copy = std::make_shared<ContentStore::Parameters>(*parameters_);
+        private_parameters_ = copy.get();
+        parameters_ = std::move(copy);
+    }
+    private_parameters_->insert_or_assign(key, std::move(converted));
 }
\ No newline at end of file
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <sdbus-c++/sdbus-c++.h>
+
+#include <ConfigValue/ConfigValue.hpp>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+static const std::string ERROR_TRUNCATED = "Truncated binary configuration data";
+static const std::string ERROR_UNSUPPORTED_VALUE = "Unsupported value type for binary encoding: ";
+
+/**
+ * @class BinaryWriter
+ * @brief Appends configuration data to a byte buffer in a compact native-endian layout
+ *
+ * Values are written as their D-Bus signature character followed by the raw
+ * payload; strings are length-prefixed. The format is meant for data shared
+ * between processes on the same host (shared memory, journals, caches).
+ */
+class BinaryWriter
+{
+   public:
+    /**
+     * @brief Construct a writer appending to a buffer
+     * @param buffer Destination buffer
+     */
+    explicit BinaryWriter(std::string& buffer) : buffer_(buffer) {}
+
+    /**
+     * @brief Append a trivially copyable value
+     * @param value Value to append
+     */
+    template <typename T>
+    void write(const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        buffer_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    /**
+     * @brief Append a length-prefixed string
+     * @param value String to append
+     */
+    void writeString(std::string_view);
+
+    /**
+     * @brief Append a tagged value
+     * @param value Variant holding a basic D-Bus type
+     * @throw std::runtime_error For container and other unsupported types
+     */
+    void writeValue(const sdbus::Variant&);
+
+    /**
+     * @brief Append a tagged value in the same layout as the variant overload
+     * @param value Stored value; sealed strings are written as their contents
+     */
+    void writeValue(const ConfigValue&);
+
+    /**
+     * @brief Append a whole configuration map
+     * @param config Key-value pairs to append
+     */
+    void writeConfiguration(const std::map<std::string, sdbus::Variant>&);
+
+   private:
+    std::string& buffer_;
+};
+
+/**
+ * @class BinaryReader
+ * @brief Reads data produced by BinaryWriter from a memory range
+ */
+class BinaryReader
+{
+   public:
+    /**
+     * @brief Construct a reader over a memory range
+     * @param data Start of the range
+     * @param size Size of the range in bytes
+     */
+    BinaryReader(const char* data, std::size_t size) : data_(data), size_(size) {}
+
+    /**
+     * @brief Read a trivially copyable value
+     * @return Value read
+     * @throw std::runtime_error If the range is exhausted
+     */
+    template <typename T>
+    T read()
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        require(sizeof(T));
+        T value;
+        std::memcpy(&value, data_ + position_, sizeof(T));
+        position_ += sizeof(T);
+        return value;
+    }
+
+    /**
+     * @brief Read a length-prefixed string without copying it
+     * @return View into the underlying range
+     */
+    std::string_view readStringView();
+
+    /**
+     * @brief Read a length-prefixed string
+     * @return String copy
+     */
+    std::string readString() { return std::string(readStringView()); }
+
+    /**
+     * @brief Read a tagged value
+     * @return Variant holding the value
+     * @throw std::runtime_error For unknown tags or truncated data
+     */
+    sdbus::Variant readValue();
+
+    /**
+     * @brief Read a whole configuration map
+     * @return Key-value pairs
+     */
+    std::map<std::string, sdbus::Variant> readConfiguration();
+
+    /**
+     * @brief Check whether the whole range has been consumed
+     * @return true if nothing is left to read
+     */
+    [[nodiscard]] bool atEnd() const { return position_ >= size_; }
+
+    /**
+     * @brief Get the current read offset
+     * @return Offset from the start of the range
+     */
+    [[nodiscard]] std::size_t position() const { return position_; }
+
+   private:
+    void require(std::size_t) const;
+
+    const char* data_;
+    std::size_t size_;
+    std::size_t position_ = 0;
+};
+
+/**
+ * @brief 64-bit FNV-1a hash
+ * @param data Bytes to hash
+ * @return Hash value
+ */
+[[nodiscard]] uint64_t fnv1a64(std::string_view);
\ No newline at end of file
@@ -0,0 +1,169 @@
+#include "BinaryCodec/BinaryCodec.hpp"
+
+#include <stdexcept>
+
+void BinaryWriter::writeString(std::string_view value)
+{
+    write(static_cast<uint32_t>(value.size()));
+    buffer_.append(value.data(), value.size());
+}
+
+void BinaryWriter::writeValue(const sdbus::Variant& value)
+{
+    const std::string signature = value.peekValueType();
+    if (signature.size() != 1)
+        throw std::runtime_error(ERROR_UNSUPPORTED_VALUE + signature);
+
+    write(signature.front());
+    switch (signature.front())
+    {
+        case 'b':
+            write(static_cast<uint8_t>(value.get<bool>()));
+            break;
+        case 'y':
+            write(value.get<uint8_t>());
+            break;
+        case 'n':
+            write(value.get<int16_t>());
+            break;
+        case 'q':
+            write(value.get<uint16_t>());
+            break;
+        case 'i':
+            write(value.get<int32_t>());
+            break;
+        case 'u':
+            write(value.get<uint32_t>());
+            break;
+        case 'x':
+            write(value.get<int64_t>());
+            break;
+        case 't':
+            write(value.get<uint64_t>());
+            break;
+        case 'd':
+            write(value.get<double>());
+            break;
+        case 's':
+            writeString(value.get<std::string>());
+            break;
+        default:
+            throw std::runtime_error(ERROR_UNSUPPORTED_VALUE + signature);
+    }
+}
+
+void BinaryWriter::writeValue(const ConfigValue& value)
+{
+    write(value.signature());
+    switch (value.type())
+    {
+        case ConfigValue::Type::Bool:
+            write(static_cast<uint8_t>(value.get<bool>()));
+            break;
+        case ConfigValue::Type::Byte:
+            write(value.get<uint8_t>());
+            break;
+        case ConfigValue::Type::Int16:
+            write(value.get<int16_t>());
+            break;
+        case ConfigValue::Type::UInt16:
+            write(value.get<uint16_t>());
+            break;
+        case ConfigValue::Type::Int32:
+            write(value.get<int32_t>());
+            break;
+        case ConfigValue::Type::UInt32:
+            write(value.get<uint32_t>());
+            break;
+        case ConfigValue::Type::Int64:
+            write(value.get<int64_t>());
+            break;
+        case ConfigValue::Type::UInt64:
+            write(value.get<uint64_t>());
+            break;
+        case ConfigValue::Type::Double:
+            write(value.get<double>());
+            break;
+        case ConfigValue::Type::String:
+            writeString(value.asString());
+            break;
+    }
+}
+
+void BinaryWriter::writeConfiguration(const std::map<std::string, sdbus::Variant>& config)
+{
+    write(static_cast<uint32_t>(config.size()));
+    for (const auto& [key, value] : config)
+    {
+        writeString(key);
+        writeValue(value);
+    }
+}
+
+void BinaryReader::require(std::size_t bytes) const
+{
+    if (position_ + bytes > size_)
+        throw std::runtime_error(ERROR_TRUNCATED);
+}
+
+std::string_view BinaryReader::readStringView()
+{
+    const auto length = read<uint32_t>();
+    require(length);
+    std::string_view result(data_ + position_, length);
+    position_ += length;
+    return result;
+}
+
+sdbus::Variant BinaryReader::readValue()
+{
+    const char tag = read<char>();
+    switch (tag)
+    {
+        case 'b':
+            return read<uint8_t>() != 0;
+        case 'y':
+            return read<uint8_t>();
+        case 'n':
+            return read<int16_t>();
+        case 'q':
+            return read<uint16_t>();
+        case 'i':
+            return read<int32_t>();
+        case 'u':
+            return read<uint32_t>();
+        case 'x':
+            return read<int64_t>();
+        case 't':
+            return read<uint64_t>();
+        case 'd':
+            return read<double>();
+        case 's':
+            return readString();
+        default:
+            throw std::runtime_error(ERROR_UNSUPPORTED_VALUE + std::string(1, tag));
+    }
+}
+
+std::map<std::string, sdbus::Variant> BinaryReader::readConfiguration()
+{
+    std::map<std::string, sdbus::Variant> config;
+    const auto count = read<uint32_t>();
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        auto key = readString();
+        config.emplace(std::move(key), readValue());
+    }
+    return config;
+}
+
+uint64_t fnv1a64(std::string_view data)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : data)
+    {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
\ No newline at end of file
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <sdbus-c++/sdbus-c++.h>
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+static const std::string ERROR_JOURNAL_OPEN = "Cannot open change journal: ";
+static const std::string ERROR_JOURNAL_WRITE = "Cannot write change journal: ";
+
+/**
+ * @struct JournalRecord
+ * @brief One entry of the change journal
+ */
+struct JournalRecord
+{
+    /**
+     * @enum Kind
+     * @brief What the record describes
+     */
+    enum class Kind : uint8_t
+    {
+        Override,    ///< Runtime change (ChangeConfiguration), replayed into the configuration
+        Derived,     ///< Change caused by a layer update, only advances the key version
+        Checkpoint,  ///< Version of an application at the last compaction
+        Removed      ///< The application was unregistered, its history ends here
+    };
+
+    Kind kind = Kind::Override;
+    std::string app;
+    uint64_t version = 0;
+    std::string key;      ///< Empty for Checkpoint and Removed records
+    sdbus::Variant value; ///< Only meaningful for Override and Derived records
+};
+
+/**
+ * @struct ApplicationHistory
+ * @brief State of one application rebuilt from the journal
+ */
+struct ApplicationHistory
+{
+    uint64_t base_version = 0;  ///< Oldest version changes can be reported from
+    uint64_t version = 0;       ///< Latest version
+    std::map<std::string, uint64_t> key_versions;  ///< Version of the last change of each key
+    std::map<std::string, sdbus::Variant> overrides;  ///< Runtime changes to re-apply
+};
+
+/**
+ * @class ChangeJournal
+ * @brief Append-only, memory-mapped log of configuration changes
+ *
+ * Records are framed as `size, FNV-1a checksum, payload`; a torn record left
+ * by a crash fails its checksum and ends the replay. The journal grows by
+ * doubling its mapping and is emptied by reset() after the changes have been
+ * compacted into the configuration files.
+ *
+ * Thread-safe.
+ */
+class ChangeJournal
+{
+   public:
+    /**
+     * @brief Open or create a journal file and recover its valid records
+     * @param path Journal file path
+     * @throw std::runtime_error If the file cannot be opened or mapped, or has a foreign layout
+     */
+    explicit ChangeJournal(std::string);
+
+    ChangeJournal(const ChangeJournal&) = delete;
+    ChangeJournal& operator=(const ChangeJournal&) = delete;
+
+    ~ChangeJournal();
+
+    /**
+     * @brief Append a record
+     * @param record Record to append
+     * @throw std::runtime_error If the journal cannot grow or the value cannot be encoded
+     */
+    void append(const JournalRecord&);
+
+    /**
+     * @brief Read every valid record
+     * @return Records in append order
+     */
+    [[nodiscard]] std::vector<JournalRecord> records() const;
+
+    /**
+     * @brief Rebuild the history of every application from the records
+     * @return Application name → history
+     */
+    [[nodiscard]] std::map<std::string, ApplicationHistory> replay() const;
+
+    /**
+     * @brief Drop all records and start over with checkpoints
+     *
+     * The mapping is flushed to disk before returning.
+     * @param checkpoints Application name → current version
+     */
+    void reset(const std::map<std::string, uint64_t>&);
+
+    /**
+     * @brief Get the number of bytes used by records
+     * @return Used size, excluding the file header
+     */
+    [[nodiscard]] std::size_t size() const;
+
+   private:
+    /**
+     * @brief Map the whole file
+     */
+    void map();
+
+    /**
+     * @brief Grow the file so that it can hold at least the given number of bytes
+     * @param required Minimum file size
+     */
+    void grow(std::size_t);
+
+    /**
+     * @brief Append a record, the lock is held by the caller
+     */
+    void appendLocked(const JournalRecord&);
+
+    std::string path_;
+    mutable std::mutex mutex_;
+    int fd_ = -1;
+    char* data_ = nullptr;
+    std::size_t capacity_ = 0;
+    std::size_t tail_ = 0;
+    std::string buffer_;
+};
\ No newline at end of file
@@ -0,0 +1,226 @@
+#include "ChangeJournal/ChangeJournal.hpp"
+
+#include <BinaryCodec/BinaryCodec.hpp>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+static constexpr uint32_t JOURNAL_MAGIC = 0x4A474643;  // "CFGJ"
+static constexpr uint32_t JOURNAL_FORMAT = 1;
+static constexpr std::size_t HEADER_SIZE = 64;
+static constexpr std::size_t FRAME_SIZE = sizeof(uint32_t) + sizeof(uint64_t);
+static constexpr std::size_t INITIAL_SIZE = 64 * 1024;
+
+/**
+ * @brief Decode the payload of a record
+ * @throw std::runtime_error For malformed payloads
+ */
+static JournalRecord decodeRecord(const char* payload, std::size_t size)
+{
+    BinaryReader reader(payload, size);
+    JournalRecord record;
+    record.kind = static_cast<JournalRecord::Kind>(reader.read<uint8_t>());
+    record.app = reader.readString();
+    record.version = reader.read<uint64_t>();
+    record.key = reader.readString();
+    if (record.kind == JournalRecord::Kind::Override || record.kind == JournalRecord::Kind::Derived)
+        record.value = reader.readValue();
+    return record;
+}
+
+/**
+ * @brief Walk the valid records of a mapped journal
+ * @param function Called with the payload of each record
+ * @return Offset just past the last valid record
+ */
+template <typename Function>
+static std::size_t forEachFrame(const char* data, std::size_t capacity, Function&& function)
+{
+    std::size_t offset = HEADER_SIZE;
+    while (offset + FRAME_SIZE <= capacity)
+    {
+        uint32_t size = 0;
+        uint64_t checksum = 0;
+        std::memcpy(&size, data + offset, sizeof(size));
+        std::memcpy(&checksum, data + offset + sizeof(size), sizeof(checksum));
+        if (size == 0 || offset + FRAME_SIZE + size > capacity)
+            break;
+
+        const char* payload = data + offset + FRAME_SIZE;
+        if (fnv1a64(std::string_view(payload, size)) != checksum)
+            break;
+
+        function(payload, static_cast<std::size_t>(size));
+        offset += FRAME_SIZE + size;
+    }
+    return offset;
+}
+
+ChangeJournal::ChangeJournal(std::string path) : path_(std::move(path))
+{
+    fd_ = ::open(path_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (fd_ < 0)
+        throw std::runtime_error(ERROR_JOURNAL_OPEN + path_ + ": " + std::strerror(errno));
+
+    try
+    {
+        struct stat info{};
+        if (::fstat(fd_, &info) < 0)
+            throw std::runtime_error(ERROR_JOURNAL_OPEN + path_ + ": " + std::strerror(errno));
+
+        const bool created = info.st_size == 0;
+        if (created && ::ftruncate(fd_, INITIAL_SIZE) < 0)
+            throw std::runtime_error(ERROR_JOURNAL_OPEN + path_ + ": " + std::strerror(errno));
+        capacity_ = created ? INITIAL_SIZE : static_cast<std::size_t>(info.st_size);
+        if (capacity_ < HEADER_SIZE)
+            throw std::runtime_error(ERROR_JOURNAL_OPEN + path_ + ": file too small");
+        map();
+
+        if (created)
+        {
+            std::memcpy(data_, &JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+            std::memcpy(data_ + sizeof(JOURNAL_MAGIC), &JOURNAL_FORMAT, sizeof(JOURNAL_FORMAT));
+        }
+        else
+        {
+            uint32_t magic = 0;
+            uint32_t format = 0;
+            std::memcpy(&magic, data_, sizeof(magic));
+            std::memcpy(&format, data_ + sizeof(magic), sizeof(format));
+            if (magic != JOURNAL_MAGIC || format != JOURNAL_FORMAT)
+                throw std::runtime_error(ERROR_JOURNAL_OPEN + path_ + ": unknown layout");
+        }
+
+        // Everything after the last valid record is a torn write or stale data
+        tail_ = forEachFrame(data_, capacity_, [](const char*, std::size_t) {});
+        std::memset(data_ + tail_, 0, capacity_ - tail_);
+    }
+    catch (...)
+    {
+        if (data_)
+            ::munmap(data_, capacity_);
+        ::close(fd_);
+        throw;
+    }
+}
+
+ChangeJournal::~ChangeJournal()
+{
+    ::msync(data_, capacity_, MS_SYNC);
+    ::munmap(data_, capacity_);
+    ::close(fd_);
+}
+
+void ChangeJournal::map()
+{
+    void* memory = ::mmap(nullptr, capacity_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (memory == MAP_FAILED)
+        throw std::runtime_error(ERROR_JOURNAL_OPEN + path_ + ": " + std::strerror(errno));
+    data_ = static_cast<char*>(memory);
+}
+
+void ChangeJournal::grow(std::size_t required)
+{
+    std::size_t capacity = capacity_;
+    while (capacity < required) capacity *= 2;
+
+    if (::ftruncate(fd_, static_cast<off_t>(capacity)) < 0)
+        throw std::runtime_error(ERROR_JOURNAL_WRITE + std::strerror(errno));
+
+    void* memory = ::mremap(data_, capacity_, capacity, MREMAP_MAYMOVE);
+    if (memory == MAP_FAILED)
+        throw std::runtime_error(ERROR_JOURNAL_WRITE + std::strerror(errno));
+    data_ = static_cast<char*>(memory);
+    capacity_ = capacity;
+}
+
+void ChangeJournal::append(const JournalRecord& record)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    appendLocked(record);
+}
+
+void ChangeJournal::appendLocked(const JournalRecord& record)
+{
+    buffer_.clear();
+    BinaryWriter writer(buffer_);
+    writer.write(static_cast<uint8_t>(record.kind));
+    writer.writeString(record.app);
+    writer.write(record.version);
+    writer.writeString(record.key);
+    if (record.kind == JournalRecord::Kind::Override || record.kind == JournalRecord::Kind::Derived)
+        writer.writeValue(record.value);
+
+    // Keep a zeroed frame after the record so the replay always finds the end
+    if (tail_ + 2 * FRAME_SIZE + buffer_.size() > capacity_)
+        grow(tail_ + 2 * FRAME_SIZE + buffer_.size());
+
+    const auto size = static_cast<uint32_t>(buffer_.size());
+    const uint64_t checksum = fnv1a64(buffer_);
+    std::memcpy(data_ + tail_ + FRAME_SIZE, buffer_.data(), buffer_.size());
+    std::memcpy(data_ + tail_ + sizeof(size), &checksum, sizeof(checksum));
+    std::memcpy(data_ + tail_, &size, sizeof(size));
+    tail_ += FRAME_SIZE + buffer_.size();
+}
+
+std::vector<JournalRecord> ChangeJournal::records() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<JournalRecord> result;
+    forEachFrame(data_, tail_, [&result](const char* payload, std::size_t size)
+                 { result.push_back(decodeRecord(payload, size)); });
+    return result;
+}
+
+std::map<std::string, ApplicationHistory> ChangeJournal::replay() const
+{
+    std::map<std::string, ApplicationHistory> histories;
+    for (auto& record : records())
+    {
+        if (record.kind == JournalRecord::Kind::Removed)
+        {
+            histories.erase(record.app);
+            continue;
+        }
+
+        auto& history = histories[record.app];
+        history.version = std::max(history.version, record.version);
+        switch (record.kind)
+        {
+            case JournalRecord::Kind::Checkpoint:
+                history.base_version = std::max(history.base_version, record.version);
+                break;
+            case JournalRecord::Kind::Override:
+                history.overrides[record.key] = std::move(record.value);
+                history.key_versions[record.key] = record.version;
+                break;
+            default:
+                history.key_versions[record.key] = record.version;
+                break;
+        }
+    }
+    return histories;
+}
+
+void ChangeJournal::reset(const std::map<std::string, uint64_t>& checkpoints)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::memset(data_ + HEADER_SIZE, 0, tail_ - HEADER_SIZE);
+    tail_ = HEADER_SIZE;
+
+    for (const auto& [app, version] : checkpoints)
+        appendLocked({JournalRecord::Kind::Checkpoint, app, version, {}, {}});
+    ::msync(data_, capacity_, MS_SYNC);
+}
+
+std::size_t ChangeJournal::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return tail_ - HEADER_SIZE;
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <IConfigFileManager/IConfigFileManager.hpp>
+#include <string_view>
+
+static const std::string ERROR_CONF_READ = "Cannot read config file: ";
+static const std::string ERROR_CONF_WRITE = "Cannot write config file: ";
+static const std::string ERROR_CONF_SYNTAX = "Invalid config line ";
+static const std::string ERROR_CONF_TIMEOUT = "Invalid or missing Timeout (uint required)";
+static const std::string ERROR_CONF_TIMEOUT_PHRASE = "Invalid or missing TimeoutPhrase (string required)";
+
+/**
+ * @class ConfConfigFileManager
+ * @brief INI-style `key = value` implementation of IConfigFileManager
+ *
+ * Reads legacy `.conf` files in one pass over a read-only mapping of the
+ * file, without building a document first. Each line is blank, a comment
+ * starting with `#` or `;`, a `[section]` header that prefixes the following
+ * keys with `section.`, or `key = value`. Later assignments of a key win.
+ *
+ * Value types are inferred: `true`/`false` are booleans, integers become
+ * `u` (or `i` when negative, `t`/`x` when they do not fit 32 bits), numbers
+ * with a fraction or exponent become `d`, and anything else is a string.
+ * A number may name its type first (`byte`, `int16`, `uint16`, `int32`,
+ * `int64`, `uint64` or `double`, as in `int16 -3` or `double nan`).
+ * Double-quoted values are always strings and understand `\" \\ \n \t \r`.
+ * Unquoted values end at a ` #` or ` ;` comment.
+ *
+ * save() writes the same format with strings quoted and a type in front of
+ * every number whose type would not be inferred, so types survive a reload;
+ * comments of the original file are not kept.
+ */
+class ConfConfigFileManager : public IConfigFileManager
+{
+   public:
+    /**
+     * @brief Load and validate a configuration from a .conf file
+     * @param path Path to the file
+     * @return std::map<std::string, sdbus::Variant> Parsed configuration
+     * @throw std::runtime_error If the file is missing, malformed or validation fails
+     *
+     * Expected format:
+     * @code{.ini}
+     * Timeout = 1000
+     * TimeoutPhrase = "Default phrase"  # quoted: always a string
+     * @endcode
+     */
+    [[nodiscard]] std::map<std::string, sdbus::Variant> load(const std::string&) override;
+
+    /**
+     * @brief Load a configuration layer from a .conf file
+     * @param path Path to the file
+     * @return std::map<std::string, sdbus::Variant> Parsed layer, possibly without Timeout/TimeoutPhrase
+     * @throw std::runtime_error If the file is missing or malformed, with the line number
+     */
+    [[nodiscard]] std::map<std::string, sdbus::Variant> loadLayer(const std::string&) override;
+
+    /**
+     * @brief Check that a merged configuration has a valid Timeout and TimeoutPhrase
+     * @param config Effective configuration
+     * @throw std::runtime_error If validation fails
+     */
+    void validate(const std::map<std::string, sdbus::Variant>&) override;
+
+    /**
+     * @brief Save a configuration as a .conf file, one sorted `key = value` line per key
+     * @param path Destination file path
+     * @param config Configuration data to save
+     * @throw std::runtime_error If the file cannot be written or a value has an unsupported type
+     */
+    void save(const std::string&, const std::map<std::string, sdbus::Variant>&) override;
+
+    /**
+     * @brief Parse the contents of a .conf file
+     * @param text File contents
+     * @param path File name used in error messages
+     * @return std::map<std::string, sdbus::Variant> Parsed configuration
+     * @throw std::runtime_error For malformed lines
+     */
+    [[nodiscard]] static std::map<std::string, sdbus::Variant> parse(std::string_view, const std::string&);
+
+   private:
+    /**
+     * @brief Convert the text after `=` to a typed value
+     * @param text Value with surrounding whitespace removed, comment included
+     * @return sdbus::Variant Inferred value
+     * @throw std::runtime_error For unterminated quotes, unknown escapes and text after a quoted value,
+     *        with a reason to which the caller adds the location
+     */
+    [[nodiscard]] static sdbus::Variant parseValue(std::string_view);
+};
\ No newline at end of file
@@ -0,0 +1,408 @@
+#include "ConfConfigFileManager/ConfConfigFileManager.hpp"
+
+#include <ConfigValue/ConfigValue.hpp>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+
+namespace
+{
+/**
+ * @class MappedFile
+ * @brief Read-only private mapping of a whole file
+ */
+class MappedFile
+{
+   public:
+    explicit MappedFile(const std::string& path)
+    {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            throw std::runtime_error(ERROR_CONF_READ + path + ": " + std::strerror(errno));
+
+        struct stat info{};
+        if (::fstat(fd, &info) < 0)
+        {
+            const int error = errno;
+            ::close(fd);
+            throw std::runtime_error(ERROR_CONF_READ + path + ": " + std::strerror(error));
+        }
+
+        size_ = static_cast<std::size_t>(info.st_size);
+        if (size_ > 0)
+        {
+            void* memory = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (memory == MAP_FAILED)
+            {
+                const int error = errno;
+                ::close(fd);
+                throw std::runtime_error(ERROR_CONF_READ + path + ": " + std::strerror(error));
+            }
+            data_ = static_cast<const char*>(memory);
+            // Read once front to back
+            ::madvise(memory, size_, MADV_SEQUENTIAL);
+        }
+        ::close(fd);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile()
+    {
+        if (data_)
+            ::munmap(const_cast<char*>(data_), size_);
+    }
+
+    [[nodiscard]] std::string_view view() const { return {data_, size_}; }
+
+   private:
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f'; }
+
+std::string_view trim(std::string_view text)
+{
+    while (!text.empty() && isSpace(text.front())) text.remove_prefix(1);
+    while (!text.empty() && isSpace(text.back())) text.remove_suffix(1);
+    return text;
+}
+
+bool isComment(std::string_view text) { return text.empty() || text.front() == '#' || text.front() == ';'; }
+
+/**
+ * @brief Parse the whole text as a number of type T
+ * @return true if every character was consumed
+ */
+template <typename T>
+bool parseNumber(std::string_view text, T& value)
+{
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return error == std::errc() && end == text.data() + text.size();
+}
+
+/**
+ * @brief Parse the whole text as a value of type T
+ * @return std::optional<sdbus::Variant> The value, or nothing if the text is not a valid T
+ */
+template <typename T>
+std::optional<sdbus::Variant> parseAs(std::string_view text)
+{
+    T value{};
+    if (!parseNumber(text, value))
+        return std::nullopt;
+    return sdbus::Variant(value);
+}
+
+/**
+ * @brief Parse a value written by save() with its type in front, such as `int16 -3`
+ * @return std::optional<sdbus::Variant> The value, or nothing if the text has no valid type annotation
+ */
+std::optional<sdbus::Variant> parseAnnotated(std::string_view text)
+{
+    const std::size_t space = text.find_first_of(" \t");
+    if (space == std::string_view::npos)
+        return std::nullopt;
+    const std::string_view type = text.substr(0, space);
+    const std::string_view number = trim(text.substr(space + 1));
+
+    if (type == "byte")
+        return parseAs<uint8_t>(number);
+    if (type == "int16")
+        return parseAs<int16_t>(number);
+    if (type == "uint16")
+        return parseAs<uint16_t>(number);
+    if (type == "int32")
+        return parseAs<int32_t>(number);
+    if (type == "int64")
+        return parseAs<int64_t>(number);
+    if (type == "uint64")
+        return parseAs<uint64_t>(number);
+    if (type == "double")
+        return parseAs<double>(number);
+    return std::nullopt;
+}
+
+/**
+ * @brief Infer the type of an unquoted value
+ */
+sdbus::Variant inferValue(std::string_view text)
+{
+    if (auto annotated = parseAnnotated(text))
+        return std::move(*annotated);
+
+    if (text == "true")
+        return true;
+    if (text == "false")
+        return false;
+
+    const bool negative = !text.empty() && text.front() == '-';
+    const std::string_view digits = negative ? text.substr(1) : text;
+    const bool integer = !digits.empty() && digits.find_first_not_of("0123456789") == std::string_view::npos;
+    if (integer)
+    {
+        if (negative)
+        {
+            int64_t value = 0;
+            if (parseNumber(text, value))
+            {
+                if (value >= std::numeric_limits<int32_t>::min())
+                    return static_cast<int32_t>(value);
+                return value;
+            }
+        }
+        else
+        {
+            uint64_t value = 0;
+            if (parseNumber(text, value))
+            {
+                if (value <= std::numeric_limits<uint32_t>::max())
+                    return static_cast<uint32_t>(value);
+                return value;
+            }
+        }
+        // Too large for 64 bits: kept as written
+        return std::string(text);
+    }
+
+    const bool real = !digits.empty() && (std::isdigit(static_cast<unsigned char>(digits.front())) ||
+                                          digits.front() == '.') &&
+                      digits.find_first_of(".eE") != std::string_view::npos;
+    double value = 0;
+    if (real && parseNumber(text, value))
+        return value;
+    return std::string(text);
+}
+}  // namespace
+
+sdbus::Variant ConfConfigFileManager::parseValue(std::string_view text)
+{
+    if (text.empty() || text.front() != '"')
+    {
+        // An unquoted value ends where a comment preceded by whitespace starts
+        for (std::size_t i = 1; i < text.size(); ++i)
+        {
+            if ((text[i] == '#' || text[i] == ';') && isSpace(text[i - 1]))
+            {
+                text = trim(text.substr(0, i));
+                break;
+            }
+        }
+        return inferValue(text);
+    }
+
+    std::string value;
+    std::size_t i = 1;
+    for (; i < text.size() && text[i] != '"'; ++i)
+    {
+        if (text[i] != '\\')
+        {
+            value += text[i];
+            continue;
+        }
+        if (++i == text.size())
+            break;
+        switch (text[i])
+        {
+            case '"':
+            case '\\':
+                value += text[i];
+                break;
+            case 'n':
+                value += '\n';
+                break;
+            case 't':
+                value += '\t';
+                break;
+            case 'r':
+                value += '\r';
+                break;
+            default:
+                throw std::runtime_error("unknown escape \\" + std::string(1, text[i]));
+        }
+    }
+    if (i >= text.size())
+        throw std::runtime_error("unterminated quoted value");
+    if (!isComment(trim(text.substr(i + 1))))
+        throw std::runtime_error("unexpected text after quoted value");
+    return value;
+}
+
+std::map<std::string, sdbus::Variant> ConfConfigFileManager::parse(std::string_view text, const std::string& path)
+{
+    if (text.starts_with("\xEF\xBB\xBF"))
+        text.remove_prefix(3);
+
+    std::map<std::string, sdbus::Variant> config;
+    std::string section;
+    std::size_t line_number = 0;
+    while (!text.empty())
+    {
+        const std::size_t end = text.find('\n');
+        std::string_view line = trim(text.substr(0, end));
+        text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+        ++line_number;
+
+        auto fail = [&path, line_number](const std::string& reason)
+        { throw std::runtime_error(ERROR_CONF_SYNTAX + path + ":" + std::to_string(line_number) + ": " + reason); };
+
+        if (isComment(line))
+            continue;
+
+        if (line.front() == '[')
+        {
+            if (line.back() != ']')
+                fail("unterminated section header");
+            const std::string_view name = trim(line.substr(1, line.size() - 2));
+            section = name.empty() ? std::string() : std::string(name) + ".";
+            continue;
+        }
+
+        const std::size_t equals = line.find('=');
+        if (equals == std::string_view::npos)
+            fail("expected key = value");
+        const std::string_view key = trim(line.substr(0, equals));
+        if (key.empty())
+            fail("empty key");
+
+        try
+        {
+            config.insert_or_assign(section + std::string(key), parseValue(trim(line.substr(equals + 1))));
+        }
+        catch (const std::runtime_error& e)
+        {
+            fail(e.what());
+        }
+    }
+    return config;
+}
+
+std::map<std::string, sdbus::Variant> ConfConfigFileManager::load(const std::string& file_path)
+{
+    auto config = loadLayer(file_path);
+    validate(config);
+    return config;
+}
+
+std::map<std::string, sdbus::Variant> ConfConfigFileManager::loadLayer(const std::string& file_path)
+{
+    const MappedFile file(file_path);
+    return parse(file.view(), file_path);
+}
+
+void ConfConfigFileManager::validate(const std::map<std::string, sdbus::Variant>& config)
+{
+    const auto timeout = config.find("Timeout");
+    if (timeout == config.end() || !timeout->second.containsValueOfType<uint32_t>())
+        throw std::runtime_error(ERROR_CONF_TIMEOUT);
+
+    const auto phrase = config.find("TimeoutPhrase");
+    if (phrase == config.end() || !phrase->second.containsValueOfType<std::string>())
+        throw std::runtime_error(ERROR_CONF_TIMEOUT_PHRASE);
+}
+
+void ConfConfigFileManager::save(const std::string& file_path, const std::map<std::string, sdbus::Variant>& config)
+{
+    std::string text;
+    for (const auto& [key, variant] : config)
+    {
+        const ConfigValue value = ConfigValue::fromVariant(variant);
+        text += key;
+        text += " = ";
+        switch (value.type())
+        {
+            case ConfigValue::Type::Bool:
+                text += value.get<bool>() ? "true" : "false";
+                break;
+            case ConfigValue::Type::Double:
+            {
+                char buffer[32];
+                const auto end = std::to_chars(buffer, buffer + sizeof(buffer), value.get<double>()).ptr;
+                const std::string_view number(buffer, end - buffer);
+                // NaN and infinities would otherwise be read back as strings
+                if (!std::isfinite(value.get<double>()))
+                    text += "double ";
+                text += number;
+                // Keep integral doubles from being read back as integers
+                if (number.find_first_of(".eEn") == std::string_view::npos)
+                    text += ".0";
+                break;
+            }
+            case ConfigValue::Type::String:
+            {
+                text += '"';
+                for (const char c : value.asString())
+                {
+                    switch (c)
+                    {
+                        case '"':
+                            text += "\\\"";
+                            break;
+                        case '\\':
+                            text += "\\\\";
+                            break;
+                        case '\n':
+                            text += "\\n";
+                            break;
+                        case '\t':
+                            text += "\\t";
+                            break;
+                        case '\r':
+                            text += "\\r";
+                            break;
+                        default:
+                            text += c;
+                    }
+                }
+                text += '"';
+                break;
+            }
+            // Integers are annotated with their type whenever inference alone would pick another one
+            case ConfigValue::Type::Byte:
+                text += "byte " + std::to_string(value.get<uint8_t>());
+                break;
+            case ConfigValue::Type::Int16:
+                text += "int16 " + std::to_string(value.get<int16_t>());
+                break;
+            case ConfigValue::Type::UInt16:
+                text += "uint16 " + std::to_string(value.get<uint16_t>());
+                break;
+            case ConfigValue::Type::Int32:
+                if (value.get<int32_t>() >= 0)
+                    text += "int32 ";
+                text += std::to_string(value.get<int32_t>());
+                break;
+            case ConfigValue::Type::UInt32:
+                text += std::to_string(value.get<uint32_t>());
+                break;
+            case ConfigValue::Type::Int64:
+                if (value.get<int64_t>() >= std::numeric_limits<int32_t>::min())
+                    text += "int64 ";
+                text += std::to_string(value.get<int64_t>());
+                break;
+            case ConfigValue::Type::UInt64:
+                if (value.get<uint64_t>() <= std::numeric_limits<uint32_t>::max())
+                    text += "uint64 ";
+                text += std::to_string(value.get<uint64_t>());
+                break;
+        }
+        text += '\n';
+    }
+
+    std::ofstream file(file_path, std::ios::binary | std::ios::trunc);
+    if (!file || !file.write(text.data(), static_cast<std::streamsize>(text.size())))
+        throw std::runtime_error(ERROR_CONF_WRITE + file_path);
+}
\ No newline at end of file
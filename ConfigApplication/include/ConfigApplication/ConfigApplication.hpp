@@ -2,11 +2,18 @@
 
 #include <sdbus-c++/sdbus-c++.h>
 
+#include <ConfigSnapshot/ConfigSnapshot.hpp>
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <limits>
+#include <mutex>
 #include <nlohmann/json.hpp>
+#include <random>
+#include <stop_token>
 #include <string>
 #include <thread>
+#include <vector>
 
 static const std::string DEFAULT_CONFIG_DIR = ".config/com.system.configurationManager/";
 static const std::string DEFAULT_CONFIG_FILE = "confManagerApplication1.json";
@@ -17,16 +24,36 @@ static const std::string DEFAULT_CONFIG_CONTENT = R"({
 static const std::string DBUS_SERVICE = "com.system.configurationManager";
 static const std::string DBUS_OBJECT = "/com/system/configurationManager/Application/confManagerApplication1";
 static const std::string DBUS_INTERFACE = "com.system.configurationManager.Application.Configuration";
+static const std::string DBUS_KEY_SIGNAL = "configurationKeyChanged";
+static const std::vector<std::string> WATCHED_KEYS = {"Timeout", "TimeoutPhrase"};
+static const std::string DBUS_CHANGES_SINCE = "GetChangesSince";
+static const std::string PEER_SOCKET_ENV = "CONFIG_MANAGER_PEER_SOCKET";
+static const std::string OWNER_CHANGED_RULE =
+    "type='signal',sender='org.freedesktop.DBus',path='/org/freedesktop/DBus',interface='org.freedesktop.DBus',"
+    "member='NameOwnerChanged',arg0='" + DBUS_SERVICE + "'";
+static constexpr uint64_t UNKNOWN_VERSION = std::numeric_limits<uint64_t>::max();
+static constexpr std::chrono::milliseconds RESYNC_BASE_DELAY{250};
+static constexpr std::chrono::milliseconds RESYNC_MAX_DELAY{30000};
 
 /**
  * @class ConfigApplication
  * @brief A client application that subscribes to D-Bus signals and periodically prints a configurable message.
  *
  * This class implements a D-Bus client application which:
- * - Connects to the D-Bus service `com.system.configurationManager`
- * - Subscribes to the signal `configurationChanged` on the object
- *   `/com/system/configurationManager/Application/confManagerApplication1`
- * - Updates internal configuration values (`Timeout`, `TimeoutPhrase`) upon receiving the signal
+ * - Connects to the D-Bus service `com.system.configurationManager`, directly over the
+ *   server's peer socket when `CONFIG_MANAGER_PEER_SOCKET` is set, otherwise via the session bus
+ * - Subscribes to the per-key signal `configurationKeyChanged` on the object
+ *   `/com/system/configurationManager/Application/confManagerApplication1` with one
+ *   `arg0` match rule per watched key, so changes of other keys never wake the process
+ * - Updates internal configuration values (`Timeout`, `TimeoutPhrase`) upon receiving the signal;
+ *   when the server publishes a shared-memory snapshot, the signal is only a wakeup and values
+ *   are read from the snapshot without IPC
+ * - Watches `NameOwnerChanged` of the service on the bus; when the server comes back after a
+ *   restart, asks `GetChangesSince` for the changes after the last version it saw, in a resync
+ *   answer or a key signal, so only a restart that lost the history costs a full fetch. Attempts
+ *   are delayed by a random share of an exponentially growing window, so that the clients of a
+ *   restarted server do not all call it at once and a server still loading its configurations
+ *   is not hammered
  * - Periodically prints the `TimeoutPhrase` every `Timeout` milliseconds
  */
 class ConfigApplication
@@ -68,10 +95,92 @@ class ConfigApplication
      * @brief Sets up D-Bus connection and signal handler.
      *
      * Establishes a session bus connection, creates a D-Bus proxy,
-     * and subscribes to the `configurationChanged` signal.
+     * and subscribes to `configurationKeyChanged` for every key in `WATCHED_KEYS`.
      */
     void setupDBusConnection();
 
+    /**
+     * @brief Builds the match rule selecting the change signal of one key.
+     * @param key Configuration key matched against the signal's first argument.
+     * @return Match rule string.
+     */
+    std::string keyMatchRule(const std::string&) const;
+
+    /**
+     * @brief Handles a `configurationKeyChanged` signal.
+     * @param message Signal message carrying the key, its new value and the version of the change.
+     */
+    void onKeyChanged(sdbus::Message&);
+
+    /**
+     * @brief Remembers the version of a key change unless an equal or newer one was already applied.
+     *
+     * A resync then asks only for later changes, and an older value can never replace a newer one.
+     * @param version Version carried by the `configurationKeyChanged` signal.
+     * @return true if the change is newer and has to be applied.
+     */
+    bool acceptVersion(uint64_t);
+
+    /**
+     * @brief Handles `NameOwnerChanged` of the service, scheduling a resync when it gets a new owner.
+     * @param message Signal message carrying the name, the old and the new owner.
+     */
+    void onOwnerChanged(sdbus::Message&);
+
+    /**
+     * @brief Asks the resync thread to fetch the changes missed since the last known version.
+     *
+     * Restarts the backoff, so the first attempt comes after at most `RESYNC_BASE_DELAY`.
+     */
+    void requestResync();
+
+    /**
+     * @brief Background thread function performing requested resyncs with jittered backoff.
+     * @param stop_token Stop request of the thread.
+     */
+    void resyncLoop(std::stop_token);
+
+    /**
+     * @brief Computes the delay before a resync attempt ("full jitter").
+     * @param attempt Number of failed attempts since the resync was requested.
+     * @return Random delay between zero and `RESYNC_BASE_DELAY * 2^attempt`, capped at `RESYNC_MAX_DELAY`.
+     */
+    std::chrono::milliseconds backoffDelay(unsigned);
+
+    /**
+     * @brief Fetches and applies the changes since the last known version.
+     *
+     * Asks for everything when no version is known yet or the server lost the history;
+     * re-maps the shared snapshot if one is used.
+     * @return true if the server answered.
+     */
+    bool resync();
+
+    /**
+     * @brief Opens the connection to the configuration service.
+     *
+     * Tries a direct peer-to-peer connection to the socket named by
+     * `CONFIG_MANAGER_PEER_SOCKET` first and falls back to the session bus
+     * when it is not set or not reachable.
+     * @return Established connection.
+     */
+    std::unique_ptr<sdbus::IConnection> connectToService();
+
+    /**
+     * @brief Maps the server's shared-memory configuration snapshot.
+     *
+     * Leaves the snapshot unset when the server does not provide one.
+     */
+    void openSnapshot();
+
+    /**
+     * @brief Applies the snapshot's configuration if it changed since the last read.
+     *
+     * Re-fetches the snapshot descriptor if the server moved to a new segment.
+     * @return true if a snapshot is available.
+     */
+    bool refreshFromSnapshot();
+
     /**
      * @brief Applies new configuration received via D-Bus signal.
      *
@@ -84,7 +193,7 @@ class ConfigApplication
      * @brief Background thread function for printing messages.
      *
      * Loops while `running_` is true, sleeping for `timeout_` milliseconds
-     * and then printing `timeout_phrase_`.
+     * and then printing `timeout_phrase_` to stdout.
      */
     void printLoop();
 
@@ -107,8 +216,24 @@ class ConfigApplication
     std::thread worker_thread_;
     std::unique_ptr<sdbus::IConnection> connection_;
     std::unique_ptr<sdbus::IProxy> dbus_proxy_;
+    bool direct_connection_{false};
+    std::vector<sdbus::Slot> key_subscriptions_;
+    sdbus::Slot owner_subscription_;
 
+    std::mutex snapshot_mutex_;
+    std::unique_ptr<SnapshotReader> snapshot_;
+    uint64_t snapshot_generation_{0};
+
+    mutable std::mutex config_mutex_;
     std::chrono::milliseconds timeout_{1000};
     std::string timeout_phrase_{"Default message"};
+    uint64_t known_version_{UNKNOWN_VERSION};
     std::string config_file_path_;
+
+    std::mutex resync_mutex_;
+    std::condition_variable_any resync_requested_;
+    bool resync_pending_{false};
+    unsigned resync_attempt_{0};
+    std::mt19937 jitter_{std::random_device{}()};
+    std::jthread resync_thread_;
 };
\ No newline at end of file
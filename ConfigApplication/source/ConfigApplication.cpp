@@ -1,5 +1,8 @@
 #include "ConfigApplication/ConfigApplication.hpp"
 
+#include <ConfigValue/ConfigValue.hpp>
+#include <Logger/Logger.hpp>
+#include <algorithm>
 #include <cstdlib>
 #include <filesystem>
 #include <fstream>
@@ -10,7 +13,7 @@ using json = nlohmann::json;
 
 ConfigApplication::ConfigApplication() : config_file_path_(expandPath("~/" + DEFAULT_CONFIG_DIR + DEFAULT_CONFIG_FILE))
 {
-    std::cout << "Initializing ConfigApplication...\n";
+    Logger::instance().info("Initializing ConfigApplication...");
     ensureConfigFileExists();
     loadInitialConfig();
     setupDBusConnection();
@@ -41,17 +44,17 @@ void ConfigApplication::ensureConfigFileExists()
     fs::path full_path(config_file_path_);
     fs::path dir_path = full_path.parent_path();
 
-    std::cout << "Config file location: " << full_path << '\n';
+    Logger::instance().info("Config file location: ", full_path.string());
 
     if (!fs::exists(dir_path))
     {
-        std::cout << "Creating config directory...\n";
+        Logger::instance().info("Creating config directory...");
         fs::create_directories(dir_path);
     }
 
     if (!fs::exists(full_path))
     {
-        std::cout << "Creating default config file...\n";
+        Logger::instance().info("Creating default config file...");
         std::ofstream config_file(full_path);
         if (!config_file)
             throw std::runtime_error("Failed to create config file: " + config_file_path_);
@@ -63,7 +66,7 @@ void ConfigApplication::loadInitialConfig()
 {
     try
     {
-        std::cout << "Loading config from: " << config_file_path_ << '\n';
+        Logger::instance().info("Loading config from: ", config_file_path_);
         std::ifstream config_file(config_file_path_);
         if (!config_file)
             throw std::runtime_error("Could not open config file");
@@ -77,11 +80,11 @@ void ConfigApplication::loadInitialConfig()
         if (config.contains("TimeoutPhrase"))
             timeout_phrase_ = config["TimeoutPhrase"];
 
-        std::cout << "Loaded config - Timeout: " << timeout_.count() << "ms, Phrase: '" << timeout_phrase_ << "'\n";
+        Logger::instance().info("Loaded config - Timeout: ", timeout_.count(), "ms, Phrase: '", timeout_phrase_, "'");
     }
     catch (const std::exception& e)
     {
-        std::cerr << "Warning: Could not load config - " << e.what() << "\nUsing default values\n";
+        Logger::instance().warning("Could not load config - ", e.what(), ". Using default values");
     }
 }
 
@@ -89,77 +92,313 @@ void ConfigApplication::setupDBusConnection()
 {
     try
     {
-        std::cout << "Setting up D-Bus connection...\n";
-        connection_ = sdbus::createSessionBusConnection();
+        Logger::instance().info("Setting up D-Bus connection...");
+        connection_ = connectToService();
 
-        std::cout << "Creating proxy for service: " << DBUS_SERVICE << ", object: " << DBUS_OBJECT << '\n';
-        dbus_proxy_ = sdbus::createProxy(*connection_, DBUS_SERVICE, DBUS_OBJECT);
+        // A direct peer connection has no bus daemon to route by name
+        const std::string destination = direct_connection_ ? "" : DBUS_SERVICE;
+        Logger::instance().info("Creating proxy for service: ", DBUS_SERVICE, ", object: ", DBUS_OBJECT);
+        dbus_proxy_ = sdbus::createProxy(*connection_, destination, DBUS_OBJECT);
 
-        std::cout << "Subscribing to configuration changes...\n";
-        dbus_proxy_->uponSignal("configurationChanged")
-            .onInterface(DBUS_INTERFACE)
-            .call(
-                [this](const std::map<std::string, sdbus::Variant>& config)
-                {
-                    std::cout << "\nReceived configuration update:\n";
-                    for (const auto& [key, val] : config)
-                    {
-                        try
-                        {
-                            if (val.containsValueOfType<uint32_t>())
-                                std::cout << "  " << key << " = " << val.get<uint32_t>() << '\n';
-                            else if (val.containsValueOfType<std::string>())
-                                std::cout << "  " << key << " = " << val.get<std::string>() << '\n';
-                            else if (val.containsValueOfType<bool>())
-                                std::cout << "  " << key << " = " << (val.get<bool>() ? "true" : "false") << '\n';
-                            else
-                                std::cout << "  " << key << " = [unprintable type]" << '\n';
-                        }
-                        catch (const sdbus::Error& e)
-                        {
-                            std::cerr << "Error printing config value: " << e.what() << '\n';
-                        }
-                    }
-                    applyNewConfig(config);
-                });
+        openSnapshot();
+
+        Logger::instance().info("Subscribing to configuration changes...");
+        for (const auto& key : WATCHED_KEYS)
+            key_subscriptions_.push_back(
+                connection_->addMatch(keyMatchRule(key), [this](sdbus::Message& message) { onKeyChanged(message); }));
 
         dbus_proxy_->finishRegistration();
-        std::cout << "D-Bus connection established successfully\n";
+
+        // A peer connection dies with the server, only the bus reports the service coming back
+        if (!direct_connection_)
+        {
+            owner_subscription_ =
+                connection_->addMatch(OWNER_CHANGED_RULE, [this](sdbus::Message& message) { onOwnerChanged(message); });
+            resync_thread_ = std::jthread([this](std::stop_token stop_token) { resyncLoop(stop_token); });
+        }
+        if (!resync() && resync_thread_.joinable())
+            requestResync();
+        Logger::instance().info("D-Bus connection established successfully");
     }
     catch (const std::exception& e)
     {
-        std::cerr << "D-Bus connection failed: " << e.what() << '\n';
+        Logger::instance().error("D-Bus connection failed: ", e.what());
         throw;
     }
 }
 
+std::string ConfigApplication::keyMatchRule(const std::string& key) const
+{
+    std::string rule = "type='signal',";
+    // Peer connections carry no sender names
+    if (!direct_connection_)
+        rule += "sender='" + DBUS_SERVICE + "',";
+    rule += "path='" + DBUS_OBJECT + "',interface='" + DBUS_INTERFACE + "',member='" + DBUS_KEY_SIGNAL + "',";
+    rule += "arg0='" + key + "'";
+    return rule;
+}
+
+void ConfigApplication::onKeyChanged(sdbus::Message& message)
+{
+    try
+    {
+        std::string key;
+        sdbus::Variant value;
+        uint64_t version = 0;
+        message >> key >> value >> version;
+        if (!acceptVersion(version))
+        {
+            Logger::instance().debug("Ignored update of ", key, " from version ", version, ", already applied");
+            return;
+        }
+
+        // With a snapshot the signal is only a wakeup: the value is read from shared memory
+        if (!refreshFromSnapshot())
+        {
+            // Large strings arrive as memfd descriptors
+            value = ConfigValue::fromVariant(value).toVariant();
+
+            // Formatting every received value is only worth it when somebody reads debug output
+            auto& logger = Logger::instance();
+            if (logger.enabled(LogLevel::Debug))
+            {
+                if (value.containsValueOfType<uint32_t>())
+                    logger.debug("Received update: ", key, " = ", value.get<uint32_t>());
+                else if (value.containsValueOfType<std::string>())
+                    logger.debug("Received update: ", key, " = ", value.get<std::string>());
+                else if (value.containsValueOfType<bool>())
+                    logger.debug("Received update: ", key, " = ", value.get<bool>());
+                else
+                    logger.debug("Received update: ", key, " = [unprintable type]");
+            }
+
+            applyNewConfig({{key, value}});
+        }
+    }
+    catch (const std::exception& e)
+    {
+        Logger::instance().error("Error reading configuration update: ", e.what());
+    }
+}
+
+bool ConfigApplication::acceptVersion(uint64_t version)
+{
+    // A resync answer or a signal delivered out of order may already be newer
+    std::lock_guard<std::mutex> lock(config_mutex_);
+    if (known_version_ != UNKNOWN_VERSION && version <= known_version_)
+        return false;
+    known_version_ = version;
+    return true;
+}
+
+void ConfigApplication::onOwnerChanged(sdbus::Message& message)
+{
+    try
+    {
+        std::string name;
+        std::string old_owner;
+        std::string new_owner;
+        message >> name >> old_owner >> new_owner;
+
+        if (new_owner.empty())
+        {
+            Logger::instance().warning("Configuration service left the bus, keeping the current values");
+            return;
+        }
+        Logger::instance().info("Configuration service is now owned by ", new_owner, ", resynchronizing");
+        requestResync();
+    }
+    catch (const sdbus::Error& e)
+    {
+        Logger::instance().error("Error reading owner change: ", e.what());
+    }
+}
+
+void ConfigApplication::requestResync()
+{
+    {
+        std::lock_guard<std::mutex> lock(resync_mutex_);
+        resync_pending_ = true;
+        resync_attempt_ = 0;
+    }
+    resync_requested_.notify_one();
+}
+
+std::chrono::milliseconds ConfigApplication::backoffDelay(unsigned attempt)
+{
+    const auto window = std::min<std::chrono::milliseconds>(
+        RESYNC_MAX_DELAY, RESYNC_BASE_DELAY * (int64_t{1} << std::min(attempt, 16u)));
+    std::uniform_int_distribution<std::chrono::milliseconds::rep> distribution(0, window.count());
+    return std::chrono::milliseconds(distribution(jitter_));
+}
+
+void ConfigApplication::resyncLoop(std::stop_token stop_token)
+{
+    std::unique_lock<std::mutex> lock(resync_mutex_);
+    while (!stop_token.stop_requested())
+    {
+        if (!resync_requested_.wait(lock, stop_token, [this] { return resync_pending_; }))
+            return;
+
+        // Another owner change during the delay restarts the backoff
+        const unsigned attempt = resync_attempt_;
+        const auto delay = backoffDelay(attempt);
+        if (resync_requested_.wait_for(lock, stop_token, delay, [this, attempt] { return resync_attempt_ < attempt; }))
+            continue;
+        if (stop_token.stop_requested())
+            return;
+
+        resync_pending_ = false;
+        lock.unlock();
+        const bool synced = resync();
+        lock.lock();
+
+        if (!synced && !resync_pending_)
+        {
+            resync_pending_ = true;
+            resync_attempt_ = attempt + 1;
+        }
+    }
+}
+
+bool ConfigApplication::resync()
+{
+    uint64_t since;
+    {
+        std::lock_guard<std::mutex> lock(config_mutex_);
+        since = known_version_;
+    }
+
+    try
+    {
+        uint64_t version = 0;
+        bool complete = false;
+        std::map<std::string, sdbus::Variant> changes;
+        dbus_proxy_->callMethod(DBUS_CHANGES_SINCE)
+            .onInterface(DBUS_INTERFACE)
+            .withArguments(since)
+            .storeResultsTo(version, complete, changes);
+
+        applyNewConfig(changes);
+        {
+            // Authoritative even when lower: a server that lost its history starts counting again
+            std::lock_guard<std::mutex> lock(config_mutex_);
+            known_version_ = version;
+        }
+        Logger::instance().info("Resynchronized to version ", version, complete ? " with " : " with a full fetch of ",
+                                changes.size(), " keys");
+    }
+    catch (const sdbus::Error& e)
+    {
+        Logger::instance().warning("Resync failed: ", e.what());
+        return false;
+    }
+
+    bool has_snapshot;
+    {
+        std::lock_guard<std::mutex> lock(snapshot_mutex_);
+        has_snapshot = snapshot_ != nullptr;
+    }
+    // A restarted server publishes a new segment
+    if (has_snapshot)
+    {
+        openSnapshot();
+        refreshFromSnapshot();
+    }
+    return true;
+}
+
+std::unique_ptr<sdbus::IConnection> ConfigApplication::connectToService()
+{
+    if (const char* socket_path = std::getenv(PEER_SOCKET_ENV.c_str()))
+    {
+        try
+        {
+            auto connection = sdbus::createDirectBusConnection("unix:path=" + std::string(socket_path));
+            direct_connection_ = true;
+            Logger::instance().info("Connected directly to ", socket_path);
+            return connection;
+        }
+        catch (const sdbus::Error& e)
+        {
+            Logger::instance().warning("Direct connection unavailable (", e.what(),
+                                       "), falling back to the session bus");
+        }
+    }
+    return sdbus::createSessionBusConnection();
+}
+
+void ConfigApplication::openSnapshot()
+{
+    try
+    {
+        sdbus::UnixFd fd;
+        dbus_proxy_->callMethod("GetSnapshotFd").onInterface(DBUS_INTERFACE).storeResultsTo(fd);
+
+        std::lock_guard<std::mutex> lock(snapshot_mutex_);
+        snapshot_ = std::make_unique<SnapshotReader>(fd.get());
+        snapshot_generation_ = 0;
+        Logger::instance().info("Reading configuration from shared snapshot");
+    }
+    catch (const std::exception& e)
+    {
+        // Snapshots are opt-in on the server, so this is the usual case
+        Logger::instance().info("Shared snapshot unavailable (", e.what(), "), using signal payloads");
+    }
+}
+
+bool ConfigApplication::refreshFromSnapshot()
+{
+    std::unique_lock<std::mutex> lock(snapshot_mutex_);
+    if (snapshot_ && snapshot_->stale())
+    {
+        lock.unlock();
+        openSnapshot();
+        lock.lock();
+    }
+    if (!snapshot_)
+        return false;
+    if (snapshot_->generation() == snapshot_generation_)
+        return true;
+
+    uint64_t generation = 0;
+    const auto config = snapshot_->read(&generation);
+    if (!config)
+        return true;
+
+    snapshot_generation_ = generation;
+    applyNewConfig(*config);
+    return true;
+}
+
 void ConfigApplication::applyNewConfig(const std::map<std::string, sdbus::Variant>& config)
 {
     try
     {
         bool updated = false;
+        std::lock_guard<std::mutex> lock(config_mutex_);
 
         if (config.count("Timeout"))
         {
             timeout_ = std::chrono::milliseconds(config.at("Timeout").get<uint32_t>());
-            std::cout << "Updated Timeout to: " << timeout_.count() << "ms\n";
+            Logger::instance().info("Updated Timeout to: ", timeout_.count(), "ms");
             updated = true;
         }
         if (config.count("TimeoutPhrase"))
         {
             timeout_phrase_ = config.at("TimeoutPhrase").get<std::string>();
-            std::cout << "Updated TimeoutPhrase to: '" << timeout_phrase_ << "'\n";
+            Logger::instance().info("Updated TimeoutPhrase to: '", timeout_phrase_, "'");
             updated = true;
         }
 
         if (updated)
-            std::cout << "Configuration applied successfully\n";
+            Logger::instance().debug("Configuration applied successfully");
         else
-            std::cout << "No relevant configuration changes found\n";
+            Logger::instance().debug("No relevant configuration changes found");
     }
     catch (const std::exception& e)
     {
-        std::cerr << "Error applying new config: " << e.what() << '\n';
+        Logger::instance().error("Error applying new config: ", e.what());
     }
 }
 
@@ -167,8 +406,20 @@ void ConfigApplication::printLoop()
 {
     while (running_)
     {
-        std::this_thread::sleep_for(timeout_);
-        std::cout << timeout_phrase_ << '\n';
+        refreshFromSnapshot();
+
+        std::chrono::milliseconds timeout;
+        std::string phrase;
+        {
+            std::lock_guard<std::mutex> lock(config_mutex_);
+            timeout = timeout_;
+            phrase = timeout_phrase_;
+        }
+
+        std::this_thread::sleep_for(timeout);
+        // The phrase is the program's output, not a diagnostic: it must not be truncated, dropped or filtered
+        // by the log level. One write keeps the line whole next to the logger's own lines.
+        std::cout << (phrase + '\n') << std::flush;
     }
 }
 
@@ -179,7 +430,7 @@ void ConfigApplication::run()
 
     std::thread dbus_thread([this]() { connection_->enterEventLoop(); });
 
-    std::cout << "Client started. Press Enter to exit...\n";
+    Logger::instance().info("Client started. Press Enter to exit...");
     std::cin.ignore();
 
     running_ = false;
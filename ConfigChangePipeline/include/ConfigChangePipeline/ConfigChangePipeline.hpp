@@ -0,0 +1,107 @@
+#pragma once
+
+#include <sdbus-c++/sdbus-c++.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+
+static const std::string PIPELINE_SERVICE = "com.system.configurationManager";
+static const std::string PIPELINE_OBJECT_PREFIX = "/com/system/configurationManager/Application/";
+static const std::string PIPELINE_INTERFACE = "com.system.configurationManager.Application.Configuration";
+static const std::string PIPELINE_METHOD = "ChangeConfiguration";
+static constexpr std::size_t DEFAULT_PIPELINE_WINDOW = 64;
+
+/**
+ * @class ConfigChangePipeline
+ * @brief Client-side producer of ChangeConfiguration calls for bulk tooling
+ *
+ * Instead of waiting for each reply before sending the next change, calls are
+ * sent asynchronously and up to `window` of them are kept in flight; each
+ * change() returns a future completed by the server's reply. post() sends a
+ * change flagged as not expecting a reply, for fire-and-forget producers.
+ *
+ * Replies are delivered on the connection's event loop thread, so change()
+ * must not be called from that thread. Calls from one pipeline reach the
+ * server in the order they were made.
+ *
+ * Thread-safe.
+ */
+class ConfigChangePipeline
+{
+   public:
+    /**
+     * @brief Create a pipeline with a dedicated session bus connection and event loop
+     * @param app_name Application whose configuration is changed
+     * @param window Maximum number of calls awaiting a reply
+     * @param service Bus name of the configuration manager
+     */
+    explicit ConfigChangePipeline(const std::string&, std::size_t = DEFAULT_PIPELINE_WINDOW,
+                                  std::string = PIPELINE_SERVICE);
+
+    /**
+     * @brief Create a pipeline on an existing connection
+     *
+     * The caller runs the connection's event loop, otherwise replies are never
+     * processed and change() blocks once the window is full.
+     * @param connection Connection to send the calls on
+     * @param app_name Application whose configuration is changed
+     * @param window Maximum number of calls awaiting a reply
+     * @param service Bus name of the configuration manager, empty for direct peer connections
+     */
+    ConfigChangePipeline(sdbus::IConnection&, const std::string&, std::size_t = DEFAULT_PIPELINE_WINDOW,
+                         std::string = PIPELINE_SERVICE);
+
+    ConfigChangePipeline(const ConfigChangePipeline&) = delete;
+    ConfigChangePipeline& operator=(const ConfigChangePipeline&) = delete;
+
+    /**
+     * @brief Wait for every call in flight
+     */
+    ~ConfigChangePipeline();
+
+    /**
+     * @brief Send a change, blocking while the window is full
+     * @param key Parameter name
+     * @param value New value
+     * @return Future completed by the reply, holding the sdbus::Error if the change was rejected
+     * @throw sdbus::Error If the call cannot be sent
+     */
+    std::future<void> change(const std::string&, const sdbus::Variant&);
+
+    /**
+     * @brief Send a change without asking for a reply
+     *
+     * The server skips the reply; failures are only visible in the server log.
+     * @param key Parameter name
+     * @param value New value
+     * @throw sdbus::Error If the call cannot be sent
+     */
+    void post(const std::string&, const sdbus::Variant&);
+
+    /**
+     * @brief Block until every call sent with change() has been answered
+     */
+    void wait();
+
+    /**
+     * @brief Get the number of calls awaiting a reply
+     * @return Calls in flight
+     */
+    [[nodiscard]] std::size_t inFlight() const;
+
+   private:
+    /**
+     * @brief Free a window slot after a reply
+     */
+    void release();
+
+    std::size_t window_;
+    mutable std::mutex mutex_;
+    std::condition_variable slot_freed_;
+    std::size_t in_flight_ = 0;
+    std::unique_ptr<sdbus::IProxy> proxy_;
+};
\ No newline at end of file
@@ -0,0 +1,76 @@
+#include "ConfigChangePipeline/ConfigChangePipeline.hpp"
+
+#include <algorithm>
+
+ConfigChangePipeline::ConfigChangePipeline(const std::string& app_name, std::size_t window, std::string service)
+    : window_(std::max<std::size_t>(window, 1)),
+      proxy_(sdbus::createProxy(std::move(service), PIPELINE_OBJECT_PREFIX + app_name))
+{
+}
+
+ConfigChangePipeline::ConfigChangePipeline(sdbus::IConnection& connection, const std::string& app_name,
+                                           std::size_t window, std::string service)
+    : window_(std::max<std::size_t>(window, 1)),
+      proxy_(sdbus::createProxy(connection, std::move(service), PIPELINE_OBJECT_PREFIX + app_name))
+{
+}
+
+ConfigChangePipeline::~ConfigChangePipeline() { wait(); }
+
+std::future<void> ConfigChangePipeline::change(const std::string& key, const sdbus::Variant& value)
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        slot_freed_.wait(lock, [this] { return in_flight_ < window_; });
+        ++in_flight_;
+    }
+
+    auto promise = std::make_shared<std::promise<void>>();
+    auto future = promise->get_future();
+    try
+    {
+        proxy_->callMethodAsync(PIPELINE_METHOD)
+            .onInterface(PIPELINE_INTERFACE)
+            .withArguments(key, value)
+            .uponReplyInvoke(
+                [this, promise](const sdbus::Error* error)
+                {
+                    if (error)
+                        promise->set_exception(std::make_exception_ptr(*error));
+                    else
+                        promise->set_value();
+                    release();
+                });
+    }
+    catch (...)
+    {
+        release();
+        throw;
+    }
+    return future;
+}
+
+void ConfigChangePipeline::post(const std::string& key, const sdbus::Variant& value)
+{
+    proxy_->callMethod(PIPELINE_METHOD).onInterface(PIPELINE_INTERFACE).withArguments(key, value).dontExpectReply();
+}
+
+void ConfigChangePipeline::wait()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    slot_freed_.wait(lock, [this] { return in_flight_ == 0; });
+}
+
+std::size_t ConfigChangePipeline::inFlight() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return in_flight_;
+}
+
+void ConfigChangePipeline::release()
+{
+    // Notified under the lock so that wait() in the destructor cannot return before the notification
+    std::lock_guard<std::mutex> lock(mutex_);
+    --in_flight_;
+    slot_freed_.notify_all();
+}
\ No newline at end of file
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <sdbus-c++/sdbus-c++.h>
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+static const std::string ERROR_CACHE_WRITE = "Cannot write configuration cache: ";
+
+/**
+ * @class ConfigFileCache
+ * @brief On-disk cache of parsed configuration files, reused across restarts
+ *
+ * The cache is a single file mapped read-only at startup. Each entry holds a
+ * file path, its modification time, size and FNV-1a content hash, and the
+ * parsed configuration in BinaryCodec encoding. A file whose time and size
+ * match its entry is decoded from the mapping without being opened; a file
+ * that was only touched is hashed and still reused; anything else is parsed.
+ *
+ * A cache file that is missing, truncated or fails its checksum is ignored
+ * and rewritten by save(). Not thread-safe.
+ */
+class ConfigFileCache
+{
+   public:
+    using Config = std::map<std::string, sdbus::Variant>;
+    using Parser = std::function<Config(const std::string&)>;
+
+    /**
+     * @brief Map an existing cache file
+     * @param path Cache file path
+     */
+    explicit ConfigFileCache(std::string);
+
+    ConfigFileCache(const ConfigFileCache&) = delete;
+    ConfigFileCache& operator=(const ConfigFileCache&) = delete;
+
+    ~ConfigFileCache();
+
+    /**
+     * @brief Get the configuration of a file, parsing it only if its entry is stale
+     *
+     * A file that changes while it is parsed is returned but not cached.
+     * @param file Configuration file
+     * @param parse Called with the file path on a cache miss
+     * @return Parsed configuration
+     * @throw std::runtime_error If the file cannot be read, or what the parser throws
+     */
+    Config load(const std::string&, const Parser&);
+
+    /**
+     * @brief Rewrite the cache with the entries of the files loaded since construction
+     *
+     * Does nothing if every file was a hit and none disappeared. The new file
+     * is flushed to disk and then replaced atomically.
+     * @throw std::runtime_error If the cache cannot be written
+     */
+    void save();
+
+    /**
+     * @brief Get the number of files served from the cache
+     * @return Hits
+     */
+    [[nodiscard]] std::size_t hits() const { return hits_; }
+
+    /**
+     * @brief Get the number of files that had to be parsed
+     * @return Misses
+     */
+    [[nodiscard]] std::size_t misses() const { return misses_; }
+
+   private:
+    /**
+     * @struct Entry
+     * @brief Cache entry; `config` points into the mapping or into an owned buffer
+     */
+    struct Entry
+    {
+        int64_t mtime = 0;
+        uint64_t size = 0;
+        uint64_t hash = 0;
+        std::string_view config;
+    };
+
+    /**
+     * @brief Validate the mapped file and index its entries
+     * @return false if the file is not a valid cache
+     */
+    bool index();
+
+    std::string path_;
+    const char* data_ = nullptr;
+    std::size_t mapped_size_ = 0;
+    std::unordered_map<std::string, Entry> cached_;
+    std::vector<std::pair<std::string, Entry>> loaded_;
+    std::deque<std::string> owned_;  ///< Encoded configurations of parsed files, stable addresses
+    bool dirty_ = false;
+    std::size_t hits_ = 0;
+    std::size_t misses_ = 0;
+};
\ No newline at end of file
@@ -0,0 +1,219 @@
+#include "ConfigFileCache/ConfigFileCache.hpp"
+
+#include <BinaryCodec/BinaryCodec.hpp>
+#include <Logger/Logger.hpp>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string_view>
+
+static constexpr uint32_t CACHE_MAGIC = 0x43474643;  // "CFGC"
+static constexpr uint32_t CACHE_FORMAT = 1;
+static constexpr std::size_t CACHE_HEADER_SIZE = 2 * sizeof(uint32_t) + 2 * sizeof(uint64_t);
+
+/**
+ * @brief Get the modification time (ns) and size of a file
+ * @throw std::runtime_error If the file cannot be examined
+ */
+static std::pair<int64_t, uint64_t> fileStamp(const std::string& file)
+{
+    struct stat info{};
+    if (::stat(file.c_str(), &info) < 0)
+        throw std::runtime_error("Cannot stat " + file + ": " + std::strerror(errno));
+    return {static_cast<int64_t>(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec,
+            static_cast<uint64_t>(info.st_size)};
+}
+
+/**
+ * @brief Read a whole file
+ * @throw std::runtime_error If the file cannot be read
+ */
+static std::string readFile(const std::string& file)
+{
+    std::ifstream stream(file, std::ios::binary);
+    if (!stream)
+        throw std::runtime_error("Cannot open " + file);
+    return {std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()};
+}
+
+/**
+ * @brief Write a whole file and flush it to disk
+ * @throw std::runtime_error If the file cannot be written
+ */
+static void writeDurably(const std::string& file, std::string_view header, std::string_view body)
+{
+    const int fd = ::open(file.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+        throw std::runtime_error(ERROR_CACHE_WRITE + file + ": " + std::strerror(errno));
+
+    bool written = true;
+    for (std::string_view part : {header, body})
+    {
+        while (written && !part.empty())
+        {
+            const ssize_t count = ::write(fd, part.data(), part.size());
+            if (count < 0 && errno == EINTR)
+                continue;
+            written = count > 0;
+            if (written)
+                part.remove_prefix(static_cast<std::size_t>(count));
+        }
+    }
+    // Flushed before the rename, so a crash cannot leave the cache name pointing at unwritten blocks
+    written = written && ::fsync(fd) == 0;
+    const int error = errno;
+    ::close(fd);
+    if (!written)
+        throw std::runtime_error(ERROR_CACHE_WRITE + file + ": " + std::strerror(error));
+}
+
+ConfigFileCache::ConfigFileCache(std::string path) : path_(std::move(path))
+{
+    const int fd = ::open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return;
+
+    struct stat info{};
+    if (::fstat(fd, &info) == 0 && static_cast<std::size_t>(info.st_size) >= CACHE_HEADER_SIZE)
+    {
+        void* memory = ::mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (memory != MAP_FAILED)
+        {
+            data_ = static_cast<const char*>(memory);
+            mapped_size_ = static_cast<std::size_t>(info.st_size);
+        }
+    }
+    ::close(fd);
+
+    if (data_ && !index())
+    {
+        Logger::instance().warning("Ignoring invalid configuration cache ", path_);
+        cached_.clear();
+    }
+}
+
+ConfigFileCache::~ConfigFileCache()
+{
+    if (data_)
+        ::munmap(const_cast<char*>(data_), mapped_size_);
+}
+
+bool ConfigFileCache::index()
+{
+    try
+    {
+        BinaryReader header(data_, CACHE_HEADER_SIZE);
+        if (header.read<uint32_t>() != CACHE_MAGIC || header.read<uint32_t>() != CACHE_FORMAT)
+            return false;
+        const auto count = header.read<uint64_t>();
+        const auto checksum = header.read<uint64_t>();
+
+        const std::string_view body(data_ + CACHE_HEADER_SIZE, mapped_size_ - CACHE_HEADER_SIZE);
+        if (fnv1a64(body) != checksum)
+            return false;
+
+        BinaryReader reader(body.data(), body.size());
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            std::string file(reader.readStringView());
+            Entry entry;
+            entry.mtime = reader.read<int64_t>();
+            entry.size = reader.read<uint64_t>();
+            entry.hash = reader.read<uint64_t>();
+            entry.config = reader.readStringView();
+            cached_.emplace(std::move(file), entry);
+        }
+        return reader.atEnd();
+    }
+    catch (const std::exception&)
+    {
+        return false;
+    }
+}
+
+ConfigFileCache::Config ConfigFileCache::load(const std::string& file, const Parser& parse)
+{
+    const auto [mtime, size] = fileStamp(file);
+    const auto cached = cached_.find(file);
+
+    auto decode = [](std::string_view encoded)
+    {
+        BinaryReader reader(encoded.data(), encoded.size());
+        return reader.readConfiguration();
+    };
+
+    if (cached != cached_.end() && cached->second.mtime == mtime && cached->second.size == size)
+    {
+        ++hits_;
+        loaded_.emplace_back(file, cached->second);
+        return decode(cached->second.config);
+    }
+
+    const std::string content = readFile(file);
+    const uint64_t hash = fnv1a64(content);
+    dirty_ = true;
+
+    if (cached != cached_.end() && cached->second.size == content.size() && cached->second.hash == hash)
+    {
+        // Touched but unchanged: reuse the parsed entry with the new time
+        ++hits_;
+        loaded_.emplace_back(file, Entry{mtime, content.size(), hash, cached->second.config});
+        return decode(cached->second.config);
+    }
+
+    ++misses_;
+    auto config = parse(file);
+    // The parser reads the file again: if it changed since it was hashed, the parsed values may not match the
+    // hash, so they are not cached and the next start parses the file again
+    if (content.size() != size || fileStamp(file) != std::pair{mtime, size})
+    {
+        Logger::instance().debug("Not caching ", file, ": it changed while being loaded");
+        return config;
+    }
+    std::string encoded;
+    BinaryWriter(encoded).writeConfiguration(config);
+    owned_.push_back(std::move(encoded));
+    loaded_.emplace_back(file, Entry{mtime, size, hash, owned_.back()});
+    return config;
+}
+
+void ConfigFileCache::save()
+{
+    if (!dirty_ && loaded_.size() == cached_.size())
+        return;
+
+    std::string body;
+    BinaryWriter writer(body);
+    for (const auto& [file, entry] : loaded_)
+    {
+        writer.writeString(file);
+        writer.write(entry.mtime);
+        writer.write(entry.size);
+        writer.write(entry.hash);
+        writer.writeString(entry.config);
+    }
+
+    std::string header;
+    BinaryWriter header_writer(header);
+    header_writer.write(CACHE_MAGIC);
+    header_writer.write(CACHE_FORMAT);
+    header_writer.write(static_cast<uint64_t>(loaded_.size()));
+    header_writer.write(fnv1a64(body));
+
+    const std::string temporary = path_ + ".tmp";
+    writeDurably(temporary, header, body);
+
+    std::error_code error;
+    std::filesystem::rename(temporary, path_, error);
+    if (error)
+        throw std::runtime_error(ERROR_CACHE_WRITE + error.message());
+    dirty_ = false;
+}
\ No newline at end of file
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <sdbus-c++/sdbus-c++.h>
+
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+
+static const std::string DEFAULTS_LAYER = "defaults";
+static const std::string GROUP_LAYER_PREFIX = "group/";
+static const std::string GROUP_KEY = "ConfigGroup";
+static const std::string ERROR_UNKNOWN_LAYER = "Unknown configuration layer: ";
+static const std::string ERROR_UNKNOWN_APP = "Unknown application: ";
+
+/**
+ * @class ConfigLayers
+ * @brief Resolves application configurations from stacked layers
+ *
+ * The value of a key for an application is taken from the first layer that
+ * defines it, in this order:
+ * 1. temporary overrides (ChangeConfigurationWithTTL calls), until they expire
+ * 2. runtime overrides (ChangeConfiguration calls)
+ * 3. the application's own file
+ * 4. the layer of the group named by the application's `ConfigGroup` key
+ * 5. the defaults layer
+ *
+ * Application files are interned in the ContentStore, so applications loaded
+ * from identical files share one file layer.
+ *
+ * The class only keeps the layers; effective views live in the application
+ * storages. A layer update reports, per affected application, just the keys
+ * whose effective value changed, so callers update those storages
+ * incrementally instead of re-merging every configuration.
+ *
+ * Not thread-safe: the owner serializes access.
+ */
+class ConfigLayers
+{
+   public:
+    using Config = std::map<std::string, sdbus::Variant>;
+    using Changes = std::map<std::string, Config>;  ///< Application name → changed effective keys
+
+    /**
+     * @brief Replace a shared layer before applications are added
+     * @param layer `defaults` or `group/<name>`
+     * @param config Layer contents
+     * @throw std::runtime_error For malformed layer names
+     */
+    void setLayer(const std::string&, Config);
+
+    /**
+     * @brief Get a shared layer
+     * @param layer `defaults` or `group/<name>`
+     * @return Layer contents, empty for groups without values
+     * @throw std::runtime_error For malformed layer names
+     */
+    [[nodiscard]] Config layer(const std::string&) const;
+
+    /**
+     * @brief Set a key of a shared layer
+     * @param layer `defaults` or `group/<name>`
+     * @param key Parameter name
+     * @param value New value
+     * @return Effective changes of every application the layer applies to
+     * @throw std::runtime_error For malformed layer names
+     */
+    Changes setLayerValue(const std::string&, const std::string&, const sdbus::Variant&);
+
+    /**
+     * @brief Add an application layer
+     *
+     * The `ConfigGroup` key of the file selects the group and is not part of
+     * the effective configuration.
+     * @param app Application name
+     * @param config Contents of the application file
+     * @return Effective configuration of the application
+     */
+    Config addApplication(const std::string&, Config);
+
+    /**
+     * @brief Forget an application and its runtime overrides
+     * @param app Application name
+     */
+    void removeApplication(const std::string&);
+
+    /**
+     * @brief Record a runtime override made through ChangeConfiguration
+     *
+     * Replaces a temporary override of the key.
+     * @param app Application name
+     * @param key Parameter name
+     * @param value New value
+     * @throw std::runtime_error For unknown applications
+     */
+    void setOverride(const std::string&, const std::string&, const sdbus::Variant&);
+
+    /**
+     * @brief Record a temporary override made through ChangeConfigurationWithTTL
+     * @param app Application name
+     * @param key Parameter name
+     * @param value Value until the override expires
+     * @throw std::runtime_error For unknown applications
+     */
+    void setTemporary(const std::string&, const std::string&, const sdbus::Variant&);
+
+    /**
+     * @brief Drop an expired temporary override
+     * @param app Application name
+     * @param key Parameter name
+     * @return Effective value underneath, or std::nullopt if the key had no temporary
+     *         override (it was replaced in the meantime) or nothing underneath
+     * @throw std::runtime_error For unknown applications
+     */
+    std::optional<sdbus::Variant> clearTemporary(const std::string&, const std::string&);
+
+    /**
+     * @brief Move the runtime overrides of an application into its file layer
+     *
+     * Used when compacting the change journal; the effective configuration is
+     * unchanged. Temporary overrides are never written to the file.
+     * @param app Application name
+     * @return New contents of the application file (with `ConfigGroup`),
+     *         or std::nullopt if there were no overrides
+     * @throw std::runtime_error For unknown applications
+     */
+    std::optional<Config> flattenOverrides(const std::string&);
+
+    /**
+     * @brief Merge all layers of an application
+     * @param app Application name
+     * @return Effective configuration
+     * @throw std::runtime_error For unknown applications
+     */
+    [[nodiscard]] Config effective(const std::string&) const;
+
+   private:
+    struct Application
+    {
+        std::string group;
+        std::shared_ptr<const Config> file;  ///< Interned, replaced rather than modified
+        Config overrides;
+        Config temporary;
+    };
+
+    /**
+     * @brief Get the storage of a shared layer, creating empty group layers
+     * @param layer `defaults` or `group/<name>`
+     * @return Layer map
+     */
+    Config& sharedLayer(const std::string&);
+
+    /**
+     * @brief Find the effective value of a key for an application
+     * @return Pointer into the layer holding the value, nullptr if no layer defines the key
+     */
+    [[nodiscard]] const sdbus::Variant* resolve(const Application&, const std::string&) const;
+
+    Config defaults_;
+    std::map<std::string, Config> groups_;
+    std::map<std::string, Application> applications_;
+    std::map<std::string, std::set<std::string>> group_members_;
+};
\ No newline at end of file
@@ -0,0 +1,221 @@
+#include "ConfigLayers/ConfigLayers.hpp"
+
+#include <BinaryCodec/BinaryCodec.hpp>
+#include <ContentStore/ContentStore.hpp>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * @brief Check two values for equality without relying on Variant comparison
+ * @return false if either value is missing or not a basic type
+ */
+static bool sameValue(const sdbus::Variant* lhs, const sdbus::Variant& rhs)
+{
+    if (!lhs)
+        return false;
+
+    std::string lhs_bytes;
+    std::string rhs_bytes;
+    try
+    {
+        BinaryWriter(lhs_bytes).writeValue(*lhs);
+        BinaryWriter(rhs_bytes).writeValue(rhs);
+    }
+    catch (const std::runtime_error&)
+    {
+        return false;
+    }
+    return lhs_bytes == rhs_bytes;
+}
+
+/**
+ * @brief Extract the group name of a `group/<name>` layer
+ * @throw std::runtime_error If the name is empty or could escape the layers directory
+ */
+static std::string groupName(const std::string& layer)
+{
+    if (!layer.starts_with(GROUP_LAYER_PREFIX))
+        throw std::runtime_error(ERROR_UNKNOWN_LAYER + layer);
+
+    std::string name = layer.substr(GROUP_LAYER_PREFIX.size());
+    if (name.empty() || name == "." || name == ".." || name.find('/') != std::string::npos)
+        throw std::runtime_error(ERROR_UNKNOWN_LAYER + layer);
+    return name;
+}
+
+static void mergeInto(ConfigLayers::Config& target, const ConfigLayers::Config& layer)
+{
+    for (const auto& [key, value] : layer) target[key] = value;
+}
+
+ConfigLayers::Config& ConfigLayers::sharedLayer(const std::string& layer)
+{
+    if (layer == DEFAULTS_LAYER)
+        return defaults_;
+    return groups_[groupName(layer)];
+}
+
+void ConfigLayers::setLayer(const std::string& layer, Config config) { sharedLayer(layer) = std::move(config); }
+
+ConfigLayers::Config ConfigLayers::layer(const std::string& layer) const
+{
+    if (layer == DEFAULTS_LAYER)
+        return defaults_;
+
+    const auto it = groups_.find(groupName(layer));
+    return it == groups_.end() ? Config{} : it->second;
+}
+
+const sdbus::Variant* ConfigLayers::resolve(const Application& app, const std::string& key) const
+{
+    if (const auto it = app.temporary.find(key); it != app.temporary.end())
+        return &it->second;
+    if (const auto it = app.overrides.find(key); it != app.overrides.end())
+        return &it->second;
+    if (const auto it = app.file->find(key); it != app.file->end())
+        return &it->second;
+    if (const auto group = groups_.find(app.group); group != groups_.end())
+    {
+        if (const auto it = group->second.find(key); it != group->second.end())
+            return &it->second;
+    }
+    if (const auto it = defaults_.find(key); it != defaults_.end())
+        return &it->second;
+    return nullptr;
+}
+
+ConfigLayers::Changes ConfigLayers::setLayerValue(const std::string& layer, const std::string& key,
+                                                  const sdbus::Variant& value)
+{
+    Config& target = sharedLayer(layer);
+    const bool is_defaults = layer == DEFAULTS_LAYER;
+
+    // Only the members of a group see its layer, everybody sees the defaults
+    std::vector<const std::string*> candidates;
+    if (is_defaults)
+    {
+        for (const auto& [name, app] : applications_) candidates.push_back(&name);
+    }
+    else if (const auto members = group_members_.find(groupName(layer));
+             members != group_members_.end())
+    {
+        for (const auto& name : members->second) candidates.push_back(&name);
+    }
+
+    Changes changes;
+    for (const std::string* name : candidates)
+    {
+        const Application& app = applications_.at(*name);
+        if (app.temporary.contains(key) || app.overrides.contains(key) || app.file->contains(key))
+            continue;
+        if (is_defaults)
+        {
+            const auto group = groups_.find(app.group);
+            if (group != groups_.end() && group->second.contains(key))
+                continue;
+        }
+        if (!sameValue(resolve(app, key), value))
+            changes[*name].emplace(key, value);
+    }
+
+    target[key] = value;
+    return changes;
+}
+
+ConfigLayers::Config ConfigLayers::addApplication(const std::string& app, Config config)
+{
+    removeApplication(app);
+
+    Application application;
+    if (const auto it = config.find(GROUP_KEY); it != config.end())
+    {
+        if (it->second.containsValueOfType<std::string>())
+            application.group = it->second.get<std::string>();
+        config.erase(it);
+    }
+    application.file = ContentStore::instance().internConfiguration(std::move(config));
+
+    if (!application.group.empty())
+        group_members_[application.group].insert(app);
+    applications_.emplace(app, std::move(application));
+    return effective(app);
+}
+
+void ConfigLayers::removeApplication(const std::string& app)
+{
+    const auto it = applications_.find(app);
+    if (it == applications_.end())
+        return;
+
+    if (const auto members = group_members_.find(it->second.group); members != group_members_.end())
+    {
+        members->second.erase(app);
+        if (members->second.empty())
+            group_members_.erase(members);
+    }
+    applications_.erase(it);
+}
+
+void ConfigLayers::setOverride(const std::string& app, const std::string& key, const sdbus::Variant& value)
+{
+    const auto it = applications_.find(app);
+    if (it == applications_.end())
+        throw std::runtime_error(ERROR_UNKNOWN_APP + app);
+    it->second.overrides[key] = value;
+    it->second.temporary.erase(key);
+}
+
+void ConfigLayers::setTemporary(const std::string& app, const std::string& key, const sdbus::Variant& value)
+{
+    const auto it = applications_.find(app);
+    if (it == applications_.end())
+        throw std::runtime_error(ERROR_UNKNOWN_APP + app);
+    it->second.temporary[key] = value;
+}
+
+std::optional<sdbus::Variant> ConfigLayers::clearTemporary(const std::string& app, const std::string& key)
+{
+    const auto it = applications_.find(app);
+    if (it == applications_.end())
+        throw std::runtime_error(ERROR_UNKNOWN_APP + app);
+    if (it->second.temporary.erase(key) == 0)
+        return std::nullopt;
+
+    const sdbus::Variant* value = resolve(it->second, key);
+    return value ? std::optional<sdbus::Variant>(*value) : std::nullopt;
+}
+
+std::optional<ConfigLayers::Config> ConfigLayers::flattenOverrides(const std::string& app)
+{
+    const auto it = applications_.find(app);
+    if (it == applications_.end())
+        throw std::runtime_error(ERROR_UNKNOWN_APP + app);
+
+    Application& application = it->second;
+    if (application.overrides.empty())
+        return std::nullopt;
+
+    Config file = *application.file;
+    mergeInto(file, application.overrides);
+    application.overrides.clear();
+    application.file = ContentStore::instance().internConfiguration(file);
+
+    if (!application.group.empty())
+        file[GROUP_KEY] = sdbus::Variant(application.group);
+    return file;
+}
+
+ConfigLayers::Config ConfigLayers::effective(const std::string& app) const
+{
+    const auto it = applications_.find(app);
+    if (it == applications_.end())
+        throw std::runtime_error(ERROR_UNKNOWN_APP + app);
+
+    Config result = defaults_;
+    if (const auto group = groups_.find(it->second.group); group != groups_.end())
+        mergeInto(result, group->second);
+    mergeInto(result, *it->second.file);
+    mergeInto(result, it->second.overrides);
+    mergeInto(result, it->second.temporary);
+    return result;
+}
\ No newline at end of file
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <sdbus-c++/sdbus-c++.h>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+static const std::string WATCHER_SERVICE = "com.system.configurationManager";
+static const std::string WATCHER_NAMESPACE = "/com/system/configurationManager/Application";
+static const std::string WATCHER_INTERFACE = "com.system.configurationManager.Application.Configuration";
+static const std::string WATCHER_KEY_SIGNAL = "configurationKeyChanged";
+static const std::string WATCHER_MANAGER_PATH = "/com/system/configurationManager";
+static const std::string WATCHER_MANAGER_INTERFACE = "com.system.configurationManager.Manager";
+static const std::string WATCHER_BULK_METHOD = "GetConfigurations";
+static const std::string WATCHER_CHANGES_METHOD = "GetChangesSince";
+
+/**
+ * @class ConfigNamespaceWatcher
+ * @brief Client-side cache of every application configuration, kept current by one match rule
+ *
+ * Instead of one proxy and one match rule per application, the watcher adds a
+ * single `path_namespace` match rule for the configurationKeyChanged signals
+ * of all objects under WATCHER_NAMESPACE and routes each signal to the cache
+ * of the application named by the last path element.
+ *
+ * start() subscribes first and then fetches every configuration with one
+ * Manager.GetConfigurations call. A GetChangesSince(0) call per application
+ * then brings each fetched configuration to a known version. Every key
+ * remembers the version it was last set at, and a signal is applied only if
+ * its version is newer. So signals held back during the fetch, or delivered
+ * late, never overwrite newer values. Applications registered later, or
+ * signalled by a restarted manager, are fetched again on their next signal.
+ *
+ * Signals are handled on the connection's event loop thread. Thread-safe.
+ */
+class ConfigNamespaceWatcher
+{
+   public:
+    using ConfigurationMap = std::map<std::string, sdbus::Variant>;
+    using ChangeListener = std::function<void(const std::string&, const std::string&, const sdbus::Variant&)>;
+
+    /**
+     * @brief Create a watcher with a dedicated session bus connection and event loop
+     * @param service Bus name of the configuration manager
+     */
+    explicit ConfigNamespaceWatcher(std::string = WATCHER_SERVICE);
+
+    /**
+     * @brief Create a watcher on an existing connection
+     *
+     * The caller runs the connection's event loop, otherwise no signal is ever
+     * delivered.
+     * @param connection Connection to subscribe on
+     * @param service Bus name of the configuration manager
+     */
+    explicit ConfigNamespaceWatcher(sdbus::IConnection&, std::string = WATCHER_SERVICE);
+
+    ConfigNamespaceWatcher(const ConfigNamespaceWatcher&) = delete;
+    ConfigNamespaceWatcher& operator=(const ConfigNamespaceWatcher&) = delete;
+
+    /**
+     * @brief Unsubscribe and stop the dedicated event loop, if any
+     */
+    ~ConfigNamespaceWatcher();
+
+    /**
+     * @brief Observe changes applied to the cache
+     *
+     * Runs on the event loop thread, or on the thread calling start() for
+     * changes held back during the initial fetch. Must be set before start().
+     * @param listener Receives the application name, key and new value
+     */
+    void setChangeListener(ChangeListener);
+
+    /**
+     * @brief Subscribe to the namespace and fetch the current configurations
+     * @throw sdbus::Error If the manager cannot be reached
+     */
+    void start();
+
+    /**
+     * @brief Get a cached value
+     * @param app_name Application name
+     * @param key Parameter name
+     * @return Value, or std::nullopt if the application or key is unknown
+     */
+    [[nodiscard]] std::optional<sdbus::Variant> get(const std::string&, const std::string&) const;
+
+    /**
+     * @brief Get the cached configuration of an application
+     * @param app_name Application name
+     * @return Configuration, empty for unknown applications
+     */
+    [[nodiscard]] ConfigurationMap configuration(const std::string&) const;
+
+    /**
+     * @brief List the applications in the cache
+     * @return Application names in ascending order
+     */
+    [[nodiscard]] std::vector<std::string> applications() const;
+
+    /**
+     * @brief Build the match rule selecting the key signals of every application
+     * @return Match rule string
+     */
+    [[nodiscard]] std::string matchRule() const;
+
+   private:
+    using Change = std::tuple<std::string, std::string, sdbus::Variant>;
+
+    /**
+     * @struct Versions
+     * @brief Versions the cached values of one application are known to be at
+     */
+    struct Versions
+    {
+        std::string owner;   ///< Unique bus name of the manager the values came from
+        uint64_t fetched = 0;  ///< Version of the fetched configuration, the floor of every key
+        std::map<std::string, uint64_t> keys;  ///< Version of each key changed by a signal since the fetch
+    };
+
+    /**
+     * @struct HeldBackChange
+     * @brief Signal received while the initial fetch was running
+     */
+    struct HeldBackChange
+    {
+        Change change;
+        uint64_t version;
+        std::string sender;
+    };
+
+    /**
+     * @brief Handle a configurationKeyChanged signal of any application
+     * @param message Signal message carrying the key, its new value and the version
+     */
+    void onKeyChanged(sdbus::Message&);
+
+    /**
+     * @brief Fetch configurations with Manager.GetConfigurations
+     * @param apps Applications to fetch, empty for all
+     * @param owner Receives the unique bus name of the manager that replied
+     * @return Configurations by application name
+     * @throw sdbus::Error If the call fails
+     */
+    std::map<std::string, ConfigurationMap> fetch(const std::vector<std::string>&, std::string&) const;
+
+    /**
+     * @brief Bring a fetched configuration to a known version with GetChangesSince(0)
+     *
+     * Changes made after the fetch are applied to it. If the call fails (an
+     * older manager), the version is 0 and every signal is applied.
+     * @param app_name Application name
+     * @param configuration Fetched configuration, updated in place
+     * @return Version the configuration is at
+     */
+    uint64_t catchUp(const std::string&, ConfigurationMap&) const;
+
+    /**
+     * @brief Check a signal against the version of the cached key and record it if newer
+     *
+     * Called with mutex_ held.
+     * @param app_name Application name
+     * @param key Parameter name
+     * @param version Version carried by the signal
+     * @return true if the signal is newer than the cached value
+     */
+    bool acceptLocked(const std::string&, const std::string&, uint64_t);
+
+    /**
+     * @brief Notify the listener of applied changes, called without the lock
+     * @param changes Applied changes
+     */
+    void notify(const std::vector<Change>&) const;
+
+    std::unique_ptr<sdbus::IConnection> owned_connection_;
+    sdbus::IConnection& connection_;
+    std::string service_;
+    std::unique_ptr<sdbus::IProxy> manager_;
+    ChangeListener change_listener_;
+
+    mutable std::mutex mutex_;
+    std::map<std::string, ConfigurationMap> configurations_;
+    std::map<std::string, Versions> versions_;
+    bool fetching_ = false;
+    std::vector<HeldBackChange> held_back_;
+    sdbus::Slot subscription_;
+};
\ No newline at end of file
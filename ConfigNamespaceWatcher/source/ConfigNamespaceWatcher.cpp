@@ -0,0 +1,247 @@
+#include "ConfigNamespaceWatcher/ConfigNamespaceWatcher.hpp"
+
+#include <ConfigValue/ConfigValue.hpp>
+#include <Logger/Logger.hpp>
+
+/**
+ * @brief Create a session bus connection running its own event loop
+ */
+static std::unique_ptr<sdbus::IConnection> createLoopingConnection()
+{
+    auto connection = sdbus::createSessionBusConnection();
+    connection->enterEventLoopAsync();
+    return connection;
+}
+
+ConfigNamespaceWatcher::ConfigNamespaceWatcher(std::string service)
+    : owned_connection_(createLoopingConnection()), connection_(*owned_connection_), service_(std::move(service)),
+      manager_(sdbus::createProxy(connection_, service_, WATCHER_MANAGER_PATH))
+{
+}
+
+ConfigNamespaceWatcher::ConfigNamespaceWatcher(sdbus::IConnection& connection, std::string service)
+    : connection_(connection), service_(std::move(service)),
+      manager_(sdbus::createProxy(connection_, service_, WATCHER_MANAGER_PATH))
+{
+}
+
+ConfigNamespaceWatcher::~ConfigNamespaceWatcher()
+{
+    if (owned_connection_)
+        owned_connection_->leaveEventLoop();
+    subscription_.reset();
+}
+
+void ConfigNamespaceWatcher::setChangeListener(ChangeListener listener) { change_listener_ = std::move(listener); }
+
+std::string ConfigNamespaceWatcher::matchRule() const
+{
+    return "type='signal',sender='" + service_ + "',interface='" + WATCHER_INTERFACE + "',member='" +
+           WATCHER_KEY_SIGNAL + "',path_namespace='" + WATCHER_NAMESPACE + "'";
+}
+
+void ConfigNamespaceWatcher::start()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        fetching_ = true;
+        held_back_.clear();
+    }
+    subscription_ = connection_.addMatch(matchRule(), [this](sdbus::Message& message) { onKeyChanged(message); });
+
+    std::map<std::string, ConfigurationMap> fetched;
+    std::string owner;
+    std::map<std::string, Versions> versions;
+    try
+    {
+        fetched = fetch({}, owner);
+        for (auto& [app_name, configuration] : fetched)
+            versions[app_name] = Versions{owner, catchUp(app_name, configuration), {}};
+    }
+    catch (...)
+    {
+        subscription_.reset();
+        std::lock_guard<std::mutex> lock(mutex_);
+        fetching_ = false;
+        throw;
+    }
+
+    std::vector<Change> replayed;
+    std::size_t watched = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        configurations_ = std::move(fetched);
+        versions_ = std::move(versions);
+        // Signals that raced with the fetch are applied only where they are newer than the fetched values
+        for (auto& [change, version, sender] : held_back_)
+        {
+            auto& [app_name, key, value] = change;
+            if (sender != owner || !configurations_.contains(app_name) || !acceptLocked(app_name, key, version))
+                continue;
+            configurations_[app_name][key] = value;
+            replayed.push_back(std::move(change));
+        }
+        held_back_.clear();
+        fetching_ = false;
+        watched = configurations_.size();
+    }
+    Logger::instance().info("Watching ", watched, " applications under ", WATCHER_NAMESPACE);
+    notify(replayed);
+}
+
+void ConfigNamespaceWatcher::onKeyChanged(sdbus::Message& message)
+{
+    const std::string path = message.getPath();
+    const std::string prefix = WATCHER_NAMESPACE + "/";
+    if (!path.starts_with(prefix))
+        return;
+    std::string app_name = path.substr(prefix.size());
+    const char* sender_name = message.getSender();
+    const std::string sender = sender_name ? sender_name : "";
+
+    std::string key;
+    sdbus::Variant value;
+    uint64_t version = 0;
+    try
+    {
+        message >> key >> value >> version;
+        // Large strings arrive as memfd descriptors; cache them as the strings a bulk fetch returns
+        value = ConfigValue::fromVariant(value).toVariant();
+    }
+    catch (const std::exception& e)
+    {
+        Logger::instance().warning("Malformed change signal from ", path, ": ", e.what());
+        return;
+    }
+
+    bool known = true;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (fetching_)
+        {
+            held_back_.push_back({Change{std::move(app_name), std::move(key), std::move(value)}, version, sender});
+            return;
+        }
+        const auto it = configurations_.find(app_name);
+        // Versions of a restarted manager start over, so its applications are fetched again
+        known = it != configurations_.end() && versions_[app_name].owner == sender;
+        if (known)
+        {
+            if (!acceptLocked(app_name, key, version))
+            {
+                Logger::instance().debug("Skipped stale change of ", app_name, ".", key, " (version ", version, ")");
+                return;
+            }
+            it->second[key] = value;
+        }
+    }
+
+    if (!known)
+    {
+        // An application registered after start(), or its manager restarted: the other keys are not cached
+        // yet, and the fetched configuration may already contain this change
+        try
+        {
+            std::string owner;
+            auto fetched = fetch({app_name}, owner);
+            auto& configuration = fetched[app_name];
+            const uint64_t fetched_version = catchUp(app_name, configuration);
+            std::lock_guard<std::mutex> lock(mutex_);
+            configurations_[app_name] = std::move(configuration);
+            versions_[app_name] = Versions{owner, fetched_version, {}};
+            if (owner != sender || !acceptLocked(app_name, key, version))
+                return;
+            configurations_[app_name][key] = value;
+        }
+        catch (const sdbus::Error& e)
+        {
+            Logger::instance().warning("Cannot fetch configuration of ", app_name, ": ", e.what());
+            return;
+        }
+    }
+    notify({Change{app_name, key, value}});
+}
+
+bool ConfigNamespaceWatcher::acceptLocked(const std::string& app_name, const std::string& key, uint64_t version)
+{
+    auto& versions = versions_[app_name];
+    auto [it, inserted] = versions.keys.try_emplace(key, versions.fetched);
+    if (version <= it->second)
+        return false;
+    it->second = version;
+    return true;
+}
+
+std::map<std::string, ConfigNamespaceWatcher::ConfigurationMap> ConfigNamespaceWatcher::fetch(
+    const std::vector<std::string>& apps, std::string& owner) const
+{
+    auto call = manager_->createMethodCall(WATCHER_MANAGER_INTERFACE, WATCHER_BULK_METHOD);
+    call << apps;
+    auto reply = manager_->callMethod(call);
+    std::map<std::string, ConfigurationMap> result;
+    reply >> result;
+    const char* sender = reply.getSender();
+    owner = sender ? sender : "";
+    return result;
+}
+
+uint64_t ConfigNamespaceWatcher::catchUp(const std::string& app_name, ConfigurationMap& configuration) const
+{
+    uint64_t version = 0;
+    bool complete = false;
+    ConfigurationMap changes;
+    try
+    {
+        sdbus::createProxy(connection_, service_, WATCHER_NAMESPACE + "/" + app_name)
+            ->callMethod(WATCHER_CHANGES_METHOD)
+            .onInterface(WATCHER_INTERFACE)
+            .withArguments(uint64_t{0})
+            .storeResultsTo(version, complete, changes);
+    }
+    catch (const sdbus::Error& e)
+    {
+        Logger::instance().warning("Cannot read the version of ", app_name, ", applying every signal: ", e.what());
+        return 0;
+    }
+
+    // An incomplete answer is the whole configuration at that version
+    if (!complete)
+        configuration.clear();
+    for (auto& [key, value] : changes) configuration[key] = std::move(value);
+    return version;
+}
+
+void ConfigNamespaceWatcher::notify(const std::vector<Change>& changes) const
+{
+    if (!change_listener_)
+        return;
+    for (const auto& [app_name, key, value] : changes) change_listener_(app_name, key, value);
+}
+
+std::optional<sdbus::Variant> ConfigNamespaceWatcher::get(const std::string& app_name, const std::string& key) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto app = configurations_.find(app_name);
+    if (app == configurations_.end())
+        return std::nullopt;
+    const auto it = app->second.find(key);
+    if (it == app->second.end())
+        return std::nullopt;
+    return it->second;
+}
+
+ConfigNamespaceWatcher::ConfigurationMap ConfigNamespaceWatcher::configuration(const std::string& app_name) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = configurations_.find(app_name);
+    return it == configurations_.end() ? ConfigurationMap{} : it->second;
+}
+
+std::vector<std::string> ConfigNamespaceWatcher::applications() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::string> names;
+    names.reserve(configurations_.size());
+    for (const auto& [app_name, configuration] : configurations_) names.push_back(app_name);
+    return names;
+}
\ No newline at end of file
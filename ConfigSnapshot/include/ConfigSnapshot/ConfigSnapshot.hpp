@@ -0,0 +1,158 @@
+#pragma once
+
+#include <sdbus-c++/sdbus-c++.h>
+
+#include <IConfigStorage/IConfigStorage.hpp>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+
+static const std::string ERROR_SNAPSHOT_CREATE = "Cannot create shared configuration snapshot: ";
+static const std::string ERROR_SNAPSHOT_MAP = "Cannot map shared configuration snapshot: ";
+
+/**
+ * @struct SnapshotHeader
+ * @brief Layout of the start of a shared snapshot segment
+ *
+ * The payload following the header is protected by a seqlock: `sequence`
+ * is odd while the writer updates the payload, readers retry until they
+ * observe the same even value before and after copying it.
+ */
+struct SnapshotHeader
+{
+    static constexpr uint32_t MAGIC = 0x53474643;  // "CFGS"
+    static constexpr uint32_t FORMAT = 1;
+
+    uint32_t magic;
+    uint32_t format;
+    uint64_t capacity;                  ///< Payload capacity in bytes
+    std::atomic<uint64_t> sequence;     ///< Seqlock counter, odd while writing
+    std::atomic<uint64_t> generation;   ///< Number of published configurations
+    std::atomic<uint64_t> payload_size; ///< Bytes of valid payload
+    std::atomic<uint32_t> stale;        ///< Non-zero once the writer moved to a bigger segment
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared seqlock needs lock-free 64-bit atomics");
+
+/**
+ * @class SnapshotWriter
+ * @brief Publishes configuration snapshots into a memfd-backed shared segment
+ *
+ * Clients receive a read-only descriptor (sent over D-Bus as a unix fd),
+ * map it and read the current configuration without any IPC. When a new
+ * configuration does not fit, the writer moves to a bigger segment and marks
+ * the old one stale so readers fetch the new descriptor.
+ */
+class SnapshotWriter
+{
+   public:
+    /**
+     * @brief Create a writer with an initial segment
+     * @param name Name of the memfd (shown in /proc, debugging only)
+     * @param config Initial configuration to publish
+     * @throw std::runtime_error If the segment cannot be created
+     */
+    SnapshotWriter(std::string, const std::map<std::string, sdbus::Variant>&);
+
+    /**
+     * @brief Create a writer with an initial segment holding a storage's configuration
+     * @param name Name of the memfd (shown in /proc, debugging only)
+     * @param storage Storage whose configuration is published
+     * @throw std::runtime_error If the segment cannot be created
+     */
+    SnapshotWriter(std::string, const IConfigStorage&);
+
+    SnapshotWriter(const SnapshotWriter&) = delete;
+    SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+    ~SnapshotWriter();
+
+    /**
+     * @brief Publish a new configuration
+     * @param config Configuration to publish
+     */
+    void publish(const std::map<std::string, sdbus::Variant>&);
+
+    /**
+     * @brief Publish the configuration of a storage, encoded from its stored values without copying them
+     * @param storage Storage to publish
+     */
+    void publish(const IConfigStorage&);
+
+    /**
+     * @brief Get a read-only descriptor of the current segment
+     * @return Descriptor suitable for passing to clients
+     */
+    [[nodiscard]] sdbus::UnixFd readOnlyFd() const;
+
+   private:
+    /**
+     * @brief Copy the encoded configuration in buffer_ into the segment
+     */
+    void commit();
+
+    /**
+     * @brief Replace the current segment by a new one
+     * @param capacity Payload capacity of the new segment
+     */
+    void createSegment(std::size_t);
+
+    /**
+     * @brief Unmap and close the current segment
+     */
+    void releaseSegment();
+
+    std::string name_;
+    mutable std::mutex mutex_;
+    int fd_ = -1;
+    int read_only_fd_ = -1;
+    std::size_t mapping_size_ = 0;
+    SnapshotHeader* header_ = nullptr;
+    std::string buffer_;
+};
+
+/**
+ * @class SnapshotReader
+ * @brief Reads configurations published by a SnapshotWriter
+ */
+class SnapshotReader
+{
+   public:
+    /**
+     * @brief Map a snapshot segment read-only
+     * @param fd Descriptor received from the server (it is duplicated)
+     * @throw std::runtime_error If the descriptor is not a valid snapshot
+     */
+    explicit SnapshotReader(int);
+
+    SnapshotReader(const SnapshotReader&) = delete;
+    SnapshotReader& operator=(const SnapshotReader&) = delete;
+
+    ~SnapshotReader();
+
+    /**
+     * @brief Get the number of configurations published so far
+     * @return Generation counter, cheap enough to poll
+     */
+    [[nodiscard]] uint64_t generation() const;
+
+    /**
+     * @brief Check whether the writer has moved to a new segment
+     * @return true if the descriptor has to be fetched again
+     */
+    [[nodiscard]] bool stale() const;
+
+    /**
+     * @brief Read a consistent copy of the current configuration
+     * @param generation Receives the generation the copy belongs to
+     * @return Configuration, or std::nullopt if the segment is stale
+     */
+    std::optional<std::map<std::string, sdbus::Variant>> read(uint64_t* = nullptr) const;
+
+   private:
+    std::size_t mapping_size_ = 0;
+    const SnapshotHeader* header_ = nullptr;
+};
\ No newline at end of file
@@ -0,0 +1,193 @@
+#include "ConfigSnapshot/ConfigSnapshot.hpp"
+
+#include <BinaryCodec/BinaryCodec.hpp>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <thread>
+
+static constexpr std::size_t PAYLOAD_OFFSET = 64;
+static constexpr std::size_t MIN_CAPACITY = 4096 - PAYLOAD_OFFSET;
+
+static_assert(sizeof(SnapshotHeader) <= PAYLOAD_OFFSET);
+
+SnapshotWriter::SnapshotWriter(std::string name, const std::map<std::string, sdbus::Variant>& config)
+    : name_(std::move(name))
+{
+    publish(config);
+}
+
+SnapshotWriter::SnapshotWriter(std::string name, const IConfigStorage& storage) : name_(std::move(name))
+{
+    publish(storage);
+}
+
+SnapshotWriter::~SnapshotWriter() { releaseSegment(); }
+
+void SnapshotWriter::createSegment(std::size_t capacity)
+{
+    const int fd = ::memfd_create(name_.c_str(), MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd < 0)
+        throw std::runtime_error(ERROR_SNAPSHOT_CREATE + std::strerror(errno));
+
+    const std::size_t mapping_size = PAYLOAD_OFFSET + capacity;
+    void* memory = MAP_FAILED;
+    if (::ftruncate(fd, static_cast<off_t>(mapping_size)) == 0)
+        memory = ::mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (memory == MAP_FAILED)
+    {
+        const std::string reason = std::strerror(errno);
+        ::close(fd);
+        throw std::runtime_error(ERROR_SNAPSHOT_CREATE + reason);
+    }
+    ::fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL);
+
+    // Reopening through /proc yields a descriptor that cannot be mapped writable
+    const int read_only_fd = ::open(("/proc/self/fd/" + std::to_string(fd)).c_str(), O_RDONLY | O_CLOEXEC);
+    if (read_only_fd < 0)
+    {
+        const std::string reason = std::strerror(errno);
+        ::munmap(memory, mapping_size);
+        ::close(fd);
+        throw std::runtime_error(ERROR_SNAPSHOT_CREATE + reason);
+    }
+
+    auto* header =
+        new (memory) SnapshotHeader{SnapshotHeader::MAGIC, SnapshotHeader::FORMAT, capacity, {}, {}, {}, {}};
+    if (header_)
+        header->generation.store(header_->generation.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+    releaseSegment();
+    fd_ = fd;
+    read_only_fd_ = read_only_fd;
+    mapping_size_ = mapping_size;
+    header_ = header;
+}
+
+void SnapshotWriter::releaseSegment()
+{
+    if (!header_)
+        return;
+
+    header_->stale.store(1, std::memory_order_release);
+    ::munmap(header_, mapping_size_);
+    ::close(fd_);
+    ::close(read_only_fd_);
+    header_ = nullptr;
+}
+
+void SnapshotWriter::publish(const std::map<std::string, sdbus::Variant>& config)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    buffer_.clear();
+    BinaryWriter(buffer_).writeConfiguration(config);
+    commit();
+}
+
+void SnapshotWriter::publish(const IConfigStorage& storage)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Same layout as writeConfiguration(), the count is filled in once the values are written
+    buffer_.assign(sizeof(uint32_t), '\0');
+    BinaryWriter writer(buffer_);
+    uint32_t count = 0;
+    storage.forEachParameter(
+        [&writer, &count](const std::string& key, const ConfigValue& value)
+        {
+            writer.writeString(key);
+            writer.writeValue(value);
+            ++count;
+        });
+    std::memcpy(buffer_.data(), &count, sizeof(count));
+    commit();
+}
+
+void SnapshotWriter::commit()
+{
+    if (!header_ || buffer_.size() > header_->capacity)
+        createSegment(std::max(MIN_CAPACITY, 2 * buffer_.size()));
+
+    char* payload = reinterpret_cast<char*>(header_) + PAYLOAD_OFFSET;
+    const uint64_t sequence = header_->sequence.load(std::memory_order_relaxed);
+
+    header_->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    std::memcpy(payload, buffer_.data(), buffer_.size());
+    header_->payload_size.store(buffer_.size(), std::memory_order_relaxed);
+    header_->generation.fetch_add(1, std::memory_order_relaxed);
+
+    header_->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+sdbus::UnixFd SnapshotWriter::readOnlyFd() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sdbus::UnixFd(read_only_fd_);
+}
+
+SnapshotReader::SnapshotReader(int fd)
+{
+    struct stat info{};
+    if (::fstat(fd, &info) < 0 || static_cast<std::size_t>(info.st_size) < PAYLOAD_OFFSET)
+        throw std::runtime_error(ERROR_SNAPSHOT_MAP + "invalid descriptor");
+
+    mapping_size_ = static_cast<std::size_t>(info.st_size);
+    void* memory = ::mmap(nullptr, mapping_size_, PROT_READ, MAP_SHARED, fd, 0);
+    if (memory == MAP_FAILED)
+        throw std::runtime_error(ERROR_SNAPSHOT_MAP + std::strerror(errno));
+
+    header_ = static_cast<const SnapshotHeader*>(memory);
+    if (header_->magic != SnapshotHeader::MAGIC || header_->format != SnapshotHeader::FORMAT ||
+        PAYLOAD_OFFSET + header_->capacity > mapping_size_)
+    {
+        ::munmap(memory, mapping_size_);
+        throw std::runtime_error(ERROR_SNAPSHOT_MAP + "unknown layout");
+    }
+}
+
+SnapshotReader::~SnapshotReader() { ::munmap(const_cast<SnapshotHeader*>(header_), mapping_size_); }
+
+uint64_t SnapshotReader::generation() const { return header_->generation.load(std::memory_order_acquire); }
+
+bool SnapshotReader::stale() const { return header_->stale.load(std::memory_order_acquire) != 0; }
+
+std::optional<std::map<std::string, sdbus::Variant>> SnapshotReader::read(uint64_t* generation) const
+{
+    const char* payload = reinterpret_cast<const char*>(header_) + PAYLOAD_OFFSET;
+    std::string copy;
+
+    while (!stale())
+    {
+        const uint64_t before = header_->sequence.load(std::memory_order_acquire);
+        if (before & 1)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        const auto size = header_->payload_size.load(std::memory_order_relaxed);
+        const auto current_generation = header_->generation.load(std::memory_order_relaxed);
+        if (size > header_->capacity)
+            continue;
+        copy.assign(payload, size);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (header_->sequence.load(std::memory_order_relaxed) != before)
+            continue;
+
+        if (generation)
+            *generation = current_generation;
+        return BinaryReader(copy.data(), copy.size()).readConfiguration();
+    }
+    return std::nullopt;
+}
\ No newline at end of file
@@ -0,0 +1,282 @@
+#pragma once
+
+#include <sdbus-c++/sdbus-c++.h>
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+static const std::string ERROR_VALUE_TYPE = "Configuration value has another type, stored: ";
+static const std::string ERROR_UNSUPPORTED_TYPE = "Unsupported configuration value type: ";
+static const std::string ERROR_SEALED_VALUE = "Cannot share configuration value through a memfd: ";
+
+/**
+ * @class ConfigValue
+ * @brief Compact configuration value: a 16-byte tagged union
+ *
+ * Holds one of the D-Bus basic types used in configurations (`b y n q i u x t
+ * d s`). Scalars and strings of up to INLINE_CAPACITY bytes live inside the
+ * object; longer strings live in one immutable, reference-counted heap buffer
+ * that copies share. Unlike sdbus::Variant, which wraps a serialized message
+ * per value, copying a value is a 16-byte copy plus at most one atomic
+ * increment.
+ *
+ * Values are converted to sdbus::Variant only at the D-Bus boundary, or
+ * appended to an outgoing message directly with appendTo().
+ *
+ * Large strings can instead live in a sealed memfd mapped read-only
+ * (sealed()). appendTo() sends such a string as a `h` file descriptor, and
+ * the receiver maps the same pages instead of copying the bytes through the
+ * bus. fromVariant() maps a received descriptor back into a string value.
+ */
+class ConfigValue
+{
+   public:
+    /**
+     * @enum Type
+     * @brief Stored type, named after its D-Bus signature
+     */
+    enum class Type : uint8_t
+    {
+        Bool,    ///< `b`
+        Byte,    ///< `y`
+        Int16,   ///< `n`
+        UInt16,  ///< `q`
+        Int32,   ///< `i`
+        UInt32,  ///< `u`
+        Int64,   ///< `x`
+        UInt64,  ///< `t`
+        Double,  ///< `d`
+        String   ///< `s`
+    };
+
+    static constexpr std::size_t INLINE_CAPACITY = 13;
+
+    ConfigValue() : ConfigValue(int32_t{0}) {}
+    ConfigValue(bool value) { setScalar(Type::Bool, value); }
+    ConfigValue(uint8_t value) { setScalar(Type::Byte, value); }
+    ConfigValue(int16_t value) { setScalar(Type::Int16, value); }
+    ConfigValue(uint16_t value) { setScalar(Type::UInt16, value); }
+    ConfigValue(int32_t value) { setScalar(Type::Int32, value); }
+    ConfigValue(uint32_t value) { setScalar(Type::UInt32, value); }
+    ConfigValue(int64_t value) { setScalar(Type::Int64, value); }
+    ConfigValue(uint64_t value) { setScalar(Type::UInt64, value); }
+    ConfigValue(double value) { setScalar(Type::Double, value); }
+    ConfigValue(std::string_view value) { setString(value); }
+    ConfigValue(const char* value) : ConfigValue(std::string_view(value)) {}
+    ConfigValue(const std::string& value) : ConfigValue(std::string_view(value)) {}
+
+    ConfigValue(const ConfigValue&);
+    ConfigValue(ConfigValue&&) noexcept;
+    ConfigValue& operator=(const ConfigValue&);
+    ConfigValue& operator=(ConfigValue&&) noexcept;
+    ~ConfigValue() { release(); }
+
+    /**
+     * @brief Store a string in a new sealed memfd
+     * @param value String contents
+     * @return String value backed by the memfd, or an inline value for short strings
+     * @throw std::runtime_error If the memfd cannot be created
+     */
+    static ConfigValue sealed(std::string_view);
+
+    /**
+     * @brief Map a sealed memfd received from another process
+     * @param fd Descriptor of a memfd created by sealed(); it is duplicated, not taken over
+     * @return String value backed by the memfd
+     * @throw std::runtime_error If the descriptor is not a sealed, NUL-terminated memfd
+     */
+    static ConfigValue fromDescriptor(int);
+
+    /**
+     * @brief Convert a D-Bus variant
+     * @param variant Variant holding a basic type, or a `h` descriptor of a sealed string
+     * @return Equivalent value
+     * @throw std::runtime_error For container or other unsupported types
+     */
+    static ConfigValue fromVariant(const sdbus::Variant&);
+
+    /**
+     * @brief Convert to a D-Bus variant
+     * @return Variant holding the same value; sealed strings are copied
+     */
+    [[nodiscard]] sdbus::Variant toVariant() const;
+
+    /**
+     * @brief Read a value of a known type from a message
+     * @param message Message positioned at the value
+     * @param signature One-character signature of the value
+     * @return Read value
+     * @throw std::runtime_error For signatures of unsupported types
+     */
+    static ConfigValue readFrom(sdbus::Message&, char);
+
+    /**
+     * @brief Append the value to a message as a variant, without building an sdbus::Variant
+     *
+     * Sealed strings are appended as a `h` variant holding their memfd.
+     * @param message Message being filled
+     */
+    void appendTo(sdbus::Message&) const;
+
+    /**
+     * @brief Append the bare value to a message, e.g. into an already opened variant
+     * @param message Message being filled
+     */
+    void appendPayloadTo(sdbus::Message&) const;
+
+    /**
+     * @brief Get the stored type
+     * @return Type tag
+     */
+    [[nodiscard]] Type type() const { return type_; }
+
+    /**
+     * @brief Get the D-Bus signature of the stored type
+     * @return One-character signature
+     */
+    [[nodiscard]] char signature() const;
+
+    /**
+     * @brief Get the stored string without copying it
+     * @return View valid until the value is modified or destroyed
+     * @throw std::runtime_error If the value is not a string
+     */
+    [[nodiscard]] std::string_view asString() const;
+
+    /**
+     * @brief Get the stored value
+     * @tparam T One of the supported types or std::string
+     * @return Stored value
+     * @throw std::runtime_error If T is not the stored type
+     */
+    template <typename T>
+    T get() const
+    {
+        if constexpr (std::is_same_v<T, std::string>)
+            return std::string(asString());
+        else
+        {
+            if (type_ != typeOf<T>())
+                throw std::runtime_error(ERROR_VALUE_TYPE + std::string(1, signature()));
+            T value;
+            std::memcpy(&value, bytes_, sizeof(T));
+            return value;
+        }
+    }
+
+    /**
+     * @brief Get the memfd of a sealed string
+     * @return Descriptor owned by the value, -1 if the value is not sealed
+     */
+    [[nodiscard]] int descriptor() const;
+
+    /**
+     * @brief Count the values sharing the heap buffer of a long string
+     * @return Number of sharing values, 0 for values stored inline
+     */
+    [[nodiscard]] uint32_t useCount() const;
+
+    /**
+     * @brief Hash the type and value, consistent with operator==
+     * @return 64-bit hash
+     */
+    [[nodiscard]] uint64_t hash() const;
+
+    /**
+     * @brief Compare type and value
+     */
+    bool operator==(const ConfigValue&) const;
+
+   private:
+    /**
+     * @brief Map a C++ scalar type to its tag
+     */
+    template <typename T>
+    static constexpr Type typeOf()
+    {
+        if constexpr (std::is_same_v<T, bool>)
+            return Type::Bool;
+        else if constexpr (std::is_same_v<T, uint8_t>)
+            return Type::Byte;
+        else if constexpr (std::is_same_v<T, int16_t>)
+            return Type::Int16;
+        else if constexpr (std::is_same_v<T, uint16_t>)
+            return Type::UInt16;
+        else if constexpr (std::is_same_v<T, int32_t>)
+            return Type::Int32;
+        else if constexpr (std::is_same_v<T, uint32_t>)
+            return Type::UInt32;
+        else if constexpr (std::is_same_v<T, int64_t>)
+            return Type::Int64;
+        else if constexpr (std::is_same_v<T, uint64_t>)
+            return Type::UInt64;
+        else
+        {
+            static_assert(std::is_same_v<T, double>, "Unsupported configuration value type");
+            return Type::Double;
+        }
+    }
+
+    template <typename T>
+    void setScalar(Type type, T value)
+    {
+        type_ = type;
+        std::memcpy(bytes_, &value, sizeof(T));
+    }
+
+    /**
+     * @brief Shared buffer of a long string, defined in the source file
+     */
+    struct Heap;
+
+    /**
+     * @brief Store a string inline or in a new shared heap buffer
+     */
+    void setString(std::string_view);
+
+    /**
+     * @brief Reference a new heap buffer holding a string of the given size
+     */
+    void setHeap(Heap*, uint32_t);
+
+    /**
+     * @brief Get the heap buffer, the caller checks onHeap()
+     */
+    [[nodiscard]] Heap* heap() const;
+
+    /**
+     * @brief Map a sealed memfd holding a NUL-terminated string into a new heap buffer
+     * @param fd Descriptor taken over by the buffer, closed on failure
+     * @param mapping_size String size plus the terminator
+     */
+    static Heap* mapSealed(int, std::size_t);
+
+    /**
+     * @brief Get the stored string as a NUL-terminated buffer, the type is checked by the caller
+     */
+    [[nodiscard]] const char* stringData() const;
+
+    /**
+     * @brief Whether the value references a shared heap buffer
+     */
+    [[nodiscard]] bool onHeap() const { return type_ == Type::String && inline_size_ == HEAP; }
+
+    /**
+     * @brief Drop the reference to the heap buffer, if any, freeing it with the last one
+     */
+    void release() noexcept;
+
+    static constexpr uint8_t HEAP = 0xFF;
+
+    // Scalars, an inline NUL-terminated string, or a Heap pointer followed by a 32-bit size.
+    // Strings keep their terminator so they can be appended to messages without a copy
+    alignas(8) char bytes_[INLINE_CAPACITY + 1];
+    uint8_t inline_size_ = 0;
+    Type type_ = Type::Int32;
+};
+
+static_assert(sizeof(ConfigValue) == 16, "ConfigValue must stay two words");
\ No newline at end of file
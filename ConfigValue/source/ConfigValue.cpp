@@ -0,0 +1,433 @@
+#include "ConfigValue/ConfigValue.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <new>
+#include <utility>
+
+struct ConfigValue::Heap
+{
+    std::atomic<uint32_t> references{1};
+    int descriptor = -1;  // Sealed memfd holding the characters, -1 if they follow this header
+    const char* data = nullptr;
+};
+
+void ConfigValue::setString(std::string_view value)
+{
+    type_ = Type::String;
+    if (value.size() <= INLINE_CAPACITY)
+    {
+        inline_size_ = static_cast<uint8_t>(value.size());
+        std::memcpy(bytes_, value.data(), value.size());
+        bytes_[value.size()] = '\0';
+        return;
+    }
+
+    if (value.size() > UINT32_MAX)
+        throw std::runtime_error(ERROR_UNSUPPORTED_TYPE + "string longer than 4 GiB");
+    char* block = new char[sizeof(Heap) + value.size() + 1];
+    auto* heap = new (block) Heap;
+    char* data = block + sizeof(Heap);
+    std::memcpy(data, value.data(), value.size());
+    data[value.size()] = '\0';
+    heap->data = data;
+    setHeap(heap, static_cast<uint32_t>(value.size()));
+}
+
+void ConfigValue::setHeap(Heap* heap, uint32_t size)
+{
+    type_ = Type::String;
+    std::memcpy(bytes_, &heap, sizeof(heap));
+    std::memcpy(bytes_ + sizeof(heap), &size, sizeof(size));
+    inline_size_ = HEAP;
+}
+
+ConfigValue::Heap* ConfigValue::heap() const
+{
+    Heap* heap = nullptr;
+    std::memcpy(&heap, bytes_, sizeof(heap));
+    return heap;
+}
+
+/**
+ * @brief Write a whole buffer to a descriptor
+ * @return false on error, with errno set
+ */
+static bool writeAll(int fd, const char* data, std::size_t size)
+{
+    while (size > 0)
+    {
+        const ssize_t written = ::write(fd, data, size);
+        if (written < 0 && errno == EINTR)
+            continue;
+        if (written <= 0)
+            return false;
+        data += written;
+        size -= static_cast<std::size_t>(written);
+    }
+    return true;
+}
+
+ConfigValue::Heap* ConfigValue::mapSealed(int fd, std::size_t mapping_size)
+{
+    void* memory = ::mmap(nullptr, mapping_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (memory == MAP_FAILED)
+    {
+        const std::string reason = std::strerror(errno);
+        ::close(fd);
+        throw std::runtime_error(ERROR_SEALED_VALUE + reason);
+    }
+
+    const auto* data = static_cast<const char*>(memory);
+    if (data[mapping_size - 1] != '\0')
+    {
+        ::munmap(memory, mapping_size);
+        ::close(fd);
+        throw std::runtime_error(ERROR_SEALED_VALUE + "string is not terminated");
+    }
+
+    auto* heap = new Heap;
+    heap->descriptor = fd;
+    heap->data = data;
+    return heap;
+}
+
+ConfigValue ConfigValue::sealed(std::string_view value)
+{
+    if (value.size() <= INLINE_CAPACITY)
+        return value;
+    if (value.size() > UINT32_MAX)
+        throw std::runtime_error(ERROR_UNSUPPORTED_TYPE + "string longer than 4 GiB");
+
+    const int fd = ::memfd_create("config-value", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd < 0)
+        throw std::runtime_error(ERROR_SEALED_VALUE + std::strerror(errno));
+
+    // Written with write() rather than through a writable mapping, which would prevent F_SEAL_WRITE
+    if (!writeAll(fd, value.data(), value.size()) || !writeAll(fd, "", 1) ||
+        ::fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) < 0)
+    {
+        const std::string reason = std::strerror(errno);
+        ::close(fd);
+        throw std::runtime_error(ERROR_SEALED_VALUE + reason);
+    }
+
+    ConfigValue result;
+    result.setHeap(mapSealed(fd, value.size() + 1), static_cast<uint32_t>(value.size()));
+    return result;
+}
+
+ConfigValue ConfigValue::fromDescriptor(int fd)
+{
+    // Without these seals the sender could change or truncate the pages under the reader
+    static constexpr int REQUIRED_SEALS = F_SEAL_SHRINK | F_SEAL_WRITE;
+    const int seals = ::fcntl(fd, F_GET_SEALS);
+    if (seals < 0 || (seals & REQUIRED_SEALS) != REQUIRED_SEALS)
+        throw std::runtime_error(ERROR_SEALED_VALUE + "descriptor is not a sealed memfd");
+
+    struct stat info{};
+    if (::fstat(fd, &info) < 0 || info.st_size < 1 || static_cast<uint64_t>(info.st_size) - 1 > UINT32_MAX)
+        throw std::runtime_error(ERROR_SEALED_VALUE + "invalid descriptor size");
+
+    const int own_fd = ::fcntl(fd, F_DUPFD_CLOEXEC, 0);
+    if (own_fd < 0)
+        throw std::runtime_error(ERROR_SEALED_VALUE + std::strerror(errno));
+
+    const auto size = static_cast<std::size_t>(info.st_size);
+    ConfigValue mapped;
+    mapped.setHeap(mapSealed(own_fd, size), static_cast<uint32_t>(size - 1));
+    // Short strings are kept inline like any other
+    if (size - 1 <= INLINE_CAPACITY)
+        return ConfigValue(mapped.asString());
+    return mapped;
+}
+
+void ConfigValue::release() noexcept
+{
+    if (!onHeap())
+        return;
+    Heap* buffer = heap();
+    if (buffer->references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        if (buffer->descriptor >= 0)
+        {
+            uint32_t size = 0;
+            std::memcpy(&size, bytes_ + sizeof(Heap*), sizeof(size));
+            ::munmap(const_cast<char*>(buffer->data), size + 1);
+            ::close(buffer->descriptor);
+            delete buffer;
+        }
+        else
+        {
+            buffer->~Heap();
+            delete[] reinterpret_cast<char*>(buffer);
+        }
+    }
+    inline_size_ = 0;
+}
+
+ConfigValue::ConfigValue(const ConfigValue& other)
+    : inline_size_(other.inline_size_), type_(other.type_)
+{
+    std::memcpy(bytes_, other.bytes_, sizeof(bytes_));
+    if (onHeap())
+        heap()->references.fetch_add(1, std::memory_order_relaxed);
+}
+
+ConfigValue::ConfigValue(ConfigValue&& other) noexcept
+    : inline_size_(other.inline_size_), type_(other.type_)
+{
+    std::memcpy(bytes_, other.bytes_, sizeof(bytes_));
+    // The reference to the heap buffer, if any, now belongs to this value
+    other.inline_size_ = 0;
+    other.type_ = Type::Int32;
+}
+
+ConfigValue& ConfigValue::operator=(const ConfigValue& other)
+{
+    if (this != &other)
+    {
+        ConfigValue copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+ConfigValue& ConfigValue::operator=(ConfigValue&& other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+        std::memcpy(bytes_, other.bytes_, sizeof(bytes_));
+        inline_size_ = other.inline_size_;
+        type_ = other.type_;
+        other.inline_size_ = 0;
+        other.type_ = Type::Int32;
+    }
+    return *this;
+}
+
+std::string_view ConfigValue::asString() const
+{
+    if (type_ != Type::String)
+        throw std::runtime_error(ERROR_VALUE_TYPE + std::string(1, signature()));
+    if (!onHeap())
+        return {bytes_, inline_size_};
+
+    uint32_t size = 0;
+    std::memcpy(&size, bytes_ + sizeof(Heap*), sizeof(size));
+    return {stringData(), size};
+}
+
+const char* ConfigValue::stringData() const { return onHeap() ? heap()->data : bytes_; }
+
+int ConfigValue::descriptor() const { return onHeap() ? heap()->descriptor : -1; }
+
+uint32_t ConfigValue::useCount() const
+{
+    return onHeap() ? heap()->references.load(std::memory_order_relaxed) : 0;
+}
+
+char ConfigValue::signature() const
+{
+    static constexpr char SIGNATURES[] = "bynqiuxtds";
+    return SIGNATURES[static_cast<std::size_t>(type_)];
+}
+
+/**
+ * @brief Get the payload size of a scalar type
+ */
+static std::size_t scalarSize(ConfigValue::Type type)
+{
+    static constexpr std::size_t SIZES[] = {sizeof(bool),     sizeof(uint8_t), sizeof(int16_t),
+                                            sizeof(uint16_t), sizeof(int32_t), sizeof(uint32_t),
+                                            sizeof(int64_t),  sizeof(uint64_t), sizeof(double)};
+    return SIZES[static_cast<std::size_t>(type)];
+}
+
+bool ConfigValue::operator==(const ConfigValue& other) const
+{
+    if (type_ != other.type_)
+        return false;
+    if (type_ == Type::String)
+        return asString() == other.asString();
+
+    return std::memcmp(bytes_, other.bytes_, scalarSize(type_)) == 0;
+}
+
+uint64_t ConfigValue::hash() const
+{
+    // FNV-1a over the signature and the payload
+    uint64_t hash = 14695981039346656037ULL;
+    const auto mix = [&hash](std::string_view bytes)
+    {
+        for (const char byte : bytes)
+        {
+            hash ^= static_cast<uint8_t>(byte);
+            hash *= 1099511628211ULL;
+        }
+    };
+
+    const char type = signature();
+    mix({&type, 1});
+    mix(type_ == Type::String ? asString() : std::string_view(bytes_, scalarSize(type_)));
+    return hash;
+}
+
+ConfigValue ConfigValue::fromVariant(const sdbus::Variant& variant)
+{
+    const std::string signature = variant.peekValueType();
+    switch (signature.size() == 1 ? signature.front() : '\0')
+    {
+        case 'b':
+            return variant.get<bool>();
+        case 'y':
+            return variant.get<uint8_t>();
+        case 'n':
+            return variant.get<int16_t>();
+        case 'q':
+            return variant.get<uint16_t>();
+        case 'i':
+            return variant.get<int32_t>();
+        case 'u':
+            return variant.get<uint32_t>();
+        case 'x':
+            return variant.get<int64_t>();
+        case 't':
+            return variant.get<uint64_t>();
+        case 'd':
+            return variant.get<double>();
+        case 's':
+            return variant.get<std::string>();
+        case 'h':
+            return fromDescriptor(variant.get<sdbus::UnixFd>().get());
+        default:
+            throw std::runtime_error(ERROR_UNSUPPORTED_TYPE + signature);
+    }
+}
+
+sdbus::Variant ConfigValue::toVariant() const
+{
+    switch (type_)
+    {
+        case Type::Bool:
+            return sdbus::Variant(get<bool>());
+        case Type::Byte:
+            return sdbus::Variant(get<uint8_t>());
+        case Type::Int16:
+            return sdbus::Variant(get<int16_t>());
+        case Type::UInt16:
+            return sdbus::Variant(get<uint16_t>());
+        case Type::Int32:
+            return sdbus::Variant(get<int32_t>());
+        case Type::UInt32:
+            return sdbus::Variant(get<uint32_t>());
+        case Type::Int64:
+            return sdbus::Variant(get<int64_t>());
+        case Type::UInt64:
+            return sdbus::Variant(get<uint64_t>());
+        case Type::Double:
+            return sdbus::Variant(get<double>());
+        case Type::String:
+            return sdbus::Variant(get<std::string>());
+    }
+    return {};
+}
+
+/**
+ * @brief Read a value of type T from a message
+ */
+template <typename T>
+static ConfigValue readAs(sdbus::Message& message)
+{
+    T value{};
+    message >> value;
+    return value;
+}
+
+ConfigValue ConfigValue::readFrom(sdbus::Message& message, char signature)
+{
+    switch (signature)
+    {
+        case 'b':
+            return readAs<bool>(message);
+        case 'y':
+            return readAs<uint8_t>(message);
+        case 'n':
+            return readAs<int16_t>(message);
+        case 'q':
+            return readAs<uint16_t>(message);
+        case 'i':
+            return readAs<int32_t>(message);
+        case 'u':
+            return readAs<uint32_t>(message);
+        case 'x':
+            return readAs<int64_t>(message);
+        case 't':
+            return readAs<uint64_t>(message);
+        case 'd':
+            return readAs<double>(message);
+        case 's':
+            return readAs<std::string>(message);
+        default:
+            throw std::runtime_error(ERROR_UNSUPPORTED_TYPE + std::string(1, signature));
+    }
+}
+
+void ConfigValue::appendTo(sdbus::Message& message) const
+{
+    if (const int fd = descriptor(); fd >= 0)
+    {
+        message.openVariant("h");
+        message << sdbus::UnixFd(fd);
+        message.closeVariant();
+        return;
+    }
+
+    const char contents[] = {signature(), '\0'};
+    message.openVariant(contents);
+    appendPayloadTo(message);
+    message.closeVariant();
+}
+
+void ConfigValue::appendPayloadTo(sdbus::Message& message) const
+{
+    switch (type_)
+    {
+        case Type::Bool:
+            message << get<bool>();
+            break;
+        case Type::Byte:
+            message << get<uint8_t>();
+            break;
+        case Type::Int16:
+            message << get<int16_t>();
+            break;
+        case Type::UInt16:
+            message << get<uint16_t>();
+            break;
+        case Type::Int32:
+            message << get<int32_t>();
+            break;
+        case Type::UInt32:
+            message << get<uint32_t>();
+            break;
+        case Type::Int64:
+            message << get<int64_t>();
+            break;
+        case Type::UInt64:
+            message << get<uint64_t>();
+            break;
+        case Type::Double:
+            message << get<double>();
+            break;
+        case Type::String:
+            message << stringData();
+            break;
+    }
+}
\ No newline at end of file
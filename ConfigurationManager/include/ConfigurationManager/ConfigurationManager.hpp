@@ -1,25 +1,95 @@
 #pragma once
 
 #include <AppConfig/AppConfig.hpp>
+#include <ChangeJournal/ChangeJournal.hpp>
+#include <ConfigFileCache/ConfigFileCache.hpp>
+#include <ConfigLayers/ConfigLayers.hpp>
+#include <ContentStore/ContentStore.hpp>
 #include <DBusConfigAdapter/DBusConfigAdapter.hpp>
+#include <DispatchScheduler/DispatchScheduler.hpp>
 #include <IConfigFileManager/IConfigFileManager.hpp>
+#include <PeerServer/PeerServer.hpp>
+#include <TimerService/TimerService.hpp>
+#include <TimerWheel/TimerWheel.hpp>
+#include <chrono>
 #include <filesystem>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stop_token>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 static const std::string PART_OF_CONFIG_PATH = "/.config/com.system.configurationManager/";
-static const std::string STARTED = "Configuration manager started successfully\n";
+static const std::string STARTED = "Configuration manager started successfully";
 static const std::string REQUEST_NAME = "com.system.configurationManager";
+static const std::string MANAGER_PATH = "/com/system/configurationManager";
+static const std::string STATS_INTERFACE = "com.system.configurationManager.Stats";
+static const std::string MANAGER_INTERFACE = "com.system.configurationManager.Manager";
+static const std::string LAYERS_INTERFACE = "com.system.configurationManager.Layers";
+static const std::string LAYERS_DIR = "layers";
+static const std::string GROUPS_DIR = "groups";
+static const std::string JOURNAL_FILE = "journal.bin";
+static const std::string CONFIG_CACHE_FILE = "configs.cache";
+static const std::string REMOVED_SUFFIX = ".removed";
+static const std::string ERROR_INVALID_LAYER = "com.system.configurationManager.Error.InvalidLayer";
+static const std::string ERROR_UNKNOWN_APPLICATION = "com.system.configurationManager.Error.UnknownApplication";
+static const std::string ERROR_APPLICATION_EXISTS = "com.system.configurationManager.Error.ApplicationExists";
+static const std::string ERROR_INVALID_ARGS = "com.system.configurationManager.Error.InvalidArgs";
+static const std::string ERROR_ACCESS_DENIED = "org.freedesktop.DBus.Error.AccessDenied";
+static const std::string RATE_LIMIT_KEY_PREFIX = "RateLimit.";
+static const std::string READ_RATE_KEY = "RateLimit.ReadRate";
+static const std::string READ_BURST_KEY = "RateLimit.ReadBurst";
+static const std::string WRITE_RATE_KEY = "RateLimit.WriteRate";
+static const std::string WRITE_BURST_KEY = "RateLimit.WriteBurst";
+
+/**
+ * @struct ManagerOptions
+ * @brief Optional service features selected at startup
+ */
+struct ManagerOptions
+{
+    std::string metrics_file;  ///< Prometheus text dump path, empty disables the dump
+    std::chrono::milliseconds metrics_interval{10000};  ///< Period between two dumps
+    std::string peer_socket;  ///< Unix socket accepting direct peer connections, empty disables it
+    bool shared_snapshots = false;  ///< Publish each configuration into a shared-memory snapshot
+    bool journal = false;  ///< Journal changes so runtime changes and versions survive a restart
+    std::chrono::milliseconds journal_compact_interval{60000};  ///< Period between two journal compactions
+    bool config_cache = false;  ///< Reuse parsed configuration files across restarts (`configs.cache`)
+    bool dispatch_queues = true;  ///< Queue application calls by class so that writes cannot starve reads
+    DispatchOptions dispatch;     ///< Weights and capacity of the dispatch queues
+    RateLimit read_rate_limit;    ///< Default per-sender GetConfiguration limit of every application
+    RateLimit write_rate_limit;   ///< Default per-sender ChangeConfiguration limit of every application
+    PropertiesPolicy properties;  ///< Default D-Bus properties exposure of every application
+    std::size_t fd_values_above = 0;  ///< Longer strings are kept in sealed memfds and sent as `h`, 0 never
+};
 
 /**
  * @class ConfigurationManager
  * @brief Main service class that manages application configurations over D-Bus
  *
  * This class is responsible for:
- * - Loading configuration files from a directory
- * - Creating D-Bus adapters for each configuration
+ * - Loading configuration files from a directory and resolving them against
+ *   shared layers: `layers/defaults.json` and `layers/groups/<group>.json`
+ *   (an application joins a group with its `ConfigGroup` key)
+ * - Propagating layer updates to the affected applications only; layer,
+ *   storage, journal and signal updates of every write happen under one
+ *   write lock shared with the adapters, so all writers apply in one order
+ * - Registering and removing applications while running
+ * - Caching parsed application files in `configs.cache`, when enabled, so
+ *   that unchanged files are not parsed again at the next start
+ * - Journaling changes (`journal.bin` in the config directory) and replaying
+ *   them at startup, when enabled; the journal is periodically compacted
+ *   into the application files
+ * - Taking per-application rate limits from the `RateLimit.*` keys of the
+ *   application file or its layers; clients cannot change these keys
+ * - Creating D-Bus adapters for each configuration, whose calls run through
+ *   weighted read/write/signal queues and whose parked WaitForChange calls
+ *   and temporary overrides share one timer thread
  * - Managing the D-Bus connection and event loop
+ * - Exposing service metrics on the manager object
  */
 class ConfigurationManager
 {
@@ -28,8 +98,9 @@ class ConfigurationManager
      * @brief Construct a new Configuration Manager
      * @param config_loader File manager implementation for loading configs
      * @param config_dir Optional custom configuration directory path
+     * @param options Optional service features
      */
-    explicit ConfigurationManager(std::unique_ptr<IConfigFileManager>, std::string = "");
+    explicit ConfigurationManager(std::unique_ptr<IConfigFileManager>, std::string = "", ManagerOptions = {});
 
     /**
      * @brief Start the configuration manager service
@@ -38,16 +109,218 @@ class ConfigurationManager
      * 1. Establish D-Bus connection
      * 2. Request service name
      * 3. Load configurations
-     * 4. Enter event loop
+     * 4. Register the manager object
+     * 5. Start accepting direct peer connections (if configured)
+     * 6. Enter event loop
      */
     void run();
 
    private:
+    using ConfigurationMap = DBusConfigAdapter::ConfigurationMap;
+    using ApplicationConfigurations = std::map<std::string, ConfigurationMap>;
+
+    /**
+     * @brief Register the manager object and its interfaces
+     *
+     * Registers the following D-Bus API on MANAGER_PATH:
+     * - Manager.ListApplications() → array<string>
+     * - Manager.GetConfigurations(apps: array<string>) → dict<string,dict<string,variant>>
+     * - Manager.ChangeConfigurationsForApps(changes: dict<string,dict<string,variant>>) → void
+     * - Manager.RegisterApplication(name: string, configuration: dict<string,variant>) → void
+     * - Manager.UnregisterApplication(name: string) → void
+     * - Manager.SetRateLimit(name: string, kind: string, rate: double, burst: double) → void
+     * - Manager.SetPropertiesPolicy(name: string, enabled: bool, invalidate_above: uint64) → void
+     * - Stats.GetCounters() → dict<string,uint64>
+     * - Stats.GetLatencies() → dict<string,(count, sum_ns, p50_ns, p90_ns, p99_ns)>
+     * - Stats.GetPrometheusText() → string
+     * - Layers.GetLayer(layer: string) → dict<string,variant>
+     * - Layers.SetLayerValue(layer: string, key: string, value: variant) → void
+     *
+     * Layer names are `defaults` and `group/<name>`.
+     */
+    void registerManagerObject();
+
+    /**
+     * @brief Periodically dump metrics to ManagerOptions::metrics_file
+     * @param stop_token Stops the loop after a final dump
+     */
+    void dumpMetricsPeriodically(std::stop_token);
+
+    /**
+     * @brief Periodically compact the change journal
+     * @param stop_token Stops the loop after a final compaction
+     */
+    void compactJournalPeriodically(std::stop_token);
+
+    /**
+     * @brief Write runtime overrides into the application files and empty the journal
+     *
+     * The journal is kept untouched if any file cannot be written.
+     */
+    void compactJournal();
+
     /**
      * @brief Load all configurations from the config directory
      */
     void loadConfigsFromDirectory();
 
+    /**
+     * @brief List the loaded applications
+     * @return Application names
+     */
+    std::vector<std::string> onListApplications() const;
+
+    /**
+     * @brief Read the configurations of several applications in one call
+     * @param apps Application names, an empty list selects every application
+     * @return Application name → configuration
+     * @throws sdbus::Error If an application is not loaded
+     */
+    ApplicationConfigurations onGetConfigurations(const std::vector<std::string>&) const;
+
+    /**
+     * @brief Change the configurations of several applications in one call
+     *
+     * All names are checked before anything is changed. Every application then
+     * receives its changes as one update (one configurationChanged signal).
+     * @param changes Application name → changed keys
+     * @throws sdbus::Error If an application is not loaded
+     */
+    void onChangeConfigurationsForApps(const ApplicationConfigurations&);
+
+    /**
+     * @brief Add an application while the service runs
+     *
+     * The configuration is resolved against the layers like a file loaded at
+     * startup, exposed on the bus and on every connected peer, and saved as
+     * `<name>.json` so it survives a restart.
+     * @param app_name Application name, letters, digits and `_` only
+     * @param config Application layer (may contain `ConfigGroup`)
+     * @throws sdbus::Error If the name is invalid or taken, or the configuration is incomplete
+     */
+    void onRegisterApplication(const std::string&, const ConfigurationMap&);
+
+    /**
+     * @brief Remove an application and retire its configuration file
+     *
+     * The file is renamed to `<file>.removed` rather than deleted: it may be
+     * maintained by hand, and is not loaded under that name. Failures to
+     * rename it or to journal the removal are logged; the application is
+     * removed either way.
+     * @param app_name Application name
+     * @throws sdbus::Error If the application is not loaded
+     */
+    void onUnregisterApplication(const std::string&);
+
+    /**
+     * @brief Change the per-sender rate limit of an application until the next restart
+     *
+     * Only the server's own user and root may call it, so that a client cannot
+     * lift its own limit. Limits that must survive a restart belong in the
+     * `RateLimit.*` keys of the configuration.
+     * @param app_name Application name
+     * @param kind `read` (GetConfiguration) or `write` (ChangeConfiguration)
+     * @param rate Calls per second, 0 disables the limit
+     * @param burst Calls allowed at once
+     * @throws sdbus::Error For other callers, unknown applications, unknown kinds or negative values
+     */
+    void onSetRateLimit(const std::string&, const std::string&, double, double);
+
+    /**
+     * @brief Change how an application exposes its keys as D-Bus properties until the next restart
+     * @param app_name Application name
+     * @param enabled Expose keys as properties
+     * @param invalidate_above Strings longer than this are announced invalidation-only
+     * @throws sdbus::Error For unknown applications
+     */
+    void onSetPropertiesPolicy(const std::string&, bool, uint64_t);
+
+    /**
+     * @brief Resolve an application against the layers and create its D-Bus adapter
+     * @param app_name Application name
+     * @param config Application layer
+     * @param history Journal history to restore (runtime changes and versions), may be null
+     * @return Registered adapter
+     * @throw std::runtime_error If the effective configuration is invalid
+     */
+    std::unique_ptr<DBusConfigAdapter> createApplication(const std::string&, ConfigurationMap,
+                                                         const ApplicationHistory* = nullptr);
+
+    /**
+     * @brief Read the rate limits of an application from the `RateLimit.*` keys of its configuration
+     *
+     * Missing or malformed keys fall back to the server-wide limits.
+     * @param app_name Application name
+     * @param effective Effective configuration of the application
+     * @return Read and write limits
+     */
+    std::pair<RateLimit, RateLimit> rateLimitsOf(const std::string&, const ConfigurationMap&) const;
+
+    /**
+     * @brief Apply the `RateLimit.*` keys of an application after they changed
+     *
+     * Called with layers_mutex_ held.
+     * @param adapter Application adapter
+     */
+    void updateRateLimits(DBusConfigAdapter&) const;
+
+    /**
+     * @brief Reject the current manager call unless it comes from the server's own user or root
+     * @throws sdbus::Error With ERROR_ACCESS_DENIED for other callers
+     */
+    void checkPrivilegedCaller() const;
+
+    /**
+     * @brief Check that a name can be used as the last element of an object path
+     * @param app_name Application name
+     * @return true if the name is valid
+     */
+    static bool isValidApplicationName(const std::string&);
+
+    /**
+     * @brief Load the shared defaults and group layers from the layers directory
+     * @param dir_path Configuration directory
+     */
+    void loadLayersFromDirectory(const std::filesystem::path&);
+
+    /**
+     * @brief Revert an expired temporary override to the value of the layers underneath
+     * @param app_name Application name
+     * @param key Expired key
+     */
+    void onOverrideExpired(const std::string&, const std::string&);
+
+    /**
+     * @brief Set a key of a shared layer, persist the layer and update affected applications
+     * @param layer `defaults` or `group/<name>`
+     * @param key Parameter name
+     * @param value New value
+     * @throws sdbus::Error For invalid layer names
+     */
+    void onSetLayerValue(const std::string&, const std::string&, const sdbus::Variant&);
+
+    /**
+     * @brief Get the contents of a shared layer
+     * @param layer `defaults` or `group/<name>`
+     * @return Layer contents
+     * @throws sdbus::Error For invalid layer names
+     */
+    std::map<std::string, sdbus::Variant> onGetLayer(const std::string&);
+
+    /**
+     * @brief Get the file a shared layer is stored in
+     * @param layer `defaults` or `group/<name>`
+     * @return Layer file path
+     */
+    std::filesystem::path layerFilePath(const std::string&) const;
+
+    /**
+     * @brief Find the adapter of an application
+     * @param app_name Application name
+     * @return Adapter, or nullptr if the application is not loaded
+     */
+    DBusConfigAdapter* findAdapter(const std::string&) const;
+
     /**
      * @brief Get the configuration directory path
      * @return Full path to configuration directory
@@ -64,6 +337,21 @@ class ConfigurationManager
 
     std::unique_ptr<sdbus::IConnection> connection_;
     std::unique_ptr<IConfigFileManager> config_loader_;
-    std::vector<std::unique_ptr<DBusConfigAdapter>> adapters_;
+    std::unique_ptr<ChangeJournal> journal_;
+    std::unique_ptr<DispatchScheduler> scheduler_;
+    TimerService timers_;
+    TimerWheel expirations_{timers_};
+    // Serialises every configuration write, taken before layers_mutex_; declared first to outlive the adapters
+    std::recursive_mutex writes_mutex_;
+    mutable std::shared_mutex adapters_mutex_;
+    std::unordered_map<std::string, std::unique_ptr<DBusConfigAdapter>> adapters_;
+    std::unique_ptr<PeerServer> peer_server_;
+    std::mutex layers_mutex_;
+    ConfigLayers layers_;
+    std::unordered_map<std::string, std::filesystem::path> app_files_;
     std::string custom_config_dir_;
+    ManagerOptions options_;
+    std::unique_ptr<sdbus::IObject> manager_object_;
+    std::jthread metrics_dumper_;
+    std::jthread journal_compactor_;
 };
\ No newline at end of file
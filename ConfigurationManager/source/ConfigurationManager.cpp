@@ -1,13 +1,65 @@
 #include "ConfigurationManager/ConfigurationManager.hpp"
 
+#include <Logger/Logger.hpp>
+#include <algorithm>
+#include <cctype>
+#include <condition_variable>
 #include <cstdlib>
-#include <iostream>
+#include <mutex>
+#include <optional>
+#include <unistd.h>
 
 namespace fs = std::filesystem;
 
-ConfigurationManager::ConfigurationManager(std::unique_ptr<IConfigFileManager> config_loader, std::string config_dir)
-    : config_loader_(std::move(config_loader)), custom_config_dir_(std::move(config_dir))
+namespace
 {
+/**
+ * @brief Read a numeric configuration value as a double
+ * @param value Configuration value
+ * @return The number, or nothing for values of other types
+ */
+std::optional<double> numberOf(const sdbus::Variant& value)
+{
+    const auto type = value.peekValueType();
+    if (type == "y")
+        return value.get<uint8_t>();
+    if (type == "n")
+        return value.get<int16_t>();
+    if (type == "q")
+        return value.get<uint16_t>();
+    if (type == "i")
+        return value.get<int32_t>();
+    if (type == "u")
+        return value.get<uint32_t>();
+    if (type == "x")
+        return static_cast<double>(value.get<int64_t>());
+    if (type == "t")
+        return static_cast<double>(value.get<uint64_t>());
+    if (type == "d")
+        return value.get<double>();
+    return std::nullopt;
+}
+
+/**
+ * @brief Check whether changed keys include a rate limit key
+ */
+template <typename Changes>
+bool touchesRateLimits(const Changes& changes)
+{
+    return std::any_of(changes.begin(), changes.end(),
+                       [](const auto& change) { return change.first.rfind(RATE_LIMIT_KEY_PREFIX, 0) == 0; });
+}
+}  // namespace
+
+ConfigurationManager::ConfigurationManager(std::unique_ptr<IConfigFileManager> config_loader, std::string config_dir,
+                                           ManagerOptions options)
+    : config_loader_(std::move(config_loader)),
+      custom_config_dir_(std::move(config_dir)),
+      options_(std::move(options))
+{
+    if (options_.dispatch_queues)
+        scheduler_ = std::make_unique<DispatchScheduler>(options_.dispatch);
+    ContentStore::instance().setSealAbove(options_.fd_values_above);
 }
 
 std::string ConfigurationManager::getConfigDirectoryPath() const
@@ -32,8 +84,33 @@ void ConfigurationManager::run()
     connection_ = sdbus::createSessionBusConnection();
     connection_->requestName(REQUEST_NAME);
     loadConfigsFromDirectory();
+    registerManagerObject();
+
+    if (!options_.peer_socket.empty())
+    {
+        peer_server_ = std::make_unique<PeerServer>(
+            options_.peer_socket,
+            [this](sdbus::IConnection& peer)
+            {
+                std::shared_lock<std::shared_mutex> lock(adapters_mutex_);
+                for (auto& [app_name, adapter] : adapters_) adapter->attachConnection(peer);
+            },
+            [this](sdbus::IConnection& peer)
+            {
+                std::shared_lock<std::shared_mutex> lock(adapters_mutex_);
+                for (auto& [app_name, adapter] : adapters_) adapter->detachConnection(peer);
+            });
+        peer_server_->start();
+        Logger::instance().info("Accepting direct peer connections on ", options_.peer_socket);
+    }
 
-    std::cout << STARTED;
+    if (!options_.metrics_file.empty())
+        metrics_dumper_ = std::jthread([this](std::stop_token stop_token) { dumpMetricsPeriodically(stop_token); });
+    if (journal_)
+        journal_compactor_ =
+            std::jthread([this](std::stop_token stop_token) { compactJournalPeriodically(stop_token); });
+
+    Logger::instance().info(STARTED);
     connection_->enterEventLoop();
 }
 
@@ -43,11 +120,37 @@ void ConfigurationManager::loadConfigsFromDirectory()
 
     if (!fs::exists(dir_path))
     {
-        std::cerr << "Config directory not found, creating: " << dir_path << '\n';
+        Logger::instance().warning("Config directory not found, creating: ", dir_path);
         fs::create_directories(dir_path);
-        return;
     }
 
+    loadLayersFromDirectory(dir_path);
+
+    std::map<std::string, ApplicationHistory> histories;
+    if (options_.journal)
+    {
+        try
+        {
+            journal_ = std::make_unique<ChangeJournal>((fs::path(dir_path) / JOURNAL_FILE).string());
+            histories = journal_->replay();
+        }
+        catch (const std::exception& e)
+        {
+            Logger::instance().error("Change journal disabled: ", e.what());
+            journal_.reset();
+        }
+    }
+
+    auto& registry = MetricsRegistry::instance();
+    auto& load_duration = registry.histogram("config_load_duration_seconds");
+    auto& files_loaded = registry.counter("config_files_loaded_total");
+    auto& files_failed = registry.counter("config_files_failed_total");
+
+    std::unique_ptr<ConfigFileCache> cache;
+    if (options_.config_cache)
+        cache = std::make_unique<ConfigFileCache>((fs::path(dir_path) / CONFIG_CACHE_FILE).string());
+    const ConfigFileCache::Parser parse = [this](const std::string& path) { return config_loader_->loadLayer(path); };
+
     for (const auto& entry : fs::directory_iterator(dir_path))
     {
         if (entry.is_regular_file() && isValidConfigFile(entry.path()))
@@ -56,16 +159,624 @@ void ConfigurationManager::loadConfigsFromDirectory()
 
             try
             {
-                auto params = config_loader_->load(entry.path().string());
-                auto adapter = std::make_unique<DBusConfigAdapter>(
-                    std::make_unique<AppConfig>(app_name, std::move(params)), *connection_);
-                adapter->registerDBusInterface();
-                adapters_.emplace_back(std::move(adapter));
+                auto params = [&]
+                {
+                    ScopedTimer timer(&load_duration);
+                    return cache ? cache->load(entry.path().string(), parse) : parse(entry.path().string());
+                }();
+
+                if (adapters_.contains(app_name))
+                    throw std::runtime_error("duplicate application name " + app_name);
+                const auto history = histories.find(app_name);
+                adapters_.emplace(app_name, createApplication(app_name, std::move(params),
+                                                              history == histories.end() ? nullptr : &history->second));
+                app_files_.emplace(app_name, entry.path());
+                files_loaded.increment();
             }
             catch (const std::exception& e)
             {
-                std::cerr << "Error loading config " << entry.path() << ": " << e.what() << '\n';
+                files_failed.increment();
+                Logger::instance().error("Error loading config ", entry.path().string(), ": ", e.what());
             }
         }
     }
+
+    if (!cache)
+        return;
+    registry.counter("config_cache_hits_total").increment(cache->hits());
+    registry.counter("config_cache_misses_total").increment(cache->misses());
+    try
+    {
+        cache->save();
+    }
+    catch (const std::exception& e)
+    {
+        Logger::instance().warning(e.what());
+    }
+}
+
+std::unique_ptr<DBusConfigAdapter> ConfigurationManager::createApplication(const std::string& app_name,
+                                                                         ConfigurationMap config,
+                                                                         const ApplicationHistory* history)
+{
+    ConfigurationMap effective;
+    {
+        std::lock_guard<std::mutex> lock(layers_mutex_);
+        effective = layers_.addApplication(app_name, std::move(config));
+        if (history && !history->overrides.empty())
+        {
+            for (const auto& [key, value] : history->overrides) layers_.setOverride(app_name, key, value);
+            effective = layers_.effective(app_name);
+        }
+        try
+        {
+            config_loader_->validate(effective);
+        }
+        catch (const std::exception&)
+        {
+            layers_.removeApplication(app_name);
+            throw;
+        }
+    }
+
+    const auto [read_limit, write_limit] = rateLimitsOf(app_name, effective);
+    try
+    {
+        auto adapter = std::make_unique<DBusConfigAdapter>(
+            std::make_unique<AppConfig>(app_name, std::move(effective)), *connection_);
+        adapter->setChangeListener(
+            [this](const std::string& app, const std::string& key, const sdbus::Variant& value,
+                   std::chrono::milliseconds ttl)
+            {
+                // Otherwise a client could lift its own limit, and the override would outlive a restart
+                if (key.rfind(RATE_LIMIT_KEY_PREFIX, 0) == 0)
+                    throw std::runtime_error("Rate limits are not changed by applications: " + key);
+                std::lock_guard<std::mutex> lock(layers_mutex_);
+                if (ttl > std::chrono::milliseconds::zero())
+                    layers_.setTemporary(app, key, value);
+                else
+                    layers_.setOverride(app, key, value);
+            });
+        adapter->setExpiryHandler([this](const std::string& app, const std::string& key)
+                                  { onOverrideExpired(app, key); });
+        adapter->setWriteMutex(&writes_mutex_);
+        if (history)
+            adapter->restoreHistory(*history);
+        adapter->setJournal(journal_.get());
+        adapter->setScheduler(scheduler_.get());
+        adapter->setTimerService(&timers_);
+        adapter->setExpiryWheel(&expirations_);
+        adapter->setReadRateLimit(read_limit);
+        adapter->setWriteRateLimit(write_limit);
+        adapter->setPropertiesPolicy(options_.properties);
+        if (options_.shared_snapshots)
+            adapter->enableSharedSnapshot();
+        adapter->registerDBusInterface();
+        return adapter;
+    }
+    catch (const std::exception&)
+    {
+        std::lock_guard<std::mutex> lock(layers_mutex_);
+        layers_.removeApplication(app_name);
+        throw;
+    }
+}
+
+void ConfigurationManager::onRegisterApplication(const std::string& app_name, const ConfigurationMap& config)
+{
+    if (!isValidApplicationName(app_name))
+        throw sdbus::Error(ERROR_INVALID_ARGS, "Invalid application name: " + app_name);
+    if (findAdapter(app_name))
+        throw sdbus::Error(ERROR_APPLICATION_EXISTS, app_name);
+    if (touchesRateLimits(config))
+        checkPrivilegedCaller();
+
+    std::unique_ptr<DBusConfigAdapter> adapter;
+    try
+    {
+        adapter = createApplication(app_name, config);
+    }
+    catch (const std::exception& e)
+    {
+        throw sdbus::Error(ERROR_INVALID_ARGS, e.what());
+    }
+
+    const fs::path file = fs::path(getConfigDirectoryPath()) / (app_name + ".json");
+    try
+    {
+        config_loader_->save(file.string(), config);
+    }
+    catch (const std::exception& e)
+    {
+        Logger::instance().error("Error saving config of ", app_name, ": ", e.what());
+    }
+    {
+        std::lock_guard<std::mutex> lock(layers_mutex_);
+        app_files_[app_name] = file;
+    }
+
+    auto* registered = adapter.get();
+    {
+        std::unique_lock<std::shared_mutex> lock(adapters_mutex_);
+        adapters_.emplace(app_name, std::move(adapter));
+    }
+    // Peers that connected meanwhile were attached by the connect handler; attaching twice is a no-op
+    if (peer_server_)
+        peer_server_->forEachConnection([registered](sdbus::IConnection& peer) { registered->attachConnection(peer); });
+
+    Logger::instance().info("Registered application ", app_name);
+}
+
+void ConfigurationManager::onUnregisterApplication(const std::string& app_name)
+{
+    std::unique_ptr<DBusConfigAdapter> adapter;
+    {
+        std::unique_lock<std::shared_mutex> lock(adapters_mutex_);
+        const auto it = adapters_.find(app_name);
+        if (it == adapters_.end())
+            throw sdbus::Error(ERROR_UNKNOWN_APPLICATION, app_name);
+        adapter = std::move(it->second);
+        adapters_.erase(it);
+    }
+    fs::path file;
+    {
+        std::lock_guard<std::mutex> lock(layers_mutex_);
+        layers_.removeApplication(app_name);
+        if (const auto it = app_files_.find(app_name); it != app_files_.end())
+        {
+            file = it->second;
+            app_files_.erase(it);
+        }
+    }
+    if (journal_)
+    {
+        try
+        {
+            journal_->append({JournalRecord::Kind::Removed, app_name, adapter->version(), {}, {}});
+        }
+        catch (const std::exception& e)
+        {
+            Logger::instance().error("Cannot journal removal of ", app_name, ": ", e.what());
+        }
+    }
+
+    if (!file.empty())
+    {
+        // Kept under another name: the file may be maintained by hand, not created by RegisterApplication
+        fs::path retired = file;
+        retired += REMOVED_SUFFIX;
+        std::error_code error;
+        fs::rename(file, retired, error);
+        if (error)
+            Logger::instance().error("Cannot retire configuration file ", file.string(), ": ", error.message());
+        else
+            Logger::instance().info("Configuration file of ", app_name, " kept as ", retired.string());
+    }
+
+    Logger::instance().info("Unregistered application ", app_name);
+}
+
+bool ConfigurationManager::isValidApplicationName(const std::string& app_name)
+{
+    // The name becomes the last element of a D-Bus object path
+    return !app_name.empty() &&
+           std::all_of(app_name.begin(), app_name.end(), [](unsigned char c) { return std::isalnum(c) || c == '_'; });
+}
+
+void ConfigurationManager::loadLayersFromDirectory(const fs::path& dir_path)
+{
+    const fs::path layers_dir = dir_path / LAYERS_DIR;
+    if (!fs::is_directory(layers_dir))
+        return;
+
+    auto loadLayer = [this](const std::string& layer, const fs::path& path)
+    {
+        try
+        {
+            layers_.setLayer(layer, config_loader_->loadLayer(path.string()));
+        }
+        catch (const std::exception& e)
+        {
+            Logger::instance().error("Error loading layer ", path.string(), ": ", e.what());
+        }
+    };
+
+    for (const auto& entry : fs::directory_iterator(layers_dir))
+    {
+        if (entry.is_regular_file() && isValidConfigFile(entry.path()) && entry.path().stem() == DEFAULTS_LAYER)
+            loadLayer(DEFAULTS_LAYER, entry.path());
+    }
+
+    const fs::path groups_dir = layers_dir / GROUPS_DIR;
+    if (!fs::is_directory(groups_dir))
+        return;
+
+    for (const auto& entry : fs::directory_iterator(groups_dir))
+    {
+        if (entry.is_regular_file() && isValidConfigFile(entry.path()))
+            loadLayer(GROUP_LAYER_PREFIX + entry.path().stem().string(), entry.path());
+    }
+}
+
+fs::path ConfigurationManager::layerFilePath(const std::string& layer) const
+{
+    const fs::path layers_dir = fs::path(getConfigDirectoryPath()) / LAYERS_DIR;
+    if (layer == DEFAULTS_LAYER)
+        return layers_dir / (DEFAULTS_LAYER + ".json");
+    return layers_dir / GROUPS_DIR / (layer.substr(GROUP_LAYER_PREFIX.size()) + ".json");
+}
+
+std::pair<RateLimit, RateLimit> ConfigurationManager::rateLimitsOf(const std::string& app_name,
+                                                                   const ConfigurationMap& effective) const
+{
+    const auto limit = [&](const std::string& rate_key, const std::string& burst_key, RateLimit fallback)
+    {
+        for (auto [key, field] : {std::pair{&rate_key, &fallback.rate}, std::pair{&burst_key, &fallback.burst}})
+        {
+            const auto it = effective.find(*key);
+            if (it == effective.end())
+                continue;
+            const auto number = numberOf(it->second);
+            if (number && *number >= 0)
+                *field = *number;
+            else
+                Logger::instance().warning("Ignored ", app_name, ".", *key, ": a non-negative number is required");
+        }
+        return fallback;
+    };
+    return {limit(READ_RATE_KEY, READ_BURST_KEY, options_.read_rate_limit),
+            limit(WRITE_RATE_KEY, WRITE_BURST_KEY, options_.write_rate_limit)};
+}
+
+void ConfigurationManager::updateRateLimits(DBusConfigAdapter& adapter) const
+{
+    const auto app_name = adapter.getAppName();
+    const auto [read_limit, write_limit] = rateLimitsOf(app_name, layers_.effective(app_name));
+    adapter.setReadRateLimit(read_limit);
+    adapter.setWriteRateLimit(write_limit);
+}
+
+void ConfigurationManager::checkPrivilegedCaller() const
+{
+    const auto* message = manager_object_->getCurrentlyProcessedMessage();
+    if (!message)
+        throw sdbus::Error(ERROR_ACCESS_DENIED, "The caller cannot be identified");
+    const uid_t uid = message->getCredentialsUid();
+    if (uid != 0 && uid != getuid())
+        throw sdbus::Error(ERROR_ACCESS_DENIED, "Only the server's user or root may do this");
+}
+
+void ConfigurationManager::onSetRateLimit(const std::string& app_name, const std::string& kind, double rate,
+                                          double burst)
+{
+    checkPrivilegedCaller();
+    auto* adapter = findAdapter(app_name);
+    if (!adapter)
+        throw sdbus::Error(ERROR_UNKNOWN_APPLICATION, app_name);
+    if (rate < 0 || burst < 0)
+        throw sdbus::Error(ERROR_INVALID_ARGS, "Rate and burst must not be negative");
+
+    if (kind == "read")
+        adapter->setReadRateLimit({rate, burst});
+    else if (kind == "write")
+        adapter->setWriteRateLimit({rate, burst});
+    else
+        throw sdbus::Error(ERROR_INVALID_ARGS, "Unknown rate limit kind: " + kind);
+
+    Logger::instance().info("Rate limit of ", app_name, " ", kind, "s set to ", rate, "/s, burst ", burst);
+}
+
+void ConfigurationManager::onSetPropertiesPolicy(const std::string& app_name, bool enabled, uint64_t invalidate_above)
+{
+    auto* adapter = findAdapter(app_name);
+    if (!adapter)
+        throw sdbus::Error(ERROR_UNKNOWN_APPLICATION, app_name);
+
+    adapter->setPropertiesPolicy({enabled, static_cast<std::size_t>(invalidate_above)});
+    Logger::instance().info("Properties of ", app_name, enabled ? " enabled" : " disabled",
+                            ", invalidation-only above ", invalidate_above, " bytes");
+}
+
+DBusConfigAdapter* ConfigurationManager::findAdapter(const std::string& app_name) const
+{
+    std::shared_lock<std::shared_mutex> lock(adapters_mutex_);
+    const auto it = adapters_.find(app_name);
+    return it == adapters_.end() ? nullptr : it->second.get();
+}
+
+std::vector<std::string> ConfigurationManager::onListApplications() const
+{
+    std::shared_lock<std::shared_mutex> lock(adapters_mutex_);
+    std::vector<std::string> names;
+    names.reserve(adapters_.size());
+    for (const auto& [app_name, adapter] : adapters_) names.push_back(app_name);
+    return names;
+}
+
+ConfigurationManager::ApplicationConfigurations ConfigurationManager::onGetConfigurations(
+    const std::vector<std::string>& apps) const
+{
+    ApplicationConfigurations result;
+    if (apps.empty())
+    {
+        std::shared_lock<std::shared_mutex> lock(adapters_mutex_);
+        for (const auto& [app_name, adapter] : adapters_) result.emplace(app_name, adapter->getConfiguration());
+        return result;
+    }
+
+    for (const auto& app_name : apps)
+    {
+        const auto* adapter = findAdapter(app_name);
+        if (!adapter)
+            throw sdbus::Error(ERROR_UNKNOWN_APPLICATION, app_name);
+        result.emplace(app_name, adapter->getConfiguration());
+    }
+    return result;
+}
+
+void ConfigurationManager::onChangeConfigurationsForApps(const ApplicationConfigurations& changes)
+{
+    std::vector<std::pair<DBusConfigAdapter*, const ConfigurationMap*>> targets;
+    targets.reserve(changes.size());
+    for (const auto& [app_name, app_changes] : changes)
+    {
+        auto* adapter = findAdapter(app_name);
+        if (!adapter)
+            throw sdbus::Error(ERROR_UNKNOWN_APPLICATION, app_name);
+        if (touchesRateLimits(app_changes))
+            checkPrivilegedCaller();
+        targets.emplace_back(adapter, &app_changes);
+    }
+
+    std::lock_guard<std::recursive_mutex> writing(writes_mutex_);
+    std::lock_guard<std::mutex> lock(layers_mutex_);
+    for (const auto& [adapter, app_changes] : targets)
+    {
+        for (const auto& [key, value] : *app_changes) layers_.setOverride(adapter->getAppName(), key, value);
+        adapter->applyChanges(*app_changes, JournalRecord::Kind::Override);
+        if (touchesRateLimits(*app_changes))
+            updateRateLimits(*adapter);
+    }
+}
+
+void ConfigurationManager::onOverrideExpired(const std::string& app_name, const std::string& key)
+{
+    std::lock_guard<std::recursive_mutex> writing(writes_mutex_);
+    std::lock_guard<std::mutex> lock(layers_mutex_);
+
+    std::optional<sdbus::Variant> value;
+    try
+    {
+        value = layers_.clearTemporary(app_name, key);
+    }
+    catch (const std::runtime_error& e)
+    {
+        Logger::instance().warning("Expired override of a removed application: ", e.what());
+        return;
+    }
+
+    // Without a temporary override left the key was changed for good in the meantime
+    if (!value)
+        return;
+    if (auto* adapter = findAdapter(app_name))
+    {
+        adapter->applyChanges({{key, *value}});
+        if (key.rfind(RATE_LIMIT_KEY_PREFIX, 0) == 0)
+            updateRateLimits(*adapter);
+    }
+}
+
+void ConfigurationManager::onSetLayerValue(const std::string& layer, const std::string& key,
+                                           const sdbus::Variant& value)
+{
+    if (key.rfind(RATE_LIMIT_KEY_PREFIX, 0) == 0)
+        checkPrivilegedCaller();
+    std::lock_guard<std::recursive_mutex> writing(writes_mutex_);
+    std::lock_guard<std::mutex> lock(layers_mutex_);
+
+    ConfigLayers::Changes changes;
+    try
+    {
+        changes = layers_.setLayerValue(layer, key, value);
+    }
+    catch (const std::runtime_error& e)
+    {
+        throw sdbus::Error(ERROR_INVALID_LAYER, e.what());
+    }
+
+    try
+    {
+        const fs::path path = layerFilePath(layer);
+        fs::create_directories(path.parent_path());
+        config_loader_->save(path.string(), layers_.layer(layer));
+    }
+    catch (const std::exception& e)
+    {
+        Logger::instance().error("Error saving layer ", layer, ": ", e.what());
+    }
+
+    for (const auto& [app_name, app_changes] : changes)
+    {
+        if (auto* adapter = findAdapter(app_name))
+        {
+            adapter->applyChanges(app_changes);
+            if (touchesRateLimits(app_changes))
+                updateRateLimits(*adapter);
+        }
+    }
+    Logger::instance().debug("Layer ", layer, " key ", key, " changed ", changes.size(), " application(s)");
+}
+
+std::map<std::string, sdbus::Variant> ConfigurationManager::onGetLayer(const std::string& layer)
+{
+    std::lock_guard<std::mutex> lock(layers_mutex_);
+    try
+    {
+        return layers_.layer(layer);
+    }
+    catch (const std::runtime_error& e)
+    {
+        throw sdbus::Error(ERROR_INVALID_LAYER, e.what());
+    }
+}
+
+void ConfigurationManager::registerManagerObject()
+{
+    manager_object_ = sdbus::createObject(*connection_, MANAGER_PATH);
+    if (!manager_object_)
+        throw std::runtime_error(ERROR_CREATE + MANAGER_PATH);
+
+    manager_object_->registerMethod("ListApplications")
+        .onInterface(MANAGER_INTERFACE)
+        .withOutputParamNames("applications")
+        .implementedAs([this]() { return onListApplications(); });
+
+    manager_object_->registerMethod("GetConfigurations")
+        .onInterface(MANAGER_INTERFACE)
+        .withInputParamNames("applications")
+        .withOutputParamNames("configurations")
+        .implementedAs([this](const std::vector<std::string>& apps) { return onGetConfigurations(apps); });
+
+    manager_object_->registerMethod("ChangeConfigurationsForApps")
+        .onInterface(MANAGER_INTERFACE)
+        .withInputParamNames("changes")
+        .implementedAs([this](const ApplicationConfigurations& changes) { onChangeConfigurationsForApps(changes); });
+
+    manager_object_->registerMethod("RegisterApplication")
+        .onInterface(MANAGER_INTERFACE)
+        .withInputParamNames("name", "configuration")
+        .implementedAs([this](const std::string& app_name, const ConfigurationMap& config)
+                       { onRegisterApplication(app_name, config); });
+
+    manager_object_->registerMethod("UnregisterApplication")
+        .onInterface(MANAGER_INTERFACE)
+        .withInputParamNames("name")
+        .implementedAs([this](const std::string& app_name) { onUnregisterApplication(app_name); });
+
+    manager_object_->registerMethod("SetRateLimit")
+        .onInterface(MANAGER_INTERFACE)
+        .withInputParamNames("name", "kind", "rate", "burst")
+        .implementedAs([this](const std::string& app_name, const std::string& kind, double rate, double burst)
+                       { onSetRateLimit(app_name, kind, rate, burst); });
+
+    manager_object_->registerMethod("SetPropertiesPolicy")
+        .onInterface(MANAGER_INTERFACE)
+        .withInputParamNames("name", "enabled", "invalidate_above")
+        .implementedAs([this](const std::string& app_name, bool enabled, uint64_t invalidate_above)
+                       { onSetPropertiesPolicy(app_name, enabled, invalidate_above); });
+
+    manager_object_->registerMethod("GetCounters")
+        .onInterface(STATS_INTERFACE)
+        .withOutputParamNames("counters")
+        .implementedAs([]() { return MetricsRegistry::instance().counterValues(); });
+
+    manager_object_->registerMethod("GetLatencies")
+        .onInterface(STATS_INTERFACE)
+        .withOutputParamNames("latencies")
+        .implementedAs(
+            []()
+            {
+                using Summary = sdbus::Struct<uint64_t, uint64_t, uint64_t, uint64_t, uint64_t>;
+                std::map<std::string, Summary> result;
+                for (const auto& [series, snapshot] : MetricsRegistry::instance().histogramSnapshots())
+                {
+                    result.emplace(series, Summary{snapshot.count, snapshot.sum, snapshot.percentile(0.5),
+                                                   snapshot.percentile(0.9), snapshot.percentile(0.99)});
+                }
+                return result;
+            });
+
+    manager_object_->registerMethod("GetPrometheusText")
+        .onInterface(STATS_INTERFACE)
+        .withOutputParamNames("text")
+        .implementedAs([]() { return MetricsRegistry::instance().renderPrometheus(); });
+
+    manager_object_->registerMethod("GetLayer")
+        .onInterface(LAYERS_INTERFACE)
+        .withInputParamNames("layer")
+        .withOutputParamNames("configuration")
+        .implementedAs([this](const std::string& layer) { return onGetLayer(layer); });
+
+    manager_object_->registerMethod("SetLayerValue")
+        .onInterface(LAYERS_INTERFACE)
+        .withInputParamNames("layer", "key", "value")
+        .implementedAs([this](const std::string& layer, const std::string& key, const sdbus::Variant& value)
+                       { onSetLayerValue(layer, key, value); });
+
+    manager_object_->finishRegistration();
+}
+
+void ConfigurationManager::compactJournal()
+{
+    // No write may journal between the saved files and the checkpoints
+    std::lock_guard<std::recursive_mutex> writing(writes_mutex_);
+    std::lock_guard<std::mutex> lock(layers_mutex_);
+    std::shared_lock<std::shared_mutex> adapters_lock(adapters_mutex_);
+
+    std::map<std::string, uint64_t> checkpoints;
+    for (const auto& [app_name, adapter] : adapters_)
+    {
+        checkpoints.emplace(app_name, adapter->version());
+
+        const auto file = app_files_.find(app_name);
+        if (file == app_files_.end())
+            continue;
+
+        try
+        {
+            if (auto config = layers_.flattenOverrides(app_name))
+                config_loader_->save(file->second.string(), *config);
+        }
+        catch (const std::exception& e)
+        {
+            Logger::instance().error("Journal compaction aborted, cannot save ", file->second.string(), ": ",
+                                     e.what());
+            return;
+        }
+    }
+
+    journal_->reset(checkpoints);
+}
+
+void ConfigurationManager::compactJournalPeriodically(std::stop_token stop_token)
+{
+    std::mutex mutex;
+    std::condition_variable_any wake;
+    std::size_t compacted_size = journal_->size();
+
+    while (!stop_token.stop_requested())
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait_for(lock, stop_token, options_.journal_compact_interval, [] { return false; });
+        }
+
+        if (journal_->size() == compacted_size)
+            continue;
+        compactJournal();
+        compacted_size = journal_->size();
+    }
+}
+
+void ConfigurationManager::dumpMetricsPeriodically(std::stop_token stop_token)
+{
+    std::mutex mutex;
+    std::condition_variable_any wake;
+
+    while (!stop_token.stop_requested())
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait_for(lock, stop_token, options_.metrics_interval, [] { return false; });
+        }
+
+        try
+        {
+            MetricsRegistry::instance().dumpPrometheus(options_.metrics_file);
+        }
+        catch (const std::exception& e)
+        {
+            Logger::instance().error("Error dumping metrics: ", e.what());
+        }
+    }
 }
\ No newline at end of file
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <sdbus-c++/sdbus-c++.h>
+
+#include <ConfigValue/ConfigValue.hpp>
+#include <Metrics/Metrics.hpp>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/**
+ * @class ContentStore
+ * @brief Process-wide content-addressed store of configurations and long strings
+ *
+ * Application files are often byte-identical or share most values. Interning
+ * returns the one immutable instance already holding equal content, so
+ * identical parameter sets, file layers and long string values are kept once
+ * however many applications use them.
+ *
+ * Configurations are found by a content hash and held weakly: an instance
+ * goes away with its last user. Holders never modify an interned instance;
+ * they copy it on their first change (copy-on-write) and keep the copy
+ * private. Long strings are held until a periodic prune finds the store to be
+ * their only user.
+ *
+ * Strings above the seal limit are moved into sealed memfds when they are
+ * interned (see ConfigValue::sealed()), so D-Bus replies and signals pass them
+ * as file descriptors instead of copying them.
+ *
+ * Every lookup that finds shared content is counted in
+ * `config_dedup_hits_total{kind}`.
+ */
+class ContentStore
+{
+   public:
+    using Parameters = std::map<std::string, ConfigValue>;
+    using Configuration = std::map<std::string, sdbus::Variant>;
+
+    /**
+     * @brief Get the process-wide store
+     * @return Store instance
+     */
+    static ContentStore& instance();
+
+    /**
+     * @brief Share a parameter set, and its long string values, with equal ones
+     * @param parameters Parameter set to intern
+     * @return Immutable instance holding the same parameters
+     */
+    std::shared_ptr<const Parameters> internParameters(Parameters);
+
+    /**
+     * @brief Share a variant configuration (e.g. a file layer) with equal ones
+     *
+     * Configurations holding values BinaryWriter cannot encode are returned
+     * unshared.
+     * @param configuration Configuration to intern
+     * @return Immutable instance holding the same configuration
+     */
+    std::shared_ptr<const Configuration> internConfiguration(Configuration);
+
+    /**
+     * @brief Share the heap buffer of a long string value with equal strings
+     * @param value Any value; scalars and inline strings are returned unchanged
+     * @return Equal value
+     */
+    ConfigValue internValue(ConfigValue);
+
+    /**
+     * @brief Keep strings longer than a limit in sealed memfds from now on
+     * @param limit Size in bytes, 0 keeps every string on the heap
+     */
+    void setSealAbove(std::size_t);
+
+    /**
+     * @brief Count the distinct parameter sets still in use
+     * @return Number of live parameter sets
+     */
+    [[nodiscard]] std::size_t parameterSets() const;
+
+    /**
+     * @brief Count the distinct long strings held by the store
+     * @return Number of strings, including ones not pruned yet
+     */
+    [[nodiscard]] std::size_t strings() const;
+
+   private:
+    ContentStore();
+
+    /**
+     * @struct Table
+     * @brief Weak references to interned instances by content hash
+     */
+    template <typename T>
+    struct Table
+    {
+        std::unordered_multimap<uint64_t, std::weak_ptr<const T>> entries;
+        std::size_t prune_at = MIN_PRUNE_SIZE;
+    };
+
+    /**
+     * @brief Find an equal live instance or add a new one
+     * @param table Table to look in, locked by the caller
+     * @param hash Content hash of the value
+     * @param value Value to intern
+     * @param equal Compares a live instance with the value
+     * @param hits Counter of lookups that found an equal instance
+     * @return Shared instance
+     */
+    template <typename T, typename Equal>
+    std::shared_ptr<const T> intern(Table<T>&, uint64_t, T, const Equal&, Counter&);
+
+    /**
+     * @brief Drop expired entries once the table has doubled since the last prune
+     */
+    template <typename T>
+    static void prune(Table<T>&);
+
+    /**
+     * @brief Share a long string value, the caller holds mutex_
+     */
+    ConfigValue internValueLocked(ConfigValue);
+
+    static constexpr std::size_t MIN_PRUNE_SIZE = 64;
+
+    mutable std::mutex mutex_;
+    Table<Parameters> parameters_;
+    Table<Configuration> configurations_;
+    std::unordered_map<std::string_view, ConfigValue> strings_;  // Keys view the values' own buffers
+    std::size_t strings_prune_at_ = MIN_PRUNE_SIZE;
+    std::size_t seal_above_ = 0;
+
+    Counter& parameter_hits_;
+    Counter& configuration_hits_;
+    Counter& string_hits_;
+};
\ No newline at end of file
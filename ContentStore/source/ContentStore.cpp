@@ -0,0 +1,167 @@
+#include "ContentStore/ContentStore.hpp"
+
+#include <BinaryCodec/BinaryCodec.hpp>
+#include <algorithm>
+#include <stdexcept>
+
+static const std::string DEDUP_HITS = "config_dedup_hits_total";
+
+/**
+ * @brief Hash a parameter set from its keys and values
+ */
+static uint64_t hashParameters(const ContentStore::Parameters& parameters)
+{
+    uint64_t hash = fnv1a64({});
+    for (const auto& [key, value] : parameters)
+    {
+        hash = (hash ^ fnv1a64(key)) * 1099511628211ULL;
+        hash = (hash ^ value.hash()) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+ContentStore& ContentStore::instance()
+{
+    static ContentStore store;
+    return store;
+}
+
+ContentStore::ContentStore()
+    : parameter_hits_(MetricsRegistry::instance().counter(DEDUP_HITS, {{"kind", "parameters"}})),
+      configuration_hits_(MetricsRegistry::instance().counter(DEDUP_HITS, {{"kind", "configuration"}})),
+      string_hits_(MetricsRegistry::instance().counter(DEDUP_HITS, {{"kind", "string"}}))
+{
+}
+
+template <typename T>
+void ContentStore::prune(Table<T>& table)
+{
+    if (table.entries.size() < table.prune_at)
+        return;
+
+    for (auto it = table.entries.begin(); it != table.entries.end();)
+    {
+        if (it->second.expired())
+            it = table.entries.erase(it);
+        else
+            ++it;
+    }
+    table.prune_at = std::max(MIN_PRUNE_SIZE, table.entries.size() * 2);
+}
+
+template <typename T, typename Equal>
+std::shared_ptr<const T> ContentStore::intern(Table<T>& table, uint64_t hash, T value, const Equal& equal,
+                                              Counter& hits)
+{
+    const auto [first, last] = table.entries.equal_range(hash);
+    for (auto it = first; it != last; ++it)
+    {
+        if (auto existing = it->second.lock(); existing && equal(*existing, value))
+        {
+            hits.increment();
+            return existing;
+        }
+    }
+
+    prune(table);
+    auto instance = std::make_shared<const T>(std::move(value));
+    table.entries.emplace(hash, instance);
+    return instance;
+}
+
+std::shared_ptr<const ContentStore::Parameters> ContentStore::internParameters(Parameters parameters)
+{
+    std::lock_guard lock(mutex_);
+    // Parameter sets that differ still share their long strings
+    for (auto& [key, value] : parameters) value = internValueLocked(std::move(value));
+
+    const uint64_t hash = hashParameters(parameters);
+    return intern(parameters_, hash, std::move(parameters), std::equal_to<Parameters>(), parameter_hits_);
+}
+
+std::shared_ptr<const ContentStore::Configuration> ContentStore::internConfiguration(Configuration configuration)
+{
+    std::string encoded;
+    try
+    {
+        BinaryWriter(encoded).writeConfiguration(configuration);
+    }
+    catch (const std::runtime_error&)
+    {
+        return std::make_shared<const Configuration>(std::move(configuration));
+    }
+
+    // Variants have no equality, so candidates are compared by their encoding
+    const auto same_encoding = [&encoded](const Configuration& existing, const Configuration&)
+    {
+        std::string existing_encoded;
+        BinaryWriter(existing_encoded).writeConfiguration(existing);
+        return existing_encoded == encoded;
+    };
+
+    std::lock_guard lock(mutex_);
+    return intern(configurations_, fnv1a64(encoded), std::move(configuration), same_encoding, configuration_hits_);
+}
+
+ConfigValue ContentStore::internValue(ConfigValue value)
+{
+    if (value.useCount() == 0)
+        return value;
+
+    std::lock_guard lock(mutex_);
+    return internValueLocked(std::move(value));
+}
+
+ConfigValue ContentStore::internValueLocked(ConfigValue value)
+{
+    if (value.useCount() == 0)
+        return value;
+
+    if (const auto it = strings_.find(value.asString()); it != strings_.end())
+    {
+        string_hits_.increment();
+        return it->second;
+    }
+
+    if (strings_.size() >= strings_prune_at_)
+    {
+        // Strings only the store still references are no longer used by any configuration
+        std::erase_if(strings_, [](const auto& entry) { return entry.second.useCount() == 1; });
+        strings_prune_at_ = std::max(MIN_PRUNE_SIZE, strings_.size() * 2);
+    }
+
+    if (seal_above_ > 0 && value.asString().size() > seal_above_ && value.descriptor() < 0)
+    {
+        try
+        {
+            value = ConfigValue::sealed(value.asString());
+        }
+        catch (const std::runtime_error&)
+        {
+            // Out of descriptors or memfds unavailable: the value stays on the heap
+        }
+    }
+
+    const std::string_view key = value.asString();
+    strings_.emplace(key, value);
+    return value;
+}
+
+void ContentStore::setSealAbove(std::size_t limit)
+{
+    std::lock_guard lock(mutex_);
+    seal_above_ = limit;
+}
+
+std::size_t ContentStore::parameterSets() const
+{
+    std::lock_guard lock(mutex_);
+    return std::count_if(parameters_.entries.begin(), parameters_.entries.end(),
+                         [](const auto& entry) { return !entry.second.expired(); });
+}
+
+std::size_t ContentStore::strings() const
+{
+    std::lock_guard lock(mutex_);
+    return strings_.size();
+}
\ No newline at end of file
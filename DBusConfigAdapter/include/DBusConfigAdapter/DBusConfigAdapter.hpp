@@ -3,15 +3,52 @@
 #include <sdbus-c++/IObject.h>
 #include <sdbus-c++/sdbus-c++.h>
 
+#include <ChangeJournal/ChangeJournal.hpp>
+#include <ConfigSnapshot/ConfigSnapshot.hpp>
+#include <DerivedKeys/DerivedKeys.hpp>
+#include <DispatchScheduler/DispatchScheduler.hpp>
 #include <IConfigStorage/IConfigStorage.hpp>
+#include <Metrics/Metrics.hpp>
+#include <RateLimiter/RateLimiter.hpp>
+#include <TimerService/TimerService.hpp>
+#include <TimerWheel/TimerWheel.hpp>
+#include <chrono>
+#include <atomic>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 static const std::string INTERFACE_NAME = "com.system.configurationManager.Application.Configuration";
 static const std::string PATH = "/com/system/configurationManager/Application/";
 static const std::string ERROR_CREATE = "Failed to create D-Bus object for path: ";
 static const std::string CHANGE = "ChangeConfiguration";
+static const std::string CHANGE_WITH_TTL = "ChangeConfigurationWithTTL";
 static const std::string GET = "GetConfiguration";
 static const std::string SIGNAL = "configurationChanged";
+static const std::string KEY_SIGNAL = "configurationKeyChanged";
+static const std::string SNAPSHOT_FD = "GetSnapshotFd";
+static const std::string CHANGES_SINCE = "GetChangesSince";
+static const std::string WAIT_FOR_CHANGE = "WaitForChange";
+static const std::string ERROR_NOT_SUPPORTED = "com.system.configurationManager.Error.NotSupported";
+static const std::string ERROR_PROPERTY_CHANGED = "com.system.configurationManager.Error.PropertyChanged";
+static const std::string PROPERTY_GET = "Get";
+static const std::string PROPERTY_SET = "Set";
+static constexpr std::size_t DEFAULT_INVALIDATE_ABOVE = 256;
+static constexpr uint32_t MAX_WAIT_TIMEOUT_MS = 5 * 60 * 1000;
+
+/**
+ * @struct PropertiesPolicy
+ * @brief How the keys of an application are exposed through org.freedesktop.DBus.Properties
+ */
+struct PropertiesPolicy
+{
+    bool enabled = false;  ///< Expose every key with a valid D-Bus member name as a property
+    std::size_t invalidate_above = DEFAULT_INVALIDATE_ABOVE;  ///< Longer strings are announced invalidation-only
+};
 
 /**
  * @class DBusConfigAdapter
@@ -20,11 +57,64 @@ static const std::string SIGNAL = "configurationChanged";
  * Provides D-Bus interface for remote configuration management:
  * - Methods for getting/changing configuration
  * - Signals for configuration change notifications
+ *
+ * The interface lives on the bus connection and, optionally, on any number of
+ * direct peer connections; signals are emitted on all of them.
+ *
+ * The marshalled `a{sv}` body of the configuration is cached and rebuilt
+ * once per change; GetConfiguration replies and configurationChanged signals
+ * copy it instead of marshalling the configuration again.
+ *
+ * Strings the storage keeps in sealed memfds (see ContentStore::setSealAbove())
+ * are sent as `h` descriptors in GetConfiguration replies and in both change
+ * signals; receivers map them read-only with ConfigValue::fromVariant().
+ *
+ * Every change advances the application's version; clients that missed
+ * signals ask GetChangesSince() for the keys changed after the version they
+ * saw instead of re-reading everything. Changes are appended to an optional
+ * ChangeJournal so versions and runtime changes survive a restart.
+ *
+ * ChangeConfigurationWithTTL() makes a temporary override that a TimerWheel
+ * reverts when it expires, with the usual change signals. Temporary overrides
+ * are journaled like layer updates, so they are not replayed after a restart.
+ *
+ * Keys declared with a `Derived:<key>` expression (see DerivedKeys) are
+ * computed by the adapter. A change recomputes only the derived keys that
+ * depend on it, journals them under the same version and signals them along
+ * with the changed key; clients cannot set derived keys themselves.
+ *
+ * Clients that cannot subscribe to signals long-poll with WaitForChange():
+ * a call for the current version is parked without a reply and without
+ * holding a thread, and answered like GetChangesSince() by the next change or
+ * by a TimerService timer when its timeout expires.
+ *
+ * With a DispatchScheduler, GetConfiguration and ChangeConfiguration calls and
+ * the signals caused by changes are queued by class and run on the
+ * scheduler's worker; a full queue answers ERROR_BUSY.
+ *
+ * Reads and writes are rate limited per sender (D-Bus unique name) before
+ * they are queued or touch the storage; rejected calls get ERROR_RATE_LIMITED.
+ * GetChangesSince, GetSnapshotFd and Properties.Get/GetAll count as reads
+ * too, a GetAll once however many keys it returns.
+ *
+ * With a PropertiesPolicy, keys are also properties of the interface on the
+ * bus object, so generic tooling can use Properties.Get/GetAll/Set. Changes
+ * emit PropertiesChanged with the new values, except for strings longer than
+ * the policy's limit, which are only listed as invalidated and transferred to
+ * the clients that re-read them. Properties are registered on a separate
+ * object at the same path and re-registered when keys are added or change
+ * type, without touching the methods.
+ *
+ * Every call is counted and timed in the process-wide MetricsRegistry under
+ * the `app` and `method` labels.
  */
 class DBusConfigAdapter
 {
    public:
     using ConfigurationMap = std::map<std::string, sdbus::Variant>;
+    using ChangeListener = std::function<void(const std::string&, const std::string&, const sdbus::Variant&,
+                                              std::chrono::milliseconds)>;
+    using ExpiryHandler = std::function<void(const std::string&, const std::string&)>;
 
     /**
      * @brief Construct a new DBusConfigAdapter
@@ -33,37 +123,563 @@ class DBusConfigAdapter
      */
     DBusConfigAdapter(std::unique_ptr<IConfigStorage>, sdbus::IConnection&);
 
+    /**
+     * @brief Wait for the queued tasks of this adapter
+     */
+    ~DBusConfigAdapter();
+
     /**
      * @brief Register D-Bus interface and methods
      *
      * Registers the following D-Bus API:
      * - ChangeConfiguration(key: string, value: variant) → void
+     * - ChangeConfigurationWithTTL(key: string, value: variant, ttl_ms: uint32) → void,
+     *   only for keys that have a value to return to
      * - GetConfiguration() → dict<string,variant>
+     * - GetSnapshotFd() → unix_fd (read-only shared snapshot, see SnapshotReader)
+     * - GetChangesSince(version: uint64) → (version: uint64, complete: bool, changes: dict<string,variant>)
+     * - WaitForChange(version: uint64, timeout_ms: uint32) → same as GetChangesSince, once the version
+     *   is past `version` or the timeout (at most MAX_WAIT_TIMEOUT_MS) expired
      * - configurationChanged(dict<string,variant>) signal
+     * - configurationKeyChanged(key: string, value: variant, version: uint64) signal, one per changed
+     *   key; subscribers match on `arg0='<key>'` so the bus daemon drops keys they do not watch
+     * - one read-write property per key, if enabled with setPropertiesPolicy()
      */
     void registerDBusInterface();
 
+    /**
+     * @brief Publish every configuration change into a shared-memory snapshot
+     *
+     * Clients fetch the segment once with GetSnapshotFd() and then read the
+     * configuration without IPC, using change signals only as wakeups.
+     */
+    void enableSharedSnapshot();
+
+    /**
+     * @brief Run calls and signals through weighted queues instead of the dispatch thread
+     *
+     * Must be set before the interface is registered.
+     * @param scheduler Scheduler shared by all adapters, must outlive the adapter
+     */
+    void setScheduler(DispatchScheduler*);
+
+    /**
+     * @brief Time out parked WaitForChange calls with a shared timer thread
+     *
+     * Without timers WaitForChange answers right away, like GetChangesSince.
+     * Must be set before the interface is registered.
+     * @param timers Timer service shared by all adapters, must outlive the adapter
+     */
+    void setTimerService(TimerService*);
+
+    /**
+     * @brief Expire temporary overrides with a shared timer wheel
+     *
+     * Without a wheel ChangeConfigurationWithTTL answers ERROR_NOT_SUPPORTED.
+     * Must be set before the interface is registered.
+     * @param wheel Wheel shared by all adapters, must outlive the adapter
+     */
+    void setExpiryWheel(TimerWheel*);
+
+    /**
+     * @brief Let the owner revert expired temporary overrides
+     *
+     * The handler finds the value underneath and applies it with applyChanges().
+     * Without a handler the adapter restores the value the first temporary
+     * override of the key replaced. Must be set before the interface is registered.
+     * @param handler Receives the application name and the expired key
+     */
+    void setExpiryHandler(ExpiryHandler);
+
+    /**
+     * @brief Share the lock that serialises writes with the owner
+     *
+     * Every write of the adapter (method calls, property sets, expiries and
+     * applyChanges()) holds the lock from the change listener to queueing its
+     * signals, so storage, journal and signals see the writes in one order.
+     * An owner that changes its own state before calling applyChanges(), such
+     * as configuration layers, holds the same lock around both. Without a
+     * shared lock the adapter uses its own. Must be set before the interface
+     * is registered.
+     * @param mutex Lock shared with the owner, must outlive the adapter
+     */
+    void setWriteMutex(std::recursive_mutex*);
+
+    /**
+     * @brief Get the number of temporary overrides waiting to expire
+     * @return Keys with a pending expiry
+     */
+    [[nodiscard]] std::size_t temporaryOverrides() const;
+
+    /**
+     * @brief Get the number of parked WaitForChange calls
+     * @return Calls waiting for a change or their timeout
+     */
+    [[nodiscard]] std::size_t parkedWaiters() const;
+
+    /**
+     * @brief Limit GetConfiguration calls of each sender
+     * @param limit Token bucket parameters, a zero rate disables the limit
+     */
+    void setReadRateLimit(RateLimit);
+
+    /**
+     * @brief Limit ChangeConfiguration calls of each sender
+     * @param limit Token bucket parameters, a zero rate disables the limit
+     */
+    void setWriteRateLimit(RateLimit);
+
+    /**
+     * @brief Expose keys as D-Bus properties, or stop doing so
+     *
+     * May be changed at any time; the properties are re-registered.
+     * @param policy Whether keys are properties and which values are announced invalidation-only
+     */
+    void setPropertiesPolicy(PropertiesPolicy);
+
+    /**
+     * @brief Get the current properties policy
+     * @return Policy
+     */
+    [[nodiscard]] PropertiesPolicy propertiesPolicy() const;
+
+    /**
+     * @brief Expose the interface on an additional peer-to-peer connection
+     *
+     * Does nothing if the connection is already attached.
+     * @param connection Direct connection to a single client
+     */
+    void attachConnection(sdbus::IConnection&);
+
+    /**
+     * @brief Remove the interface from a peer connection
+     * @param connection Connection previously passed to attachConnection()
+     */
+    void detachConnection(sdbus::IConnection&);
+
+    /**
+     * @brief Observe changes made through ChangeConfiguration
+     *
+     * The listener runs before the storage is updated, on the thread
+     * dispatching the call. Must be set before the interface is registered.
+     * @param listener Receives the application name, key, new value and the TTL of
+     *                 temporary overrides (zero for permanent changes)
+     */
+    void setChangeListener(ChangeListener);
+
+    /**
+     * @brief Apply changes computed outside the D-Bus interface (e.g. by a layer update)
+     *
+     * Updates the storage and the derived keys depending on it, and emits one
+     * configurationChanged signal plus a configurationKeyChanged signal per
+     * key. Changes of derived keys are ignored. The change listener is not called.
+     * @param changes Changed keys with their new values
+     * @param kind How the changes are journaled: Override for runtime changes, Derived for layer updates
+     */
+    void applyChanges(const ConfigurationMap&, JournalRecord::Kind = JournalRecord::Kind::Derived);
+
+    /**
+     * @brief Append every future change to a journal
+     * @param journal Journal shared by all adapters, must outlive the adapter
+     */
+    void setJournal(ChangeJournal*);
+
+    /**
+     * @brief Restore the versions replayed from the journal
+     *
+     * Replayed runtime changes must already be part of the storage contents.
+     * @param history Replayed history of this application
+     */
+    void restoreHistory(const ApplicationHistory&);
+
+    /**
+     * @brief Get the current configuration version
+     * @return Number of changes applied since the history began
+     */
+    [[nodiscard]] uint64_t version() const;
+
+    /**
+     * @brief Get the current configuration without going through D-Bus
+     * @return Current configuration map
+     */
+    [[nodiscard]] ConfigurationMap getConfiguration() const { return storage_->getAllParameters(); }
+
+    /**
+     * @brief Get the application name of the adapted storage
+     * @return Application name
+     */
+    [[nodiscard]] std::string getAppName() const { return storage_->getAppName(); }
+
+    /**
+     * @brief Append a storage's parameters to a message as an `a{sv}` dictionary
+     *
+     * Marshals straight from the storage, so no copy of the keys or values is
+     * made on the way to the wire.
+     * @param message Message to append to
+     * @param storage Storage to read
+     */
+    static void marshalConfiguration(sdbus::Message&, const IConfigStorage&);
+
+    /**
+     * @brief Fill a GetConfiguration reply
+     *
+     * Everything onGetConfiguration() does between creating and sending the
+     * reply: the cached body is copied into it, nothing is marshalled again.
+     * @param reply Reply to fill
+     */
+    void appendConfigurationReply(sdbus::Message&);
+
    private:
+    /**
+     * @struct MethodMetrics
+     * @brief Per-method instruments resolved once at construction
+     */
+    struct MethodMetrics
+    {
+        Counter& calls;
+        Counter& errors;
+        Counter& rate_limited;
+        LatencyHistogram& latency;
+    };
+
+    /**
+     * @brief Resolve the instruments of one D-Bus method
+     * @param app_name Application label
+     * @param method Method label
+     * @return Method instruments
+     */
+    static MethodMetrics makeMethodMetrics(const std::string&, const std::string&);
+
+    /**
+     * @brief Register methods and signals on one D-Bus object
+     * @param object Object to register the interface on
+     */
+    void registerInterfaceOn(sdbus::IObject&);
+
+    /**
+     * @brief Check the sender's rate limit, then run a method handler now or queue it on the scheduler
+     *
+     * Calls over the limit that expect no reply are dropped silently.
+     * @param type Queue of the call, also selects the read or write limit
+     * @param metrics Instruments of the method, counting rejected calls
+     * @param call Incoming call
+     * @param handler Handler to run
+     * @throws sdbus::Error ERROR_RATE_LIMITED if the sender is over its limit, ERROR_BUSY if the queue is full
+     */
+    void dispatch(DispatchClass, MethodMetrics&, sdbus::MethodCall, void (DBusConfigAdapter::*)(sdbus::MethodCall));
+
+    /**
+     * @brief Check the read limit of a call answered directly on the event loop thread, and count it
+     * @param object Object receiving the call
+     * @param metrics Instruments of the method
+     * @throws sdbus::Error ERROR_RATE_LIMITED if the sender is over its limit
+     */
+    void admitRead(const sdbus::IObject&, MethodMetrics&);
+
     /**
      * @brief Handle configuration change request
+     *
+     * Replies as soon as the change is stored, then emits the signals; calls
+     * flagged as not expecting a reply get none, and their failures are logged.
+     * @param call Incoming ChangeConfiguration(key, value) call
+     * @throws sdbus::Error on failure
+     */
+    void onChangeConfiguration(sdbus::MethodCall);
+
+    /**
+     * @brief Handle a temporary configuration change
+     *
+     * Behaves like ChangeConfiguration, and arms the expiry of the override.
+     * @param call Incoming ChangeConfigurationWithTTL(key, value, ttl_ms) call
+     * @throws sdbus::Error on failure
+     */
+    void onChangeConfigurationWithTTL(sdbus::MethodCall);
+
+    /**
+     * @brief Apply a change made by a client: notify the listener, update the storage, journal and publish
+     *
+     * A permanent change cancels the pending expiry of the key. The change and
+     * its derived keys are added to the pending signals under the write lock,
+     * scheduleChangeSignals() emits them.
+     * @param key Parameter name
+     * @param value New parameter value
+     * @param ttl Lifetime of a temporary override, zero for permanent changes
+     * @throw std::runtime_error If the key is derived, the declaration is invalid, or the listener or the
+     *        storage rejects the value
+     */
+    void changeParameter(const std::string&, const sdbus::Variant&,
+                         std::chrono::milliseconds = std::chrono::milliseconds::zero());
+
+    /**
+     * @brief Forget the pending expiry of a key
+     * @param key Parameter name
+     */
+    void cancelExpiry(const std::string&);
+
+    /**
+     * @brief Reject a change the derived keys do not allow
      * @param key Parameter name
      * @param value New parameter value
+     * @throw std::runtime_error If the key is derived or declares an invalid derived key
+     */
+    void checkDerivedChange(const std::string&, const sdbus::Variant&) const;
+
+    /**
+     * @brief Update the declarations and recompute the derived keys affected by stored changes
+     * @param keys Changed parameter names, already stored
+     * @return Derived keys whose value changed, already stored
+     */
+    ConfigurationMap updateDerivedKeys(const std::vector<std::string>&);
+
+    /**
+     * @brief Revert an expired temporary override, called on the timer thread
+     * @param key Parameter name
+     * @param generation Generation of the override the timer was armed for
+     */
+    void expireOverride(const std::string&, uint64_t);
+
+    /**
+     * @brief Handle Properties.Set of a key
+     *
+     * Runs on the connection's event loop thread, not on the dispatch queues,
+     * but goes through the write rate limit and the same path as ChangeConfiguration.
+     * @param key Parameter name
+     * @param signature Registered signature of the property
+     * @param call Call positioned at the new value
      * @throws sdbus::Error on failure
      */
-    void onChangeConfiguration(const std::string&, const sdbus::Variant&);
+    void onSetProperty(const std::string&, char, sdbus::PropertySetCall&);
 
     /**
-     * @brief Handle configuration read request
-     * @return Current configuration map
+     * @brief Register the properties again if keys, types or notification modes changed
+     *
+     * Not called from property callbacks, whose object would be destroyed.
+     */
+    void refreshProperties();
+
+    /**
+     * @brief Emit PropertiesChanged for the changed keys that are properties
+     * @param keys Changed parameter names
+     */
+    void emitPropertiesChanged(const std::vector<std::string>&);
+
+    /**
+     * @brief Handle configuration read request, replying with the cached configuration body
+     * @param call Incoming GetConfiguration call
+     */
+    void onGetConfiguration(sdbus::MethodCall);
+
+    /**
+     * @brief Handle a long-poll request, parking it while the client is up to date
+     *
+     * Counts against the read rate limit.
+     * @param call Incoming WaitForChange(version, timeout_ms) call
+     */
+    void onWaitForChange(sdbus::MethodCall);
+
+    /**
+     * @brief Answer every parked WaitForChange call, called after each change
+     */
+    void wakeWaiters();
+
+    /**
+     * @brief Answer a parked WaitForChange call whose timeout expired
+     * @param id Waiter identifier
+     */
+    void expireWaiter(uint64_t);
+
+    /**
+     * @brief Reply to a WaitForChange call with the changes since a version
+     * @param call Call to answer
+     * @param since Version the client has seen
+     */
+    void replyChangesSince(sdbus::MethodCall&, uint64_t);
+
+    /**
+     * @brief Handle shared snapshot request
+     * @return Read-only descriptor of the snapshot segment
+     * @throws sdbus::Error if shared snapshots are disabled
+     */
+    sdbus::UnixFd onGetSnapshotFd();
+
+    /**
+     * @brief Handle a catch-up request
+     * @param since Last version the client has seen
+     * @return Current version, whether the changes are complete deltas, and the changed keys;
+     *         when deltas are not available (too old or unknown version) the whole configuration
+     *         is returned with complete = false
+     */
+    std::tuple<uint64_t, bool, ConfigurationMap> onGetChangesSince(uint64_t);
+
+    /**
+     * @brief Advance the version for changed keys and journal them
+     * @param kind Journal record kind
+     * @param changes Changed keys with their new values
+     * @param derived Derived keys recomputed by the changes, journaled as Derived under the same version
+     * @return uint64_t Version the changes were recorded under
+     */
+    uint64_t recordChanges(JournalRecord::Kind, const ConfigurationMap&, const ConfigurationMap& = {});
+
+    /**
+     * @brief Re-marshal the configuration into the cached body, called once per change
+     */
+    void rebuildCachedConfiguration();
+
+    /**
+     * @brief Append the cached configuration body to a message
+     * @param message Reply or signal to fill
+     */
+    void appendCachedConfiguration(sdbus::Message&);
+
+    /**
+     * @brief Refresh the cached body, size and shared snapshot after a change
+     */
+    void publishConfiguration();
+
+    /**
+     * @brief Emit the pending signals of changes made through ChangeConfiguration, queued when a scheduler is set
+     *
+     * Signals wait in pending_signals_, coalesced per key, until one flush
+     * task emits them; configurationChanged carries the latest configuration,
+     * so it is emitted once per flush. When the signal queue is full the
+     * flush runs right away: no older flush of the adapter is queued then, so
+     * signals still leave in version order.
+     */
+    void scheduleChangeSignals();
+
+    /**
+     * @brief Add a change to the pending signals, replacing an older pending change of the key
+     * @param key Changed parameter name
+     * @param value New parameter value
+     * @param version Version the change was recorded under
+     */
+    void addPendingSignal(const std::string&, const ConfigValue&, uint64_t);
+
+    /**
+     * @brief Emit every pending signal, key signals oldest version first
      */
-    ConfigurationMap onGetConfiguration();
+    void flushChangeSignals();
 
     /**
-     * @brief Emit configuration changed signal
+     * @brief Get a changed value as the storage keeps it, so large strings are signalled as descriptors
+     * @param key Changed parameter name
+     * @param value New value, used if the storage no longer has the key
+     * @return Stored value
+     */
+    [[nodiscard]] ConfigValue storedValue(const std::string&, const sdbus::Variant&) const;
+
+    /**
+     * @brief Emit configuration changed signal with the cached configuration
      */
     void emitConfigurationChangedSignal();
 
+    /**
+     * @brief Emit the per-key change signal
+     * @param key Changed parameter name (signal arg0)
+     * @param value New parameter value, sealed strings are sent as `h`
+     * @param version Version the change was recorded under
+     */
+    void emitKeyChangedSignal(const std::string&, const ConfigValue&, uint64_t);
+
+    /**
+     * @brief Create, fill and emit a signal on the bus object and every peer object
+     * @param name Signal name
+     * @param fill Appends the signal arguments
+     */
+    void emitOnAllObjects(const std::string&, const std::function<void(sdbus::Signal&)>&);
+
+    /**
+     * @struct Waiter
+     * @brief WaitForChange call parked until a change or its timeout
+     */
+    struct Waiter
+    {
+        sdbus::MethodCall call;
+        uint64_t since;
+        TimerService::TimerId timer;
+        TimerService::Clock::time_point parked;
+    };
+
+    /**
+     * @struct PendingSignals
+     * @brief Change signals not emitted yet, only the latest change of each key
+     */
+    struct PendingSignals
+    {
+        bool configuration = false;  ///< configurationChanged is due
+        bool flush_queued = false;   ///< A flush task is waiting on the scheduler
+        std::map<std::string, std::pair<ConfigValue, uint64_t>> keys;  ///< Value and version per key
+    };
+
+    /**
+     * @struct TemporaryOverride
+     * @brief Pending expiry of a key
+     */
+    struct TemporaryOverride
+    {
+        TimerWheel::TimerId timer;
+        uint64_t generation;      ///< Tells a stale expiry from the current one
+        sdbus::Variant fallback;  ///< Value restored without an expiry handler
+    };
+
+    using PropertyLayout = std::map<std::string, std::pair<char, bool>>;  ///< Key → signature, invalidation-only
+
     std::unique_ptr<IConfigStorage> storage_;
+    sdbus::IConnection& connection_;
     std::unique_ptr<sdbus::IObject> dbus_object_;
     std::string interface_name_ = INTERFACE_NAME;
+    std::string object_path_;
+
+    std::mutex peers_mutex_;
+    std::vector<std::pair<sdbus::IConnection*, std::unique_ptr<sdbus::IObject>>> peer_objects_;
+
+    MethodMetrics change_metrics_;
+    MethodMetrics get_metrics_;
+    MethodMetrics set_metrics_;
+    MethodMetrics wait_metrics_;
+    MethodMetrics ttl_metrics_;
+    MethodMetrics changes_metrics_;
+    MethodMetrics snapshot_metrics_;
+    MethodMetrics property_get_metrics_;
+    Counter& signals_emitted_;
+    Counter& bytes_marshalled_;
+    std::atomic<std::size_t> configuration_size_{0};
+    std::mutex cache_mutex_;
+    sdbus::PlainMessage cached_configuration_;
+    std::unique_ptr<SnapshotWriter> snapshot_;
+    ChangeListener change_listener_;
+    DispatchScheduler* scheduler_ = nullptr;
+    RateLimiter read_limiter_;
+    RateLimiter write_limiter_;
+    std::recursive_mutex own_write_mutex_;
+    std::recursive_mutex* write_mutex_ = &own_write_mutex_;
+    std::mutex pending_signals_mutex_;
+    PendingSignals pending_signals_;
+    std::mutex emit_mutex_;
+
+    TimerWheel* expirations_ = nullptr;
+    ExpiryHandler expiry_handler_;
+    mutable std::mutex overrides_mutex_;
+    std::map<std::string, TemporaryOverride> temporary_overrides_;
+    uint64_t override_generation_ = 0;
+
+    mutable std::mutex derived_mutex_;
+    DerivedKeys derived_;
+
+    TimerService* timers_ = nullptr;
+    mutable std::mutex waiters_mutex_;
+    std::unordered_map<uint64_t, Waiter> waiters_;
+    uint64_t next_waiter_ = 0;
+
+    mutable std::mutex properties_mutex_;
+    PropertiesPolicy properties_policy_;
+    bool interface_registered_ = false;
+    PropertyLayout property_layout_;
+    std::unique_ptr<sdbus::IObject> properties_object_;
+
+    mutable std::mutex history_mutex_;
+    uint64_t version_ = 0;
+    uint64_t base_version_ = 0;
+    std::map<std::string, uint64_t> key_versions_;
+    ChangeJournal* journal_ = nullptr;
 };
\ No newline at end of file
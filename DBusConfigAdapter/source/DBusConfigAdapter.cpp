@@ -1,54 +1,1003 @@
 #include "DBusConfigAdapter/DBusConfigAdapter.hpp"
 
-#include <iostream>
+#include <Logger/Logger.hpp>
+#include <algorithm>
+#include <optional>
+#include <stdexcept>
+
+static constexpr std::size_t align(std::size_t offset, std::size_t alignment)
+{
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+/**
+ * @brief Compute the wire size of an `a{sv}` body following the D-Bus marshalling rules
+ *
+ * Walks the stored values as marshalConfiguration() writes them, so sealed
+ * strings count as a `h` descriptor and nothing is copied. Only called when
+ * the configuration changes; the result is reused by every read until the
+ * next change.
+ */
+static std::size_t marshalledSize(const IConfigStorage& storage)
+{
+    std::size_t size = 4;
+    storage.forEachParameter(
+        [&size](const std::string& key, const ConfigValue& value)
+        {
+            size = align(size, 8) + 4 + key.size() + 1;
+
+            const char signature = value.descriptor() >= 0 ? 'h' : value.signature();
+            // Variant signature: length byte, one type character, terminator
+            size += 3;
+
+            switch (signature)
+            {
+                case 'y':
+                    size += 1;
+                    break;
+                case 'n':
+                case 'q':
+                    size = align(size, 2) + 2;
+                    break;
+                case 'b':
+                case 'i':
+                case 'u':
+                case 'h':
+                    size = align(size, 4) + 4;
+                    break;
+                case 'x':
+                case 't':
+                case 'd':
+                    size = align(size, 8) + 8;
+                    break;
+                case 's':
+                    size = align(size, 4) + 4 + value.asString().size() + 1;
+                    break;
+                default:
+                    break;
+            }
+        });
+    return size;
+}
+
+/**
+ * @brief Check whether a key can be used as a D-Bus property name
+ */
+static bool isMemberName(const std::string& key)
+{
+    if (key.empty() || key.size() > 255 || (key.front() >= '0' && key.front() <= '9'))
+        return false;
+    return std::all_of(key.begin(), key.end(),
+                       [](char c) { return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') ||
+                                           (c >= '0' && c <= '9') || c == '_'; });
+}
+
+DBusConfigAdapter::MethodMetrics DBusConfigAdapter::makeMethodMetrics(const std::string& app_name,
+                                                                      const std::string& method)
+{
+    auto& registry = MetricsRegistry::instance();
+    const MetricsRegistry::Labels labels{{"app", app_name}, {"method", method}};
+    return {registry.counter("config_calls_total", labels), registry.counter("config_call_errors_total", labels),
+            registry.counter("config_rate_limited_total", labels),
+            registry.histogram("config_call_duration_seconds", labels)};
+}
 
 DBusConfigAdapter::DBusConfigAdapter(std::unique_ptr<IConfigStorage> storage, sdbus::IConnection& connection)
-    : storage_(std::move(storage))
+    : storage_(std::move(storage)),
+      connection_(connection),
+      object_path_(PATH + storage_->getAppName()),
+      change_metrics_(makeMethodMetrics(storage_->getAppName(), CHANGE)),
+      get_metrics_(makeMethodMetrics(storage_->getAppName(), GET)),
+      set_metrics_(makeMethodMetrics(storage_->getAppName(), PROPERTY_SET)),
+      wait_metrics_(makeMethodMetrics(storage_->getAppName(), WAIT_FOR_CHANGE)),
+      ttl_metrics_(makeMethodMetrics(storage_->getAppName(), CHANGE_WITH_TTL)),
+      changes_metrics_(makeMethodMetrics(storage_->getAppName(), CHANGES_SINCE)),
+      snapshot_metrics_(makeMethodMetrics(storage_->getAppName(), SNAPSHOT_FD)),
+      property_get_metrics_(makeMethodMetrics(storage_->getAppName(), PROPERTY_GET)),
+      signals_emitted_(MetricsRegistry::instance().counter("config_signals_emitted_total",
+                                                           {{"app", storage_->getAppName()}})),
+      bytes_marshalled_(MetricsRegistry::instance().counter("config_marshalled_bytes_total",
+                                                            {{"app", storage_->getAppName()}}))
 {
-    const auto object_path = PATH + storage_->getAppName();
-    dbus_object_ = sdbus::createObject(connection, object_path);
+    dbus_object_ = sdbus::createObject(connection, object_path_);
     if (!dbus_object_)
-        throw std::runtime_error(ERROR_CREATE + object_path);
+        throw std::runtime_error(ERROR_CREATE + object_path_);
+
+    // Derived keys are computed from the loaded configuration without advancing the version
+    std::vector<std::string> declarations;
+    storage_->forEachParameter(
+        [&declarations](const std::string& key, const ConfigValue&)
+        {
+            if (DerivedKeys::declaredKey(key))
+                declarations.push_back(key);
+        });
+    updateDerivedKeys(declarations);
+
+    rebuildCachedConfiguration();
+}
+
+DBusConfigAdapter::~DBusConfigAdapter()
+{
+    if (scheduler_)
+        scheduler_->drain(this);
+
+    // Parked callers are not answered; their own call timeout reports the application as gone
+    std::unordered_map<uint64_t, Waiter> waiters;
+    {
+        std::lock_guard<std::mutex> lock(waiters_mutex_);
+        waiters.swap(waiters_);
+    }
+    for (const auto& [id, waiter] : waiters) timers_->cancel(waiter.timer);
+
+    std::map<std::string, TemporaryOverride> overrides;
+    {
+        std::lock_guard<std::mutex> lock(overrides_mutex_);
+        overrides.swap(temporary_overrides_);
+    }
+    for (const auto& [key, temporary] : overrides) expirations_->cancel(temporary.timer);
 }
 
 void DBusConfigAdapter::registerDBusInterface()
 {
-    dbus_object_->registerMethod(CHANGE)
+    registerInterfaceOn(*dbus_object_);
+    {
+        std::lock_guard<std::mutex> lock(properties_mutex_);
+        interface_registered_ = true;
+    }
+    refreshProperties();
+}
+
+void DBusConfigAdapter::enableSharedSnapshot()
+{
+    snapshot_ = std::make_unique<SnapshotWriter>(storage_->getAppName(), *storage_);
+}
+
+void DBusConfigAdapter::attachConnection(sdbus::IConnection& connection)
+{
+    {
+        std::lock_guard<std::mutex> lock(peers_mutex_);
+        if (std::any_of(peer_objects_.begin(), peer_objects_.end(),
+                        [&connection](const auto& peer) { return peer.first == &connection; }))
+            return;
+    }
+
+    auto object = sdbus::createObject(connection, object_path_);
+    if (!object)
+        throw std::runtime_error(ERROR_CREATE + object_path_);
+    registerInterfaceOn(*object);
+
+    std::lock_guard<std::mutex> lock(peers_mutex_);
+    peer_objects_.emplace_back(&connection, std::move(object));
+}
+
+void DBusConfigAdapter::detachConnection(sdbus::IConnection& connection)
+{
+    std::lock_guard<std::mutex> lock(peers_mutex_);
+    std::erase_if(peer_objects_, [&connection](const auto& peer) { return peer.first == &connection; });
+}
+
+void DBusConfigAdapter::setChangeListener(ChangeListener listener) { change_listener_ = std::move(listener); }
+
+void DBusConfigAdapter::setScheduler(DispatchScheduler* scheduler) { scheduler_ = scheduler; }
+
+void DBusConfigAdapter::setTimerService(TimerService* timers) { timers_ = timers; }
+
+void DBusConfigAdapter::setExpiryWheel(TimerWheel* wheel) { expirations_ = wheel; }
+
+void DBusConfigAdapter::setExpiryHandler(ExpiryHandler handler) { expiry_handler_ = std::move(handler); }
+
+void DBusConfigAdapter::setWriteMutex(std::recursive_mutex* mutex) { write_mutex_ = mutex; }
+
+std::size_t DBusConfigAdapter::temporaryOverrides() const
+{
+    std::lock_guard<std::mutex> lock(overrides_mutex_);
+    return temporary_overrides_.size();
+}
+
+std::size_t DBusConfigAdapter::parkedWaiters() const
+{
+    std::lock_guard<std::mutex> lock(waiters_mutex_);
+    return waiters_.size();
+}
+
+void DBusConfigAdapter::setReadRateLimit(RateLimit limit) { read_limiter_.setLimit(limit); }
+
+void DBusConfigAdapter::setWriteRateLimit(RateLimit limit) { write_limiter_.setLimit(limit); }
+
+void DBusConfigAdapter::setPropertiesPolicy(PropertiesPolicy policy)
+{
+    {
+        std::lock_guard<std::mutex> lock(properties_mutex_);
+        properties_policy_ = policy;
+    }
+    refreshProperties();
+}
+
+PropertiesPolicy DBusConfigAdapter::propertiesPolicy() const
+{
+    std::lock_guard<std::mutex> lock(properties_mutex_);
+    return properties_policy_;
+}
+
+void DBusConfigAdapter::applyChanges(const ConfigurationMap& changes, JournalRecord::Kind kind)
+{
+    std::lock_guard<std::recursive_mutex> writing(*write_mutex_);
+    ConfigurationMap accepted;
+    {
+        std::lock_guard<std::mutex> lock(derived_mutex_);
+        for (const auto& [key, value] : changes)
+        {
+            if (derived_.defines(key))
+                Logger::instance().warning("Ignored change of derived key ", storage_->getAppName(), ".", key);
+            else
+                accepted.emplace(key, value);
+        }
+    }
+    if (accepted.empty())
+        return;
+
+    std::vector<std::string> keys;
+    for (const auto& [key, value] : accepted)
+    {
+        storage_->setParameter(key, value);
+        keys.push_back(key);
+    }
+    const auto derived = updateDerivedKeys(keys);
+    const uint64_t version = recordChanges(kind, accepted, derived);
+    publishConfiguration();
+    refreshProperties();
+    // Through the pending signals, so that signals of earlier changes still waiting there leave first
+    for (const auto& [key, value] : accepted) addPendingSignal(key, storedValue(key, value), version);
+    for (const auto& [key, value] : derived) addPendingSignal(key, storedValue(key, value), version);
+    flushChangeSignals();
+}
+
+void DBusConfigAdapter::setJournal(ChangeJournal* journal)
+{
+    std::lock_guard<std::mutex> lock(history_mutex_);
+    journal_ = journal;
+}
+
+void DBusConfigAdapter::restoreHistory(const ApplicationHistory& history)
+{
+    std::lock_guard<std::mutex> lock(history_mutex_);
+    version_ = history.version;
+    base_version_ = history.base_version;
+    key_versions_ = history.key_versions;
+}
+
+uint64_t DBusConfigAdapter::version() const
+{
+    std::lock_guard<std::mutex> lock(history_mutex_);
+    return version_;
+}
+
+uint64_t DBusConfigAdapter::recordChanges(JournalRecord::Kind kind, const ConfigurationMap& changes,
+                                          const ConfigurationMap& derived)
+{
+    std::lock_guard<std::mutex> lock(history_mutex_);
+    ++version_;
+    auto record = [this](JournalRecord::Kind record_kind, const std::string& key, const sdbus::Variant& value)
+    {
+        key_versions_[key] = version_;
+        if (!journal_)
+            return;
+
+        try
+        {
+            journal_->append({record_kind, storage_->getAppName(), version_, key, value});
+        }
+        catch (const std::exception& e)
+        {
+            Logger::instance().error("Cannot journal change of ", storage_->getAppName(), ".", key, ": ", e.what());
+        }
+    };
+    for (const auto& [key, value] : changes) record(kind, key, value);
+    // Derived keys are recomputed on startup, so their records only restore the key versions
+    for (const auto& [key, value] : derived) record(JournalRecord::Kind::Derived, key, value);
+    return version_;
+}
+
+void DBusConfigAdapter::registerInterfaceOn(sdbus::IObject& object)
+{
+    // Raw handlers: the calls can be queued on the scheduler and replied to later
+    object.registerMethod(interface_name_, CHANGE, "sv", {"key", "value"}, "", {},
+                          [this](sdbus::MethodCall call)
+                          {
+                              this->dispatch(DispatchClass::Write, this->change_metrics_, std::move(call),
+                                             &DBusConfigAdapter::onChangeConfiguration);
+                          });
+
+    object.registerMethod(interface_name_, CHANGE_WITH_TTL, "svu", {"key", "value", "ttl_ms"}, "", {},
+                          [this](sdbus::MethodCall call)
+                          {
+                              this->dispatch(DispatchClass::Write, this->ttl_metrics_, std::move(call),
+                                             &DBusConfigAdapter::onChangeConfigurationWithTTL);
+                          });
+
+    object.registerMethod(interface_name_, GET, "", {}, "a{sv}", {"configuration"},
+                          [this](sdbus::MethodCall call)
+                          {
+                              this->dispatch(DispatchClass::Read, this->get_metrics_, std::move(call),
+                                             &DBusConfigAdapter::onGetConfiguration);
+                          });
+
+    object.registerMethod(interface_name_, WAIT_FOR_CHANGE, "tu", {"version", "timeout_ms"}, "tba{sv}",
+                          {"version", "complete", "changes"},
+                          [this](sdbus::MethodCall call)
+                          {
+                              this->dispatch(DispatchClass::Read, this->wait_metrics_, std::move(call),
+                                             &DBusConfigAdapter::onWaitForChange);
+                          });
+
+    object.registerMethod(SNAPSHOT_FD)
         .onInterface(interface_name_)
-        .withInputParamNames("key", "value")
-        .implementedAs([this](const std::string& key, const sdbus::Variant& value)
-                       { this->onChangeConfiguration(key, value); });
+        .withOutputParamNames("snapshot")
+        .implementedAs(
+            [this, &object]()
+            {
+                this->admitRead(object, this->snapshot_metrics_);
+                return this->onGetSnapshotFd();
+            });
 
-    dbus_object_->registerMethod(GET)
+    object.registerMethod(CHANGES_SINCE)
         .onInterface(interface_name_)
-        .withOutputParamNames("configuration")
-        .implementedAs([this]() -> std::map<std::string, sdbus::Variant> { return this->onGetConfiguration(); });
+        .withInputParamNames("version")
+        .withOutputParamNames("version", "complete", "changes")
+        .implementedAs(
+            [this, &object](uint64_t since)
+            {
+                // A stale version is answered with the whole configuration, as costly as GetConfiguration
+                this->admitRead(object, this->changes_metrics_);
+                return this->onGetChangesSince(since);
+            });
 
-    dbus_object_->registerSignal(SIGNAL)
+    object.registerSignal(SIGNAL)
         .onInterface(interface_name_)
         .withParameters<std::map<std::string, sdbus::Variant>>("configuration");
 
-    dbus_object_->finishRegistration();
+    object.registerSignal(KEY_SIGNAL)
+        .onInterface(interface_name_)
+        .withParameters<std::string, sdbus::Variant, uint64_t>("key", "value", "version");
+
+    object.finishRegistration();
+}
+
+void DBusConfigAdapter::dispatch(DispatchClass type, MethodMetrics& metrics, sdbus::MethodCall call,
+                                 void (DBusConfigAdapter::*handler)(sdbus::MethodCall))
+{
+    const bool is_read = type == DispatchClass::Read;
+    const char* sender = call.getSender();
+    if (!(is_read ? read_limiter_ : write_limiter_).tryAcquire(sender ? sender : ""))
+    {
+        metrics.rate_limited.increment();
+        if (call.doesntExpectReply())
+            return;
+        throw sdbus::Error(ERROR_RATE_LIMITED, "Too many calls, retry later");
+    }
+
+    if (!scheduler_)
+    {
+        (this->*handler)(std::move(call));
+        return;
+    }
+
+    const bool queued = scheduler_->submit(type, this,
+                                           [this, call, handler]()
+                                           {
+                                               try
+                                               {
+                                                   (this->*handler)(call);
+                                               }
+                                               catch (const sdbus::Error& e)
+                                               {
+                                                   if (!call.doesntExpectReply())
+                                                       call.createErrorReply(e).send();
+                                               }
+                                           });
+    if (!queued)
+        throw sdbus::Error(ERROR_BUSY, "Request queue is full, retry later");
+}
+
+void DBusConfigAdapter::admitRead(const sdbus::IObject& object, MethodMetrics& metrics)
+{
+    const auto* message = object.getCurrentlyProcessedMessage();
+    const char* sender = message ? message->getSender() : nullptr;
+    if (!read_limiter_.tryAcquire(sender ? sender : ""))
+    {
+        metrics.rate_limited.increment();
+        throw sdbus::Error(ERROR_RATE_LIMITED, "Too many calls, retry later");
+    }
+    metrics.calls.increment();
+}
+
+void DBusConfigAdapter::onChangeConfiguration(sdbus::MethodCall call)
+{
+    ScopedTimer timer(&change_metrics_.latency);
+    change_metrics_.calls.increment();
+
+    std::string key;
+    sdbus::Variant value;
+    try
+    {
+        call >> key >> value;
+        changeParameter(key, value);
+        // Before the reply, so that a client can read a new key as a property right away
+        refreshProperties();
+    }
+    catch (const std::exception& e)
+    {
+        change_metrics_.errors.increment();
+        if (call.doesntExpectReply())
+        {
+            Logger::instance().warning("Rejected change of ", storage_->getAppName(), ".", key, ": ", e.what());
+            return;
+        }
+        throw sdbus::Error("com.system.configurationManager.Error.InvalidArgs", e.what());
+    }
+
+    // Reply before the signals so that pipelined producers are not held back by signal emission
+    if (!call.doesntExpectReply())
+        call.createReply().send();
+    scheduleChangeSignals();
 }
 
-void DBusConfigAdapter::onChangeConfiguration(const std::string& key, const sdbus::Variant& value)
+void DBusConfigAdapter::onChangeConfigurationWithTTL(sdbus::MethodCall call)
 {
+    ScopedTimer timer(&ttl_metrics_.latency);
+    ttl_metrics_.calls.increment();
+    if (!expirations_)
+    {
+        ttl_metrics_.errors.increment();
+        throw sdbus::Error(ERROR_NOT_SUPPORTED, "Temporary overrides are disabled");
+    }
+
+    std::string key;
+    sdbus::Variant value;
+    uint32_t ttl_ms = 0;
+    TimerWheel::TimerId replaced_timer = 0;
     try
     {
-        storage_->setParameter(key, value);
-        emitConfigurationChangedSignal();
+        call >> key >> value >> ttl_ms;
+        if (ttl_ms == 0)
+            throw std::invalid_argument("TTL must be positive");
+
+        // Held while changing so that an older expiry of the key cannot revert this override halfway
+        std::lock_guard<std::mutex> lock(overrides_mutex_);
+        auto it = temporary_overrides_.find(key);
+        std::optional<ConfigValue> underneath;
+        if (it == temporary_overrides_.end())
+        {
+            underneath = storage_->getParameter(key);
+            if (!underneath)
+                throw std::invalid_argument("Key has no value to return to: " + key);
+        }
+
+        const auto ttl = std::chrono::milliseconds(ttl_ms);
+        changeParameter(key, value, ttl);
+
+        const uint64_t generation = ++override_generation_;
+        const auto expiry = expirations_->schedule(ttl, [this, key, generation] { expireOverride(key, generation); });
+        if (it == temporary_overrides_.end())
+            temporary_overrides_.emplace(key, TemporaryOverride{expiry, generation, underneath->toVariant()});
+        else
+        {
+            // The override of an override still returns to the value underneath the first one
+            replaced_timer = it->second.timer;
+            it->second.timer = expiry;
+            it->second.generation = generation;
+        }
+
+        refreshProperties();
     }
     catch (const std::exception& e)
     {
+        ttl_metrics_.errors.increment();
+        if (call.doesntExpectReply())
+        {
+            Logger::instance().warning("Rejected temporary change of ", storage_->getAppName(), ".", key, ": ",
+                                       e.what());
+            return;
+        }
         throw sdbus::Error("com.system.configurationManager.Error.InvalidArgs", e.what());
     }
+
+    // Outside the lock: the replaced expiry may be running and waiting for it
+    if (replaced_timer)
+        expirations_->cancel(replaced_timer);
+
+    if (!call.doesntExpectReply())
+        call.createReply().send();
+    scheduleChangeSignals();
+}
+
+void DBusConfigAdapter::changeParameter(const std::string& key, const sdbus::Variant& value,
+                                        std::chrono::milliseconds ttl)
+{
+    checkDerivedChange(key, value);
+    const bool temporary = ttl > std::chrono::milliseconds::zero();
+    // Before the write lock: cancelling waits for a running expiry, which takes the lock
+    if (!temporary)
+        cancelExpiry(key);
+
+    std::lock_guard<std::recursive_mutex> writing(*write_mutex_);
+    if (change_listener_)
+        change_listener_(storage_->getAppName(), key, value, ttl);
+    storage_->setParameter(key, value);
+    auto derived = updateDerivedKeys({key});
+    // Temporary overrides only advance the version, a restart drops them
+    const uint64_t version = recordChanges(temporary ? JournalRecord::Kind::Derived : JournalRecord::Kind::Override,
+                                           {{key, value}}, derived);
+    publishConfiguration();
+    addPendingSignal(key, storedValue(key, value), version);
+    for (const auto& [derived_key, derived_value] : derived)
+        addPendingSignal(derived_key, ConfigValue::fromVariant(derived_value), version);
 }
 
-DBusConfigAdapter::ConfigurationMap DBusConfigAdapter::onGetConfiguration() { return storage_->getAllParameters(); }
+void DBusConfigAdapter::checkDerivedChange(const std::string& key, const sdbus::Variant& value) const
+{
+    std::lock_guard<std::mutex> lock(derived_mutex_);
+    if (derived_.defines(key))
+        throw std::runtime_error(ERROR_DERIVED_KEY + key);
+
+    const auto name = DerivedKeys::declaredKey(key);
+    if (!name)
+        return;
+    if (value.peekValueType() != "s")
+        throw std::runtime_error(ERROR_EXPRESSION + "the declaration of " + *name + " is not a string");
+    derived_.check(*name, value.get<std::string>());
+}
+
+DBusConfigAdapter::ConfigurationMap DBusConfigAdapter::updateDerivedKeys(const std::vector<std::string>& keys)
+{
+    std::lock_guard<std::mutex> lock(derived_mutex_);
+    std::vector<std::string> changed = keys;
+    for (const auto& key : keys)
+    {
+        const auto name = DerivedKeys::declaredKey(key);
+        if (!name)
+            continue;
+
+        // A removed or non-string declaration removes the derived key; its last value stays
+        const auto declaration = storage_->getParameter(key);
+        const bool valid = declaration && declaration->type() == ConfigValue::Type::String;
+        try
+        {
+            derived_.define(*name, valid ? std::string(declaration->asString()) : std::string());
+            changed.push_back(*name);
+        }
+        catch (const std::runtime_error& e)
+        {
+            Logger::instance().warning("Ignored declaration ", storage_->getAppName(), ".", key, ": ", e.what());
+        }
+    }
+    if (derived_.size() == 0)
+        return {};
+
+    std::vector<std::string> failed;
+    const auto values = derived_.recompute(
+        changed, [this](const std::string& key) { return storage_->getParameter(key); }, &failed);
+    for (const auto& key : failed)
+        Logger::instance().warning("Cannot compute derived key ", storage_->getAppName(), ".", key,
+                                   ", keeping its last value");
+
+    ConfigurationMap updates;
+    for (const auto& [key, value] : values)
+    {
+        if (storage_->getParameter(key) == value)
+            continue;
+        auto variant = value.toVariant();
+        storage_->setParameter(key, variant);
+        updates.emplace(key, std::move(variant));
+    }
+    return updates;
+}
+
+void DBusConfigAdapter::cancelExpiry(const std::string& key)
+{
+    TimerWheel::TimerId timer;
+    {
+        std::lock_guard<std::mutex> lock(overrides_mutex_);
+        const auto it = temporary_overrides_.find(key);
+        if (it == temporary_overrides_.end())
+            return;
+        timer = it->second.timer;
+        temporary_overrides_.erase(it);
+    }
+    expirations_->cancel(timer);
+}
+
+void DBusConfigAdapter::expireOverride(const std::string& key, uint64_t generation)
+{
+    // Reverted under the lock, so a new override of the key waits until the old one is gone
+    std::lock_guard<std::mutex> lock(overrides_mutex_);
+    const auto it = temporary_overrides_.find(key);
+    if (it == temporary_overrides_.end() || it->second.generation != generation)
+        return;
+
+    const sdbus::Variant fallback = std::move(it->second.fallback);
+    temporary_overrides_.erase(it);
+    Logger::instance().info("Temporary override of ", storage_->getAppName(), ".", key, " expired");
+
+    if (expiry_handler_)
+        expiry_handler_(storage_->getAppName(), key);
+    else
+        applyChanges({{key, fallback}});
+}
+
+void DBusConfigAdapter::onSetProperty(const std::string& key, char signature, sdbus::PropertySetCall& call)
+{
+    const char* sender = call.getSender();
+    if (!write_limiter_.tryAcquire(sender ? sender : ""))
+    {
+        set_metrics_.rate_limited.increment();
+        throw sdbus::Error(ERROR_RATE_LIMITED, "Too many calls, retry later");
+    }
+
+    ScopedTimer timer(&set_metrics_.latency);
+    set_metrics_.calls.increment();
+
+    sdbus::Variant value;
+    try
+    {
+        value = ConfigValue::readFrom(call, signature).toVariant();
+        changeParameter(key, value);
+    }
+    catch (const std::exception& e)
+    {
+        set_metrics_.errors.increment();
+        throw sdbus::Error("com.system.configurationManager.Error.InvalidArgs", e.what());
+    }
+    // Set cannot add keys or change their type, so the properties stay registered as they are
+    scheduleChangeSignals();
+}
+
+void DBusConfigAdapter::refreshProperties()
+{
+    std::lock_guard<std::mutex> lock(properties_mutex_);
+    if (!interface_registered_)
+        return;
+
+    PropertyLayout layout;
+    if (properties_policy_.enabled)
+    {
+        const std::size_t invalidate_above = properties_policy_.invalidate_above;
+        storage_->forEachParameter(
+            [&layout, invalidate_above](const std::string& key, const ConfigValue& value)
+            {
+                if (!isMemberName(key))
+                    return;
+                const bool large =
+                    value.type() == ConfigValue::Type::String && value.asString().size() > invalidate_above;
+                layout.emplace(key, std::make_pair(value.signature(), large));
+            });
+    }
+    if (layout == property_layout_ && (properties_object_ || layout.empty()))
+        return;
+
+    properties_object_.reset();
+    property_layout_ = std::move(layout);
+    if (property_layout_.empty())
+        return;
+
+    try
+    {
+        auto object = sdbus::createObject(connection_, object_path_);
+        const sdbus::IObject* properties = object.get();
+        for (const auto& [key, entry] : property_layout_)
+        {
+            const auto [signature, invalidate_only] = entry;
+            // GetAll reads every property in registration order; it is charged once, on the first one
+            const bool first = key == property_layout_.begin()->first;
+            sdbus::Flags flags;
+            flags.set(invalidate_only ? sdbus::Flags::EMITS_INVALIDATION_SIGNAL : sdbus::Flags::EMITS_CHANGE_SIGNAL);
+
+            object->registerProperty(
+                interface_name_, key, std::string(1, signature),
+                [this, key, signature, properties, first](sdbus::PropertyGetReply& reply)
+                {
+                    const auto* call = properties->getCurrentlyProcessedMessage();
+                    const char* member = call ? call->getMemberName() : nullptr;
+                    if (first || !member || std::string_view(member) != "GetAll")
+                        admitRead(*properties, property_get_metrics_);
+
+                    // Between a change and the next refresh a key may have another type
+                    const auto value = storage_->getParameter(key);
+                    if (!value || value->signature() != signature)
+                        throw sdbus::Error(ERROR_PROPERTY_CHANGED, "Property " + key + " changed, read it again");
+                    value->appendPayloadTo(reply);
+                },
+                [this, key, signature](sdbus::PropertySetCall& call) { onSetProperty(key, signature, call); }, flags);
+        }
+        object->finishRegistration();
+        properties_object_ = std::move(object);
+    }
+    catch (const sdbus::Error& e)
+    {
+        property_layout_.clear();
+        Logger::instance().error("Cannot register properties of ", storage_->getAppName(), ": ", e.what());
+    }
+}
+
+void DBusConfigAdapter::emitPropertiesChanged(const std::vector<std::string>& keys)
+{
+    std::lock_guard<std::mutex> lock(properties_mutex_);
+    if (!properties_object_)
+        return;
+
+    std::vector<std::string> names;
+    for (const auto& key : keys)
+    {
+        if (property_layout_.contains(key))
+            names.push_back(key);
+    }
+    if (!names.empty())
+        properties_object_->emitPropertiesChangedSignal(interface_name_, names);
+}
+
+ConfigValue DBusConfigAdapter::storedValue(const std::string& key, const sdbus::Variant& value) const
+{
+    if (auto stored = storage_->getParameter(key))
+        return std::move(*stored);
+    return ConfigValue::fromVariant(value);
+}
+
+void DBusConfigAdapter::scheduleChangeSignals()
+{
+    {
+        std::lock_guard<std::mutex> lock(pending_signals_mutex_);
+        // The queued flush emits this change too
+        if (std::exchange(pending_signals_.flush_queued, true))
+            return;
+    }
+
+    // A full signal queue slows the writer down instead of dropping signals or overtaking queued ones
+    if (!scheduler_ || !scheduler_->submit(DispatchClass::Signal, this, [this] { flushChangeSignals(); }))
+        flushChangeSignals();
+}
+
+void DBusConfigAdapter::addPendingSignal(const std::string& key, const ConfigValue& value, uint64_t version)
+{
+    std::lock_guard<std::mutex> lock(pending_signals_mutex_);
+    pending_signals_.configuration = true;
+    pending_signals_.keys.insert_or_assign(key, std::make_pair(value, version));
+}
+
+void DBusConfigAdapter::flushChangeSignals()
+{
+    // Held while emitting, so that the signals of two flushes cannot interleave
+    std::lock_guard<std::mutex> emitting(emit_mutex_);
+    PendingSignals pending;
+    {
+        std::lock_guard<std::mutex> lock(pending_signals_mutex_);
+        std::swap(pending, pending_signals_);
+    }
+
+    if (pending.configuration)
+        emitConfigurationChangedSignal();
+
+    // Oldest change first, so that clients see the version only grow
+    std::vector<std::pair<uint64_t, const std::string*>> order;
+    order.reserve(pending.keys.size());
+    for (const auto& [key, change] : pending.keys) order.emplace_back(change.second, &key);
+    std::stable_sort(order.begin(), order.end(),
+                     [](const auto& left, const auto& right) { return left.first < right.first; });
+
+    std::vector<std::string> keys;
+    keys.reserve(order.size());
+    for (const auto& [version, key] : order)
+    {
+        emitKeyChangedSignal(*key, pending.keys.at(*key).first, version);
+        keys.push_back(*key);
+    }
+    if (!keys.empty())
+        emitPropertiesChanged(keys);
+}
+
+void DBusConfigAdapter::onGetConfiguration(sdbus::MethodCall call)
+{
+    ScopedTimer timer(&get_metrics_.latency);
+    get_metrics_.calls.increment();
+
+    auto reply = call.createReply();
+    appendConfigurationReply(reply);
+    reply.send();
+}
+
+void DBusConfigAdapter::appendConfigurationReply(sdbus::Message& reply)
+{
+    bytes_marshalled_.increment(configuration_size_.load(std::memory_order_relaxed));
+    appendCachedConfiguration(reply);
+}
+
+void DBusConfigAdapter::rebuildCachedConfiguration()
+{
+    // Built under the cache lock so that concurrent changes cannot install an older body last
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    auto message = sdbus::createPlainMessage();
+    marshalConfiguration(message, *storage_);
+    message.seal();
+    cached_configuration_ = std::move(message);
+    configuration_size_.store(marshalledSize(*storage_), std::memory_order_relaxed);
+}
+
+void DBusConfigAdapter::appendCachedConfiguration(sdbus::Message& message)
+{
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    cached_configuration_.rewind(true);
+    cached_configuration_.copyTo(message, true);
+}
+
+void DBusConfigAdapter::marshalConfiguration(sdbus::Message& message, const IConfigStorage& storage)
+{
+    message.openContainer("{sv}");
+    storage.forEachParameter(
+        [&message](const std::string& key, const ConfigValue& value)
+        {
+            message.openDictEntry("sv");
+            message << key;
+            value.appendTo(message);
+            message.closeDictEntry();
+        });
+    message.closeContainer();
+}
+
+std::tuple<uint64_t, bool, DBusConfigAdapter::ConfigurationMap> DBusConfigAdapter::onGetChangesSince(uint64_t since)
+{
+    uint64_t version;
+    bool complete;
+    std::vector<std::string> keys;
+    {
+        std::lock_guard<std::mutex> lock(history_mutex_);
+        version = version_;
+        complete = since >= base_version_ && since <= version_;
+        if (complete)
+        {
+            for (const auto& [key, key_version] : key_versions_)
+                if (key_version > since)
+                    keys.push_back(key);
+        }
+    }
+    if (!complete)
+        return {version, false, storage_->getAllParameters()};
+
+    // Only the changed keys are converted, the rest of the configuration is not copied
+    ConfigurationMap changes;
+    for (const auto& key : keys)
+        if (auto value = storage_->getParameter(key))
+            changes.emplace(key, value->toVariant());
+    return {version, true, std::move(changes)};
+}
+
+void DBusConfigAdapter::onWaitForChange(sdbus::MethodCall call)
+{
+    wait_metrics_.calls.increment();
+
+    uint64_t since = 0;
+    uint32_t timeout_ms = 0;
+    try
+    {
+        call >> since >> timeout_ms;
+    }
+    catch (const sdbus::Error& e)
+    {
+        wait_metrics_.errors.increment();
+        throw sdbus::Error("com.system.configurationManager.Error.InvalidArgs", e.what());
+    }
+
+    {
+        // Checked under the waiters lock: a change either is already counted or wakes this waiter
+        std::lock_guard<std::mutex> lock(waiters_mutex_);
+        if (since == version() && timeout_ms > 0 && timers_ && !call.doesntExpectReply())
+        {
+            const uint64_t id = next_waiter_++;
+            const auto timeout = std::chrono::milliseconds(std::min(timeout_ms, MAX_WAIT_TIMEOUT_MS));
+            const auto timer = timers_->schedule(timeout, [this, id] { expireWaiter(id); });
+            waiters_.emplace(id, Waiter{std::move(call), since, timer, TimerService::Clock::now()});
+            return;
+        }
+    }
+
+    if (!call.doesntExpectReply())
+        replyChangesSince(call, since);
+}
+
+void DBusConfigAdapter::wakeWaiters()
+{
+    std::unordered_map<uint64_t, Waiter> waiters;
+    {
+        std::lock_guard<std::mutex> lock(waiters_mutex_);
+        if (waiters_.empty())
+            return;
+        waiters.swap(waiters_);
+    }
+
+    for (auto& [id, waiter] : waiters)
+    {
+        // Only stops the timer: an expiry that already fired finds the waiter gone, so the reply is ours.
+        // Outside the waiters lock, since cancel() waits for an expiry that may be running and needs it
+        timers_->cancel(waiter.timer);
+        wait_metrics_.latency.record(TimerService::Clock::now() - waiter.parked);
+        replyChangesSince(waiter.call, waiter.since);
+    }
+}
+
+void DBusConfigAdapter::expireWaiter(uint64_t id)
+{
+    // Replies under the lock so that the destructor cannot finish while an expired waiter is answered
+    std::lock_guard<std::mutex> lock(waiters_mutex_);
+    const auto it = waiters_.find(id);
+    if (it == waiters_.end())
+        return;
+    wait_metrics_.latency.record(TimerService::Clock::now() - it->second.parked);
+    replyChangesSince(it->second.call, it->second.since);
+    waiters_.erase(it);
+}
+
+void DBusConfigAdapter::replyChangesSince(sdbus::MethodCall& call, uint64_t since)
+{
+    try
+    {
+        auto [version, complete, changes] = onGetChangesSince(since);
+        auto reply = call.createReply();
+        reply << version << complete << changes;
+        reply.send();
+    }
+    catch (const sdbus::Error& e)
+    {
+        // The caller may have left while parked
+        wait_metrics_.errors.increment();
+        Logger::instance().warning("Cannot answer ", WAIT_FOR_CHANGE, " of ", storage_->getAppName(), ": ",
+                                   e.what());
+    }
+}
+
+sdbus::UnixFd DBusConfigAdapter::onGetSnapshotFd()
+{
+    if (!snapshot_)
+        throw sdbus::Error(ERROR_NOT_SUPPORTED, "Shared snapshots are disabled");
+    return snapshot_->readOnlyFd();
+}
+
+void DBusConfigAdapter::publishConfiguration()
+{
+    rebuildCachedConfiguration();
+    if (snapshot_)
+        snapshot_->publish(*storage_);
+    wakeWaiters();
+}
 
 void DBusConfigAdapter::emitConfigurationChangedSignal()
 {
-    auto signal = dbus_object_->createSignal(interface_name_, SIGNAL);
-    signal << storage_->getAllParameters();
+    emitOnAllObjects(SIGNAL, [this](sdbus::Signal& signal) { appendCachedConfiguration(signal); });
+
+    signals_emitted_.increment();
+    bytes_marshalled_.increment(configuration_size_.load(std::memory_order_relaxed));
+}
+
+void DBusConfigAdapter::emitKeyChangedSignal(const std::string& key, const ConfigValue& value, uint64_t version)
+{
+    emitOnAllObjects(KEY_SIGNAL,
+                     [&key, &value, version](sdbus::Signal& signal)
+                     {
+                         signal << key;
+                         value.appendTo(signal);
+                         signal << version;
+                     });
+    signals_emitted_.increment();
+}
+
+void DBusConfigAdapter::emitOnAllObjects(const std::string& name, const std::function<void(sdbus::Signal&)>& fill)
+{
+    auto signal = dbus_object_->createSignal(interface_name_, name);
+    fill(signal);
     dbus_object_->emitSignal(signal);
+
+    std::lock_guard<std::mutex> lock(peers_mutex_);
+    for (const auto& [connection, object] : peer_objects_)
+    {
+        auto peer_signal = object->createSignal(interface_name_, name);
+        fill(peer_signal);
+        object->emitSignal(peer_signal);
+    }
 }
\ No newline at end of file
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <ConfigValue/ConfigValue.hpp>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+static const std::string DERIVED_KEY_PREFIX = "Derived:";
+static const std::string ERROR_EXPRESSION = "Invalid expression: ";
+static const std::string ERROR_DERIVED_CYCLE = "Derived keys depend on each other: ";
+static const std::string ERROR_DERIVED_KEY = "Derived keys are computed, not set: ";
+static constexpr std::size_t MAX_EXPRESSION_LENGTH = 4096;
+static constexpr std::size_t MAX_EXPRESSION_DEPTH = 64;
+
+/**
+ * @class DerivedKeys
+ * @brief Keys computed from other keys, recomputed incrementally along a dependency graph
+ *
+ * An application declares `RetryBudget` by setting the key
+ * `Derived:RetryBudget` to an arithmetic expression over other keys, e.g.
+ * `max(1, 60000 / Timeout)`. Expressions support integer and floating point
+ * literals, key names, `+ - * / %`, unary minus, parentheses and the
+ * functions `min` and `max`. Integer operands give an `x` result (division
+ * truncates), any floating point operand gives a `d` result; booleans count
+ * as 0 and 1 and strings are rejected. Expressions are limited to
+ * MAX_EXPRESSION_LENGTH characters and MAX_EXPRESSION_DEPTH nested operands,
+ * since clients declare them.
+ *
+ * Expressions are compiled once to postfix code. The graph maps every key to
+ * the derived keys reading it and ranks derived keys in dependency order, so
+ * a change recomputes just the derived keys reachable from the changed keys,
+ * each once, after the derived keys it reads. Derived keys may read other
+ * derived keys; cycles are rejected when they are declared.
+ *
+ * Not thread-safe: the owner serializes access.
+ */
+class DerivedKeys
+{
+   public:
+    using Lookup = std::function<std::optional<ConfigValue>(const std::string&)>;
+    using Values = std::map<std::string, ConfigValue>;
+
+    /**
+     * @brief Check whether a key declares a derived key
+     * @param key Parameter name
+     * @return Name of the derived key, or std::nullopt for ordinary keys
+     */
+    static std::optional<std::string> declaredKey(const std::string&);
+
+    /**
+     * @brief Check that a declaration would be accepted, without changing anything
+     * @param key Derived key name
+     * @param expression Expression, empty to remove the declaration
+     * @throw std::runtime_error For syntax errors and cycles
+     */
+    void check(const std::string&, const std::string&) const;
+
+    /**
+     * @brief Declare, replace or (with an empty expression) remove a derived key
+     * @param key Derived key name
+     * @param expression Expression
+     * @throw std::runtime_error For syntax errors and cycles; the declarations are unchanged then
+     */
+    void define(const std::string&, const std::string&);
+
+    /**
+     * @brief Check whether a key is derived
+     * @param key Parameter name
+     * @return true if the key is computed
+     */
+    [[nodiscard]] bool defines(const std::string&) const;
+
+    /**
+     * @brief Get the number of derived keys
+     * @return Declared derived keys
+     */
+    [[nodiscard]] std::size_t size() const { return expressions_.size(); }
+
+    /**
+     * @brief Compute every derived key
+     * @param lookup Current value of a key
+     * @param failed Receives the keys whose expression could not be evaluated, may be nullptr
+     * @return Value of every derived key that could be computed
+     */
+    [[nodiscard]] Values evaluateAll(const Lookup&, std::vector<std::string>* = nullptr) const;
+
+    /**
+     * @brief Recompute the derived keys affected by changed keys
+     * @param changed Changed keys, derived keys whose declaration changed included
+     * @param lookup Current value of a key, already reflecting the changes
+     * @param failed Receives the keys whose expression could not be evaluated, may be nullptr
+     * @return New value of every affected derived key that could be computed
+     */
+    [[nodiscard]] Values recompute(const std::vector<std::string>&, const Lookup&,
+                                   std::vector<std::string>* = nullptr) const;
+
+   private:
+    /**
+     * @struct Instruction
+     * @brief One step of a compiled expression
+     */
+    struct Instruction
+    {
+        enum class Op : uint8_t
+        {
+            Integer,
+            Real,
+            Key,
+            Add,
+            Subtract,
+            Multiply,
+            Divide,
+            Modulo,
+            Negate,
+            Min,  ///< Pops `arity` values
+            Max   ///< Pops `arity` values
+        };
+
+        Op op;
+        int64_t integer = 0;
+        double real = 0;
+        std::string key;
+        std::size_t arity = 0;
+    };
+
+    /**
+     * @struct Expression
+     * @brief Compiled expression with the keys it reads
+     */
+    struct Expression
+    {
+        std::vector<Instruction> code;
+        std::set<std::string> references;
+    };
+
+    /**
+     * @brief Parse an expression
+     * @param text Expression source
+     * @return Compiled expression
+     * @throw std::runtime_error For syntax errors and expressions over the length or nesting limits
+     */
+    static Expression compile(const std::string&);
+
+    /**
+     * @brief Run a compiled expression
+     * @param expression Compiled expression
+     * @param lookup Current value of a key
+     * @return Result
+     * @throw std::runtime_error For missing or non-numeric keys, division by zero and overflow
+     */
+    static ConfigValue evaluate(const Expression&, const Lookup&);
+
+    /**
+     * @brief Order derived keys so that each comes after the derived keys it reads
+     * @param expressions Declarations to order
+     * @return Rank of every derived key
+     * @throw std::runtime_error If the declarations contain a cycle
+     */
+    static std::map<std::string, std::size_t> rank(const std::map<std::string, Expression>&);
+
+    /**
+     * @brief Evaluate derived keys in rank order, feeding results to later ones
+     * @param keys Derived keys to compute
+     * @param lookup Current value of a key
+     * @param failed Receives the keys that could not be evaluated, may be nullptr
+     * @return Computed values
+     */
+    Values evaluateRanked(const std::set<std::string>&, const Lookup&, std::vector<std::string>*) const;
+
+    std::map<std::string, Expression> expressions_;
+    std::map<std::string, std::set<std::string>> dependents_;  ///< Key → derived keys reading it
+    std::map<std::string, std::size_t> ranks_;
+};
\ No newline at end of file
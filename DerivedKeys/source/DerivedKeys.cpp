@@ -0,0 +1,550 @@
+#include "DerivedKeys/DerivedKeys.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <deque>
+#include <stdexcept>
+
+namespace
+{
+/**
+ * @struct Number
+ * @brief Operand of an expression, integer until a floating point value takes part
+ */
+struct Number
+{
+    bool integer = true;
+    int64_t i = 0;
+    double d = 0;
+
+    [[nodiscard]] double real() const { return integer ? static_cast<double>(i) : d; }
+};
+
+/**
+ * @class Parser
+ * @brief Recursive descent parser emitting postfix code
+ */
+template <typename Instruction>
+class Parser
+{
+   public:
+    explicit Parser(const std::string& text) : text_(text) {}
+
+    void parse(std::vector<Instruction>& code, std::set<std::string>& references)
+    {
+        code_ = &code;
+        references_ = &references;
+        expression();
+        skipSpaces();
+        if (position_ != text_.size())
+            fail("unexpected '" + std::string(1, text_[position_]) + "'");
+    }
+
+   private:
+    using Op = typename Instruction::Op;
+
+    void expression()
+    {
+        term();
+        while (true)
+        {
+            if (accept('+'))
+                term(), emit(Op::Add);
+            else if (accept('-'))
+                term(), emit(Op::Subtract);
+            else
+                return;
+        }
+    }
+
+    void term()
+    {
+        unary();
+        while (true)
+        {
+            if (accept('*'))
+                unary(), emit(Op::Multiply);
+            else if (accept('/'))
+                unary(), emit(Op::Divide);
+            else if (accept('%'))
+                unary(), emit(Op::Modulo);
+            else
+                return;
+        }
+    }
+
+    void unary()
+    {
+        // Every nested operand passes here, so this bounds the recursion for any input
+        if (++depth_ > MAX_EXPRESSION_DEPTH)
+            fail("nested more than " + std::to_string(MAX_EXPRESSION_DEPTH) + " levels");
+        if (accept('-'))
+        {
+            unary();
+            emit(Op::Negate);
+        }
+        else
+            primary();
+        --depth_;
+    }
+
+    void primary()
+    {
+        skipSpaces();
+        if (accept('('))
+        {
+            expression();
+            expect(')');
+            return;
+        }
+        if (position_ < text_.size() && (std::isdigit(static_cast<unsigned char>(text_[position_])) ||
+                                         text_[position_] == '.'))
+        {
+            number();
+            return;
+        }
+        if (position_ < text_.size() && isNameStart(text_[position_]))
+        {
+            name();
+            return;
+        }
+        fail(position_ < text_.size() ? "unexpected '" + std::string(1, text_[position_]) + "'"
+                                      : "unexpected end");
+    }
+
+    void number()
+    {
+        const std::size_t start = position_;
+        bool real = false;
+        while (position_ < text_.size())
+        {
+            const char c = text_[position_];
+            if (std::isdigit(static_cast<unsigned char>(c)))
+                ++position_;
+            else if (c == '.' || c == 'e' || c == 'E')
+                real = true, ++position_;
+            else if ((c == '+' || c == '-') && real && (text_[position_ - 1] == 'e' || text_[position_ - 1] == 'E'))
+                ++position_;
+            else
+                break;
+        }
+
+        const std::string literal = text_.substr(start, position_ - start);
+        Instruction instruction = make(real ? Op::Real : Op::Integer);
+        try
+        {
+            std::size_t used = 0;
+            if (real)
+                instruction.real = std::stod(literal, &used);
+            else
+                instruction.integer = std::stoll(literal, &used);
+            if (used != literal.size())
+                fail("malformed number " + literal);
+        }
+        catch (const std::logic_error&)
+        {
+            fail("malformed number " + literal);
+        }
+        code_->push_back(std::move(instruction));
+    }
+
+    void name()
+    {
+        const std::size_t start = position_;
+        while (position_ < text_.size() && (isNameStart(text_[position_]) ||
+                                            std::isdigit(static_cast<unsigned char>(text_[position_])) ||
+                                            text_[position_] == '.'))
+            ++position_;
+        std::string identifier = text_.substr(start, position_ - start);
+
+        if (!accept('('))
+        {
+            references_->insert(identifier);
+            Instruction instruction = make(Op::Key);
+            instruction.key = std::move(identifier);
+            code_->push_back(std::move(instruction));
+            return;
+        }
+
+        if (identifier != "min" && identifier != "max")
+            fail("unknown function " + identifier);
+        Instruction instruction = make(identifier == "min" ? Op::Min : Op::Max);
+        do
+        {
+            expression();
+            ++instruction.arity;
+        } while (accept(','));
+        expect(')');
+        code_->push_back(std::move(instruction));
+    }
+
+    static Instruction make(Op op)
+    {
+        Instruction instruction;
+        instruction.op = op;
+        return instruction;
+    }
+
+    static bool isNameStart(char c) { return std::isalpha(static_cast<unsigned char>(c)) || c == '_'; }
+
+    void skipSpaces()
+    {
+        while (position_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[position_]))) ++position_;
+    }
+
+    bool accept(char c)
+    {
+        skipSpaces();
+        if (position_ < text_.size() && text_[position_] == c)
+        {
+            ++position_;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(char c)
+    {
+        if (!accept(c))
+            fail("expected '" + std::string(1, c) + "'");
+    }
+
+    void emit(Op op) { code_->push_back(make(op)); }
+
+    [[noreturn]] void fail(const std::string& reason) const
+    {
+        throw std::runtime_error(ERROR_EXPRESSION + reason + " at " + std::to_string(position_) + " in '" + text_ +
+                                 "'");
+    }
+
+    const std::string& text_;
+    std::size_t position_ = 0;
+    std::size_t depth_ = 0;
+    std::vector<Instruction>* code_ = nullptr;
+    std::set<std::string>* references_ = nullptr;
+};
+
+Number toNumber(const std::string& key, const ConfigValue& value)
+{
+    switch (value.type())
+    {
+        case ConfigValue::Type::Bool:
+            return {true, value.get<bool>() ? 1 : 0};
+        case ConfigValue::Type::Byte:
+            return {true, value.get<uint8_t>()};
+        case ConfigValue::Type::Int16:
+            return {true, value.get<int16_t>()};
+        case ConfigValue::Type::UInt16:
+            return {true, value.get<uint16_t>()};
+        case ConfigValue::Type::Int32:
+            return {true, value.get<int32_t>()};
+        case ConfigValue::Type::UInt32:
+            return {true, value.get<uint32_t>()};
+        case ConfigValue::Type::Int64:
+            return {true, value.get<int64_t>()};
+        case ConfigValue::Type::UInt64:
+        {
+            const uint64_t number = value.get<uint64_t>();
+            if (number <= static_cast<uint64_t>(INT64_MAX))
+                return {true, static_cast<int64_t>(number)};
+            return {false, 0, static_cast<double>(number)};
+        }
+        case ConfigValue::Type::Double:
+            return {false, 0, value.get<double>()};
+        default:
+            throw std::runtime_error("Key " + key + " is not a number");
+    }
+}
+}  // namespace
+
+std::optional<std::string> DerivedKeys::declaredKey(const std::string& key)
+{
+    if (!key.starts_with(DERIVED_KEY_PREFIX) || key.size() == DERIVED_KEY_PREFIX.size())
+        return std::nullopt;
+    return key.substr(DERIVED_KEY_PREFIX.size());
+}
+
+DerivedKeys::Expression DerivedKeys::compile(const std::string& text)
+{
+    if (text.size() > MAX_EXPRESSION_LENGTH)
+        throw std::runtime_error(ERROR_EXPRESSION + "longer than " + std::to_string(MAX_EXPRESSION_LENGTH) +
+                                 " characters");
+    Expression expression;
+    Parser<Instruction>(text).parse(expression.code, expression.references);
+    return expression;
+}
+
+std::map<std::string, std::size_t> DerivedKeys::rank(const std::map<std::string, Expression>& expressions)
+{
+    // Kahn's algorithm over the edges between derived keys
+    std::map<std::string, std::size_t> pending;
+    std::map<std::string, std::vector<std::string>> readers;
+    for (const auto& [key, expression] : expressions)
+    {
+        std::size_t& count = pending[key];
+        for (const auto& reference : expression.references)
+        {
+            if (reference == key)
+                throw std::runtime_error(ERROR_DERIVED_CYCLE + key);
+            if (expressions.contains(reference))
+            {
+                ++count;
+                readers[reference].push_back(key);
+            }
+        }
+    }
+
+    std::deque<std::string> ready;
+    for (const auto& [key, count] : pending)
+    {
+        if (count == 0)
+            ready.push_back(key);
+    }
+
+    std::map<std::string, std::size_t> ranks;
+    while (!ready.empty())
+    {
+        const std::string key = std::move(ready.front());
+        ready.pop_front();
+        ranks.emplace(key, ranks.size());
+        for (const auto& reader : readers[key])
+        {
+            if (--pending[reader] == 0)
+                ready.push_back(reader);
+        }
+    }
+
+    if (ranks.size() != expressions.size())
+    {
+        std::string cycle;
+        for (const auto& [key, count] : pending)
+        {
+            if (count > 0)
+                cycle += (cycle.empty() ? "" : ", ") + key;
+        }
+        throw std::runtime_error(ERROR_DERIVED_CYCLE + cycle);
+    }
+    return ranks;
+}
+
+void DerivedKeys::check(const std::string& key, const std::string& expression) const
+{
+    if (expression.empty())
+        return;
+
+    auto expressions = expressions_;
+    expressions[key] = compile(expression);
+    rank(expressions);
+}
+
+void DerivedKeys::define(const std::string& key, const std::string& expression)
+{
+    auto expressions = expressions_;
+    if (expression.empty())
+        expressions.erase(key);
+    else
+        expressions[key] = compile(expression);
+    auto ranks = rank(expressions);
+
+    expressions_ = std::move(expressions);
+    ranks_ = std::move(ranks);
+    dependents_.clear();
+    for (const auto& [derived, compiled] : expressions_)
+    {
+        for (const auto& reference : compiled.references) dependents_[reference].insert(derived);
+    }
+}
+
+bool DerivedKeys::defines(const std::string& key) const { return expressions_.contains(key); }
+
+DerivedKeys::Values DerivedKeys::evaluateAll(const Lookup& lookup, std::vector<std::string>* failed) const
+{
+    std::set<std::string> keys;
+    for (const auto& [key, expression] : expressions_) keys.insert(key);
+    return evaluateRanked(keys, lookup, failed);
+}
+
+DerivedKeys::Values DerivedKeys::recompute(const std::vector<std::string>& changed, const Lookup& lookup,
+                                           std::vector<std::string>* failed) const
+{
+    std::set<std::string> affected;
+    std::deque<std::string> queue;
+    for (const auto& key : changed)
+    {
+        if (expressions_.contains(key) && affected.insert(key).second)
+            queue.push_back(key);
+        if (const auto it = dependents_.find(key); it != dependents_.end())
+        {
+            for (const auto& reader : it->second)
+            {
+                if (affected.insert(reader).second)
+                    queue.push_back(reader);
+            }
+        }
+    }
+    while (!queue.empty())
+    {
+        const auto it = dependents_.find(queue.front());
+        queue.pop_front();
+        if (it == dependents_.end())
+            continue;
+        for (const auto& reader : it->second)
+        {
+            if (affected.insert(reader).second)
+                queue.push_back(reader);
+        }
+    }
+    return evaluateRanked(affected, lookup, failed);
+}
+
+DerivedKeys::Values DerivedKeys::evaluateRanked(const std::set<std::string>& keys, const Lookup& lookup,
+                                                std::vector<std::string>* failed) const
+{
+    std::vector<std::pair<std::size_t, const std::string*>> order;
+    order.reserve(keys.size());
+    for (const auto& key : keys) order.emplace_back(ranks_.at(key), &key);
+    std::sort(order.begin(), order.end());
+
+    Values values;
+    std::set<std::string> failures;
+    // Derived keys computed in this pass shadow their stored values
+    const Lookup current = [&values, &failures, &lookup](const std::string& key) -> std::optional<ConfigValue>
+    {
+        if (const auto it = values.find(key); it != values.end())
+            return it->second;
+        if (failures.contains(key))
+            return std::nullopt;
+        return lookup(key);
+    };
+
+    for (const auto& [rank, key] : order)
+    {
+        try
+        {
+            values.emplace(*key, evaluate(expressions_.at(*key), current));
+        }
+        catch (const std::runtime_error&)
+        {
+            failures.insert(*key);
+            if (failed)
+                failed->push_back(*key);
+        }
+    }
+    return values;
+}
+
+ConfigValue DerivedKeys::evaluate(const Expression& expression, const Lookup& lookup)
+{
+    std::vector<Number> stack;
+    auto pop = [&stack]
+    {
+        const Number number = stack.back();
+        stack.pop_back();
+        return number;
+    };
+
+    for (const auto& instruction : expression.code)
+    {
+        using Op = Instruction::Op;
+        switch (instruction.op)
+        {
+            case Op::Integer:
+                stack.push_back({true, instruction.integer});
+                continue;
+            case Op::Real:
+                stack.push_back({false, 0, instruction.real});
+                continue;
+            case Op::Key:
+            {
+                const auto value = lookup(instruction.key);
+                if (!value)
+                    throw std::runtime_error("Key " + instruction.key + " has no value");
+                stack.push_back(toNumber(instruction.key, *value));
+                continue;
+            }
+            case Op::Negate:
+            {
+                Number number = pop();
+                if (number.integer && number.i == INT64_MIN)
+                    throw std::runtime_error("Integer overflow");
+                number.i = -number.i;
+                number.d = -number.d;
+                stack.push_back(number);
+                continue;
+            }
+            case Op::Min:
+            case Op::Max:
+            {
+                Number best = pop();
+                for (std::size_t i = 1; i < instruction.arity; ++i)
+                {
+                    const Number other = pop();
+                    const bool less = other.integer && best.integer ? other.i < best.i : other.real() < best.real();
+                    if ((instruction.op == Op::Min) == less)
+                        best = other;
+                }
+                stack.push_back(best);
+                continue;
+            }
+            default:
+                break;
+        }
+
+        const Number rhs = pop();
+        const Number lhs = pop();
+        Number result;
+        if (lhs.integer && rhs.integer)
+        {
+            bool overflow = false;
+            switch (instruction.op)
+            {
+                case Op::Add:
+                    overflow = __builtin_add_overflow(lhs.i, rhs.i, &result.i);
+                    break;
+                case Op::Subtract:
+                    overflow = __builtin_sub_overflow(lhs.i, rhs.i, &result.i);
+                    break;
+                case Op::Multiply:
+                    overflow = __builtin_mul_overflow(lhs.i, rhs.i, &result.i);
+                    break;
+                default:
+                    if (rhs.i == 0)
+                        throw std::runtime_error("Division by zero");
+                    overflow = lhs.i == INT64_MIN && rhs.i == -1;
+                    if (!overflow)
+                        result.i = instruction.op == Op::Divide ? lhs.i / rhs.i : lhs.i % rhs.i;
+                    break;
+            }
+            if (overflow)
+                throw std::runtime_error("Integer overflow");
+        }
+        else
+        {
+            result.integer = false;
+            const double a = lhs.real();
+            const double b = rhs.real();
+            switch (instruction.op)
+            {
+                case Op::Add:
+                    result.d = a + b;
+                    break;
+                case Op::Subtract:
+                    result.d = a - b;
+                    break;
+                case Op::Multiply:
+                    result.d = a * b;
+                    break;
+                default:
+                    if (b == 0)
+                        throw std::runtime_error("Division by zero");
+                    result.d = instruction.op == Op::Divide ? a / b : std::fmod(a, b);
+                    break;
+            }
+        }
+        stack.push_back(result);
+    }
+
+    const Number result = stack.back();
+    return result.integer ? ConfigValue(result.i) : ConfigValue(result.d);
+}
\ No newline at end of file
@@ -1,5 +1,5 @@
 #include <ConfigApplication/ConfigApplication.hpp>
-#include <iostream>
+#include <Logger/Logger.hpp>
 
 int main()
 {
@@ -10,7 +10,7 @@ int main()
     }
     catch (const std::exception& e)
     {
-        std::cerr << "Error: " << e.what() << '\n';
+        Logger::instance().error("Error: ", e.what());
         return 1;
     }
     return 0;
@@ -1,18 +1,133 @@
+#include <ConfConfigFileManager/ConfConfigFileManager.hpp>
 #include <ConfigurationManager/ConfigurationManager.hpp>
+#include <ExtensionConfigFileManager/ExtensionConfigFileManager.hpp>
 #include <JsonConfigFileManager/JsonConfigFileManager.hpp>
-#include <iostream>
+#include <Logger/Logger.hpp>
 
-int main()
+/**
+ * @brief Parse dispatch queue weights written as `read:write:signal`
+ * @param text Option value
+ * @param options Options to update
+ * @return Options with the new weights
+ * @throw std::runtime_error For malformed values
+ */
+static DispatchOptions parseDispatchWeights(const std::string& text, DispatchOptions options)
+{
+    const auto first = text.find(':');
+    const auto second = first == std::string::npos ? first : text.find(':', first + 1);
+    if (second == std::string::npos)
+        throw std::runtime_error("Invalid dispatch weights, expected READ:WRITE:SIGNAL: " + text);
+
+    options.read_weight = std::stoul(text.substr(0, first));
+    options.write_weight = std::stoul(text.substr(first + 1, second - first - 1));
+    options.signal_weight = std::stoul(text.substr(second + 1));
+    return options;
+}
+
+/**
+ * @brief Parse a rate limit written as `rate` or `rate:burst`
+ * @param text Option value
+ * @return Limit, the burst defaults to the rate
+ */
+static RateLimit parseRateLimit(const std::string& text)
+{
+    const auto colon = text.find(':');
+    const double rate = std::stod(text.substr(0, colon));
+    return {rate, colon == std::string::npos ? rate : std::stod(text.substr(colon + 1))};
+}
+
+/**
+ * @brief Parse server command line options
+ *
+ * Supported options:
+ * - `--metrics-file PATH` periodically dump Prometheus text metrics to PATH
+ * - `--metrics-interval MS` dump period in milliseconds
+ * - `--peer-socket PATH` accept direct peer-to-peer connections on a unix socket
+ * - `--shared-snapshots` publish configurations into shared-memory snapshots (memfds); off by default
+ * - `--no-shared-snapshots` do not publish configurations into shared memory
+ * - `--config-cache` reuse parsed configuration files across restarts through `configs.cache`; off by default
+ * - `--no-config-cache` parse every configuration file at startup instead of using `configs.cache`
+ * - `--journal` journal changes so that runtime changes and versions survive a restart; off by default
+ * - `--no-journal` do not journal changes (runtime changes are lost on restart)
+ * - `--journal-compact-interval MS` period between two journal compactions
+ * - `--no-dispatch-queues` run application calls directly on the D-Bus dispatch thread
+ * - `--dispatch-weights R:W:S` read, write and signal tasks run per scheduling round
+ * - `--dispatch-queue-capacity N` queued tasks per class before calls are rejected as busy
+ * - `--read-rate-limit RATE[:BURST]` per-sender GetConfiguration calls per second of each application
+ * - `--write-rate-limit RATE[:BURST]` per-sender ChangeConfiguration calls per second of each application
+ * - `--properties` expose keys through org.freedesktop.DBus.Properties; off by default
+ * - `--no-properties` do not expose keys through org.freedesktop.DBus.Properties
+ * - `--properties-invalidate-above BYTES` announce longer string properties as invalidated, without the value
+ * - `--fd-values-above BYTES` keep longer strings in sealed memfds and send them as file descriptors
+ *   (changes their wire type from `s` to `h`); off by default
+ * - `--log-level LEVEL` minimum log level: debug, info, warning or error
+ */
+static ManagerOptions parseOptions(int argc, char* argv[])
+{
+    ManagerOptions options;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--metrics-file" && i + 1 < argc)
+            options.metrics_file = argv[++i];
+        else if (arg == "--metrics-interval" && i + 1 < argc)
+            options.metrics_interval = std::chrono::milliseconds(std::stoul(argv[++i]));
+        else if (arg == "--peer-socket" && i + 1 < argc)
+            options.peer_socket = argv[++i];
+        else if (arg == "--shared-snapshots")
+            options.shared_snapshots = true;
+        else if (arg == "--no-shared-snapshots")
+            options.shared_snapshots = false;
+        else if (arg == "--config-cache")
+            options.config_cache = true;
+        else if (arg == "--no-config-cache")
+            options.config_cache = false;
+        else if (arg == "--journal")
+            options.journal = true;
+        else if (arg == "--no-journal")
+            options.journal = false;
+        else if (arg == "--journal-compact-interval" && i + 1 < argc)
+            options.journal_compact_interval = std::chrono::milliseconds(std::stoul(argv[++i]));
+        else if (arg == "--no-dispatch-queues")
+            options.dispatch_queues = false;
+        else if (arg == "--dispatch-weights" && i + 1 < argc)
+            options.dispatch = parseDispatchWeights(argv[++i], options.dispatch);
+        else if (arg == "--dispatch-queue-capacity" && i + 1 < argc)
+            options.dispatch.queue_capacity = std::stoul(argv[++i]);
+        else if (arg == "--read-rate-limit" && i + 1 < argc)
+            options.read_rate_limit = parseRateLimit(argv[++i]);
+        else if (arg == "--write-rate-limit" && i + 1 < argc)
+            options.write_rate_limit = parseRateLimit(argv[++i]);
+        else if (arg == "--properties")
+            options.properties.enabled = true;
+        else if (arg == "--no-properties")
+            options.properties.enabled = false;
+        else if (arg == "--properties-invalidate-above" && i + 1 < argc)
+            options.properties.invalidate_above = std::stoul(argv[++i]);
+        else if (arg == "--fd-values-above" && i + 1 < argc)
+            options.fd_values_above = std::stoul(argv[++i]);
+        else if (arg == "--log-level" && i + 1 < argc)
+            Logger::instance().setLevel(Logger::parseLevel(argv[++i]));
+        else
+            throw std::runtime_error("Unknown or incomplete option: " + arg);
+    }
+    return options;
+}
+
+int main(int argc, char* argv[])
 {
     try
     {
-        auto configManager = std::make_unique<ConfigurationManager>(std::make_unique<JsonConfigFileManager>());
+        // Legacy INI-style files are read as they are, everything else is JSON
+        auto loader = std::make_unique<ExtensionConfigFileManager>(std::make_unique<JsonConfigFileManager>());
+        loader->add(".conf", std::make_unique<ConfConfigFileManager>());
+        auto configManager = std::make_unique<ConfigurationManager>(std::move(loader), "", parseOptions(argc, argv));
 
         configManager->run();
     }
     catch (const std::exception& e)
     {
-        std::cerr << "Fatal error: " << e.what() << '\n';
+        Logger::instance().error("Fatal error: ", e.what());
         return 1;
     }
     return 0;
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <Metrics/Metrics.hpp>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+static const std::string ERROR_BUSY = "com.system.configurationManager.Error.Busy";
+
+/**
+ * @enum DispatchClass
+ * @brief Queue a deferred D-Bus task belongs to
+ */
+enum class DispatchClass : std::size_t
+{
+    Read,    ///< GetConfiguration calls
+    Write,   ///< ChangeConfiguration calls
+    Signal,  ///< Change signal emission
+    Count
+};
+
+/**
+ * @struct DispatchOptions
+ * @brief Weights and capacity of the dispatch queues
+ */
+struct DispatchOptions
+{
+    std::size_t read_weight = 8;    ///< Read tasks run per scheduling round
+    std::size_t write_weight = 2;   ///< Write tasks run per scheduling round
+    std::size_t signal_weight = 2;  ///< Signal tasks run per scheduling round
+    std::size_t queue_capacity = 1024;  ///< Maximum queued tasks per class
+};
+
+/**
+ * @class DispatchScheduler
+ * @brief Weighted queues between the sdbus dispatch thread and the adapter handlers
+ *
+ * The dispatch thread only enqueues; a worker thread runs the tasks, taking up
+ * to `weight` tasks from each non-empty queue per round, so a storm of writes
+ * (and the signals they cause) cannot starve reads. A full queue rejects new
+ * tasks and the caller turns that into an ERROR_BUSY reply.
+ *
+ * Tasks of one class run in submission order. The time spent queued is
+ * recorded in `config_dispatch_queue_wait_seconds{class}` and rejections in
+ * `config_dispatch_rejected_total{class}`.
+ *
+ * Thread-safe.
+ */
+class DispatchScheduler
+{
+   public:
+    using Task = std::function<void()>;
+
+    /**
+     * @brief Start the worker thread
+     * @param options Queue weights and capacity
+     */
+    explicit DispatchScheduler(DispatchOptions = {});
+
+    DispatchScheduler(const DispatchScheduler&) = delete;
+    DispatchScheduler& operator=(const DispatchScheduler&) = delete;
+
+    /**
+     * @brief Stop the worker; tasks still queued are discarded
+     */
+    ~DispatchScheduler();
+
+    /**
+     * @brief Queue a task
+     * @param type Queue to use
+     * @param owner Object the task belongs to, see drain()
+     * @param task Task to run on the worker thread
+     * @return false if the queue is full and the task was not queued
+     */
+    bool submit(DispatchClass, const void*, Task);
+
+    /**
+     * @brief Wait until no task of an owner is queued or running
+     *
+     * Called by an owner before it is destroyed. Must not be called from a task.
+     * @param owner Owner passed to submit()
+     */
+    void drain(const void*);
+
+    /**
+     * @brief Get the number of queued tasks of a class
+     * @param type Queue
+     * @return Queue length
+     */
+    [[nodiscard]] std::size_t queued(DispatchClass) const;
+
+   private:
+    static constexpr std::size_t CLASS_COUNT = static_cast<std::size_t>(DispatchClass::Count);
+
+    /**
+     * @struct Entry
+     * @brief Queued task with its owner and submission time
+     */
+    struct Entry
+    {
+        const void* owner;
+        Task task;
+        std::chrono::steady_clock::time_point submitted;
+    };
+
+    /**
+     * @brief Run tasks until stopped
+     * @param stop_token Stop request of the worker
+     */
+    void work(std::stop_token);
+
+    /**
+     * @brief Pick the queue of the next task by weighted round robin, the lock is held
+     * @return Queue index, CLASS_COUNT if every queue is empty
+     */
+    std::size_t nextClass();
+
+    DispatchOptions options_;
+    std::array<std::size_t, CLASS_COUNT> weights_;
+    std::array<std::size_t, CLASS_COUNT> credits_;
+    std::array<std::deque<Entry>, CLASS_COUNT> queues_;
+    std::array<LatencyHistogram*, CLASS_COUNT> queue_wait_;
+    std::array<Counter*, CLASS_COUNT> rejected_;
+    std::unordered_map<const void*, std::size_t> pending_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable_any task_queued_;
+    std::condition_variable task_done_;
+    std::jthread worker_;
+};
\ No newline at end of file
@@ -0,0 +1,115 @@
+#include "DispatchScheduler/DispatchScheduler.hpp"
+
+#include <Logger/Logger.hpp>
+#include <algorithm>
+
+static const std::array<std::string, 3> CLASS_NAMES = {"read", "write", "signal"};
+
+DispatchScheduler::DispatchScheduler(DispatchOptions options)
+    : options_(options),
+      weights_{std::max<std::size_t>(options.read_weight, 1), std::max<std::size_t>(options.write_weight, 1),
+               std::max<std::size_t>(options.signal_weight, 1)},
+      credits_(weights_)
+{
+    auto& registry = MetricsRegistry::instance();
+    for (std::size_t i = 0; i < CLASS_COUNT; ++i)
+    {
+        queue_wait_[i] = &registry.histogram("config_dispatch_queue_wait_seconds", {{"class", CLASS_NAMES[i]}});
+        rejected_[i] = &registry.counter("config_dispatch_rejected_total", {{"class", CLASS_NAMES[i]}});
+    }
+
+    worker_ = std::jthread([this](std::stop_token stop_token) { work(stop_token); });
+}
+
+DispatchScheduler::~DispatchScheduler()
+{
+    worker_.request_stop();
+    if (worker_.joinable())
+        worker_.join();
+}
+
+bool DispatchScheduler::submit(DispatchClass type, const void* owner, Task task)
+{
+    const auto index = static_cast<std::size_t>(type);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (queues_[index].size() >= options_.queue_capacity)
+        {
+            rejected_[index]->increment();
+            return false;
+        }
+        queues_[index].push_back({owner, std::move(task), std::chrono::steady_clock::now()});
+        ++pending_[owner];
+    }
+    task_queued_.notify_one();
+    return true;
+}
+
+void DispatchScheduler::drain(const void* owner)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    task_done_.wait(lock, [this, owner] { return !pending_.contains(owner); });
+}
+
+std::size_t DispatchScheduler::queued(DispatchClass type) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queues_[static_cast<std::size_t>(type)].size();
+}
+
+std::size_t DispatchScheduler::nextClass()
+{
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        for (std::size_t i = 0; i < CLASS_COUNT; ++i)
+        {
+            if (!queues_[i].empty() && credits_[i] > 0)
+                return i;
+        }
+        // Every non-empty queue used its share of the round: start a new one
+        credits_ = weights_;
+    }
+    return CLASS_COUNT;
+}
+
+void DispatchScheduler::work(std::stop_token stop_token)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_token.stop_requested())
+    {
+        const std::size_t index = nextClass();
+        if (index == CLASS_COUNT)
+        {
+            task_queued_.wait(lock, stop_token,
+                              [this]
+                              {
+                                  return std::any_of(queues_.begin(), queues_.end(),
+                                                     [](const auto& queue) { return !queue.empty(); });
+                              });
+            continue;
+        }
+
+        --credits_[index];
+        Entry entry = std::move(queues_[index].front());
+        queues_[index].pop_front();
+        lock.unlock();
+
+        queue_wait_[index]->record(std::chrono::steady_clock::now() - entry.submitted);
+        try
+        {
+            entry.task();
+        }
+        catch (const std::exception& e)
+        {
+            Logger::instance().error("Dispatch task failed: ", e.what());
+        }
+        entry.task = nullptr;
+
+        lock.lock();
+        if (auto it = pending_.find(entry.owner); it != pending_.end() && --it->second == 0)
+        {
+            pending_.erase(it);
+            task_done_.notify_all();
+        }
+    }
+}
\ No newline at end of file
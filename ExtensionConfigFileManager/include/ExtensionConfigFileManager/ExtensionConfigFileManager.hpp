@@ -0,0 +1,71 @@
+#pragma once
+
+#include <IConfigFileManager/IConfigFileManager.hpp>
+#include <memory>
+
+/**
+ * @class ExtensionConfigFileManager
+ * @brief IConfigFileManager that picks the format of each file by its extension
+ *
+ * Files whose extension has a registered manager are loaded and saved by it,
+ * all others by the fallback manager. validate() checks the merged
+ * configuration, which no longer has a format, with the fallback manager.
+ */
+class ExtensionConfigFileManager : public IConfigFileManager
+{
+   public:
+    /**
+     * @brief Create a manager for files of one format
+     * @param fallback Manager for files without a registered extension
+     */
+    explicit ExtensionConfigFileManager(std::unique_ptr<IConfigFileManager>);
+
+    /**
+     * @brief Handle the files with an extension by another manager
+     * @param extension Extension with the dot, e.g. `.conf`
+     * @param manager Manager for these files
+     */
+    void add(const std::string&, std::unique_ptr<IConfigFileManager>);
+
+    /**
+     * @brief Load and validate a configuration with the manager of its extension
+     * @param path Path to the configuration file
+     * @return std::map<std::string, sdbus::Variant> Parsed configuration
+     * @throw std::runtime_error What the chosen manager throws
+     */
+    [[nodiscard]] std::map<std::string, sdbus::Variant> load(const std::string&) override;
+
+    /**
+     * @brief Load a configuration layer with the manager of its extension
+     * @param path Path to the layer file
+     * @return std::map<std::string, sdbus::Variant> Parsed layer
+     * @throw std::runtime_error What the chosen manager throws
+     */
+    [[nodiscard]] std::map<std::string, sdbus::Variant> loadLayer(const std::string&) override;
+
+    /**
+     * @brief Check a merged configuration with the fallback manager
+     * @param config Effective configuration
+     * @throw std::runtime_error If validation fails
+     */
+    void validate(const std::map<std::string, sdbus::Variant>&) override;
+
+    /**
+     * @brief Save a configuration in the format of its extension
+     * @param path Destination file path
+     * @param config Configuration data to save
+     * @throw std::runtime_error What the chosen manager throws
+     */
+    void save(const std::string&, const std::map<std::string, sdbus::Variant>&) override;
+
+   private:
+    /**
+     * @brief Get the manager for a file
+     * @param path File path
+     * @return Manager registered for its extension, or the fallback
+     */
+    [[nodiscard]] IConfigFileManager& managerFor(const std::string&) const;
+
+    std::unique_ptr<IConfigFileManager> fallback_;
+    std::map<std::string, std::unique_ptr<IConfigFileManager>> by_extension_;
+};
\ No newline at end of file
@@ -0,0 +1,39 @@
+#include "ExtensionConfigFileManager/ExtensionConfigFileManager.hpp"
+
+#include <filesystem>
+
+ExtensionConfigFileManager::ExtensionConfigFileManager(std::unique_ptr<IConfigFileManager> fallback)
+    : fallback_(std::move(fallback))
+{
+}
+
+void ExtensionConfigFileManager::add(const std::string& extension, std::unique_ptr<IConfigFileManager> manager)
+{
+    by_extension_[extension] = std::move(manager);
+}
+
+IConfigFileManager& ExtensionConfigFileManager::managerFor(const std::string& path) const
+{
+    const auto it = by_extension_.find(std::filesystem::path(path).extension().string());
+    return it == by_extension_.end() ? *fallback_ : *it->second;
+}
+
+std::map<std::string, sdbus::Variant> ExtensionConfigFileManager::load(const std::string& path)
+{
+    return managerFor(path).load(path);
+}
+
+std::map<std::string, sdbus::Variant> ExtensionConfigFileManager::loadLayer(const std::string& path)
+{
+    return managerFor(path).loadLayer(path);
+}
+
+void ExtensionConfigFileManager::validate(const std::map<std::string, sdbus::Variant>& config)
+{
+    fallback_->validate(config);
+}
+
+void ExtensionConfigFileManager::save(const std::string& path, const std::map<std::string, sdbus::Variant>& config)
+{
+    managerFor(path).save(path, config);
+}
\ No newline at end of file
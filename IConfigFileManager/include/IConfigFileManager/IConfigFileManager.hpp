@@ -23,6 +23,24 @@ class IConfigFileManager
      */
     virtual std::map<std::string, sdbus::Variant> load(const std::string&) = 0;
 
+    /**
+     * @brief Load one configuration layer from file without validating it
+     *
+     * Layers (defaults, groups, application files) only hold part of a
+     * configuration; the merged result is checked with validate().
+     * @param path Path to the layer file
+     * @return std::map<std::string, sdbus::Variant> Key-value pairs of the layer
+     * @throw std::runtime_error If file cannot be read or parsed
+     */
+    virtual std::map<std::string, sdbus::Variant> loadLayer(const std::string& path) { return load(path); }
+
+    /**
+     * @brief Check that a merged configuration is complete
+     * @param config Effective configuration
+     * @throw std::runtime_error If required keys are missing or have wrong types
+     */
+    virtual void validate(const std::map<std::string, sdbus::Variant>&) {}
+
     /**
      * @brief Save configuration to file
      * @param path Path to the configuration file
@@ -2,7 +2,10 @@
 
 #include <sdbus-c++/sdbus-c++.h>
 
+#include <ConfigValue/ConfigValue.hpp>
+#include <functional>
 #include <map>
+#include <optional>
 #include <string>
 
 /**
@@ -15,12 +18,46 @@
 class IConfigStorage
 {
    public:
+    using ParameterVisitor = std::function<void(const std::string&, const ConfigValue&)>;
+
     /**
      * @brief Get all configuration parameters
      * @return Map of all configuration parameters (key-value pairs)
      */
     virtual std::map<std::string, sdbus::Variant> getAllParameters() const = 0;
 
+    /**
+     * @brief Visit every configuration parameter in key order without copying them
+     *
+     * Implementations call the visitor while holding their lock; the visitor
+     * must not call back into the storage. The default implementation visits
+     * values converted from a copy made by getAllParameters().
+     * @param visitor Receives each key and value
+     */
+    virtual void forEachParameter(const ParameterVisitor& visitor) const
+    {
+        for (const auto& [key, value] : getAllParameters()) visitor(key, ConfigValue::fromVariant(value));
+    }
+
+    /**
+     * @brief Get one configuration parameter
+     *
+     * The default implementation searches with forEachParameter().
+     * @param key Parameter name
+     * @return Value, or std::nullopt if the key is not set
+     */
+    virtual std::optional<ConfigValue> getParameter(const std::string& key) const
+    {
+        std::optional<ConfigValue> result;
+        forEachParameter(
+            [&key, &result](const std::string& name, const ConfigValue& value)
+            {
+                if (name == key)
+                    result = value;
+            });
+        return result;
+    }
+
     /**
      * @brief Set a configuration parameter
      * @param key Parameter name
@@ -36,6 +36,21 @@ class JsonConfigFileManager : public IConfigFileManager
      */
     [[nodiscard]] std::map<std::string, sdbus::Variant> load(const std::string&) override;
 
+    /**
+     * @brief Load a configuration layer from JSON file
+     * @param path Path to JSON layer file
+     * @return std::map<std::string, sdbus::Variant> Parsed layer, possibly without Timeout/TimeoutPhrase
+     * @throw std::runtime_error If file is missing or malformed
+     */
+    [[nodiscard]] std::map<std::string, sdbus::Variant> loadLayer(const std::string&) override;
+
+    /**
+     * @brief Check that a merged configuration has a valid Timeout and TimeoutPhrase
+     * @param config Effective configuration
+     * @throw std::runtime_error If validation fails
+     */
+    void validate(const std::map<std::string, sdbus::Variant>&) override;
+
     /**
      * @brief Save configuration to JSON file
      * @param path Destination file path
@@ -47,6 +62,21 @@ class JsonConfigFileManager : public IConfigFileManager
     void save(const std::string&, const std::map<std::string, sdbus::Variant>&) override;
 
    private:
+    /**
+     * @brief Read and parse a JSON file
+     * @param path Path to JSON file
+     * @return nlohmann::json Parsed document
+     * @throw std::runtime_error If file is missing or malformed
+     */
+    [[nodiscard]] static nlohmann::json readJson(const std::string&);
+
+    /**
+     * @brief Convert a JSON object to a configuration map
+     * @param j Parsed JSON object
+     * @return std::map<std::string, sdbus::Variant> Converted configuration
+     */
+    [[nodiscard]] static std::map<std::string, sdbus::Variant> toConfig(const nlohmann::json&);
+
     /**
      * @brief Convert sdbus::Variant to nlohmann::json
      * @param variant Source variant value
@@ -37,7 +37,7 @@ nlohmann::json JsonConfigFileManager::variantToJson(const sdbus::Variant& varian
     throw std::runtime_error(UNSUPPORTED_VAR);
 }
 
-std::map<std::string, sdbus::Variant> JsonConfigFileManager::load(const std::string& file_path)
+nlohmann::json JsonConfigFileManager::readJson(const std::string& file_path)
 {
     std::ifstream file(file_path);
     if (!file.is_open())
@@ -47,11 +47,7 @@ std::map<std::string, sdbus::Variant> JsonConfigFileManager::load(const std::str
     {
         nlohmann::json j;
         file >> j;
-        validateConfig(j);
-
-        std::map<std::string, sdbus::Variant> config;
-        for (auto& [key, value] : j.items()) config[key] = jsonToVariant(value);
-        return config;
+        return j;
     }
     catch (const nlohmann::json::exception& e)
     {
@@ -59,6 +55,39 @@ std::map<std::string, sdbus::Variant> JsonConfigFileManager::load(const std::str
     }
 }
 
+std::map<std::string, sdbus::Variant> JsonConfigFileManager::toConfig(const nlohmann::json& j)
+{
+    if (!j.is_object())
+        throw std::runtime_error(UNSUPPORTED_JS);
+
+    std::map<std::string, sdbus::Variant> config;
+    for (auto& [key, value] : j.items()) config[key] = jsonToVariant(value);
+    return config;
+}
+
+std::map<std::string, sdbus::Variant> JsonConfigFileManager::load(const std::string& file_path)
+{
+    const auto j = readJson(file_path);
+    validateConfig(j);
+    return toConfig(j);
+}
+
+std::map<std::string, sdbus::Variant> JsonConfigFileManager::loadLayer(const std::string& file_path)
+{
+    return toConfig(readJson(file_path));
+}
+
+void JsonConfigFileManager::validate(const std::map<std::string, sdbus::Variant>& config)
+{
+    const auto timeout = config.find("Timeout");
+    if (timeout == config.end() || !timeout->second.containsValueOfType<uint32_t>())
+        throw std::runtime_error(MISSING_TM);
+
+    const auto phrase = config.find("TimeoutPhrase");
+    if (phrase == config.end() || !phrase->second.containsValueOfType<std::string>())
+        throw std::runtime_error(MISSING_TM_PHRASE);
+}
+
 void JsonConfigFileManager::save(const std::string& file_path, const std::map<std::string, sdbus::Variant>& config)
 {
     nlohmann::json j;
@@ -0,0 +1,260 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+
+static const std::string ERROR_LOG_LEVEL = "Unknown log level: ";
+static const std::string LOG_LEVEL_ENV = "CONFIG_MANAGER_LOG_LEVEL";
+
+/**
+ * @enum LogLevel
+ * @brief Severity of a log record, records below the logger level are skipped
+ */
+enum class LogLevel : uint8_t
+{
+    Debug,
+    Info,
+    Warning,
+    Error
+};
+
+/**
+ * @class LogLine
+ * @brief Fixed-capacity text buffer a log record is formatted into
+ *
+ * Appending never allocates; text that does not fit is cut off.
+ */
+class LogLine
+{
+   public:
+    static constexpr std::size_t CAPACITY = 240;
+
+    /**
+     * @brief Append text
+     * @param text Text to append
+     */
+    void append(std::string_view) noexcept;
+
+    void append(const char* text) noexcept { append(std::string_view(text)); }
+
+    void append(const std::string& text) noexcept { append(std::string_view(text)); }
+
+    void append(char value) noexcept { append(std::string_view(&value, 1)); }
+
+    void append(bool value) noexcept { append(value ? std::string_view("true") : std::string_view("false")); }
+
+    /**
+     * @brief Append a number in its shortest decimal form
+     * @param value Integer or floating point value
+     */
+    template <typename T>
+        requires std::is_arithmetic_v<T>
+    void append(T value) noexcept
+    {
+        const auto result = std::to_chars(text_.data() + size_, text_.data() + CAPACITY, value);
+        if (result.ec == std::errc())
+            size_ = static_cast<std::size_t>(result.ptr - text_.data());
+    }
+
+    /**
+     * @brief Discard the buffered text
+     */
+    void clear() noexcept { size_ = 0; }
+
+    /**
+     * @brief Get the buffered text
+     * @return View into the buffer
+     */
+    [[nodiscard]] std::string_view view() const noexcept { return {text_.data(), size_}; }
+
+   private:
+    std::array<char, CAPACITY> text_;
+    std::size_t size_ = 0;
+};
+
+/**
+ * @class Logger
+ * @brief Asynchronous process-wide logger
+ *
+ * Records are formatted straight into the slots of a bounded lock-free
+ * multi-producer ring (Vyukov's sequence-numbered queue) and written out by a
+ * background thread, so logging from a D-Bus dispatch thread costs a few
+ * atomic operations and no I/O. When the ring is full the record is dropped
+ * and counted instead of blocking the caller.
+ */
+class Logger
+{
+   public:
+    using Sink = std::function<void(LogLevel, std::string_view)>;
+
+    static constexpr std::size_t CAPACITY = 1024;
+
+    /**
+     * @brief Get the process-wide logger
+     *
+     * The initial level is taken from `CONFIG_MANAGER_LOG_LEVEL` (Info by default).
+     * @return Logger instance
+     */
+    static Logger& instance();
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    /**
+     * @brief Stop the background thread after writing all queued records
+     */
+    ~Logger();
+
+    /**
+     * @brief Parse a level name
+     * @param name One of debug, info, warning, error
+     * @return Parsed level
+     * @throw std::runtime_error For unknown names
+     */
+    static LogLevel parseLevel(std::string_view);
+
+    /**
+     * @brief Set the minimum level of records to keep
+     * @param level New minimum level
+     */
+    void setLevel(LogLevel) noexcept;
+
+    /**
+     * @brief Get the minimum level of records to keep
+     * @return Current minimum level
+     */
+    [[nodiscard]] LogLevel level() const noexcept;
+
+    /**
+     * @brief Check whether records of a level are kept
+     *
+     * Lets callers skip building expensive messages that would be dropped anyway.
+     * @param level Level to check
+     * @return true if records of this level are written
+     */
+    [[nodiscard]] bool enabled(LogLevel level) const noexcept
+    {
+        return level >= level_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Queue a record built from the concatenation of its arguments
+     * @param level Record level
+     * @param args Strings, characters, booleans and numbers
+     */
+    template <typename... Args>
+    void log(LogLevel level, const Args&... args) noexcept
+    {
+        if (!enabled(level))
+            return;
+
+        Slot* slot = acquireSlot();
+        if (!slot)
+            return;
+
+        slot->level = level;
+        slot->line.clear();
+        (slot->line.append(args), ...);
+        commitSlot(slot);
+    }
+
+    template <typename... Args>
+    void debug(const Args&... args) noexcept
+    {
+        log(LogLevel::Debug, args...);
+    }
+
+    template <typename... Args>
+    void info(const Args&... args) noexcept
+    {
+        log(LogLevel::Info, args...);
+    }
+
+    template <typename... Args>
+    void warning(const Args&... args) noexcept
+    {
+        log(LogLevel::Warning, args...);
+    }
+
+    template <typename... Args>
+    void error(const Args&... args) noexcept
+    {
+        log(LogLevel::Error, args...);
+    }
+
+    /**
+     * @brief Replace the output of the background thread
+     * @param sink Receives every record; an empty sink restores console output
+     */
+    void setSink(Sink);
+
+    /**
+     * @brief Wait until every record queued so far has been written
+     */
+    void flush();
+
+    /**
+     * @brief Get the number of records dropped because the ring was full
+     * @return Dropped record count
+     */
+    [[nodiscard]] uint64_t dropped() const noexcept;
+
+   private:
+    struct alignas(64) Slot
+    {
+        std::atomic<std::size_t> sequence;
+        LogLevel level;
+        LogLine line;
+    };
+
+    Logger();
+
+    /**
+     * @brief Reserve the next free slot
+     * @return Slot owned by the caller, or nullptr if the ring is full
+     */
+    Slot* acquireSlot() noexcept;
+
+    /**
+     * @brief Hand a filled slot over to the background thread
+     * @param slot Slot returned by acquireSlot
+     */
+    void commitSlot(Slot*) noexcept;
+
+    /**
+     * @brief Background thread body
+     * @param stop_token Requests the thread to finish
+     */
+    void drain(std::stop_token);
+
+    /**
+     * @brief Write out all committed records
+     * @return Number of records written
+     */
+    std::size_t drainAvailable();
+
+    /**
+     * @brief Default sink: Debug and Info to stdout, Warning and Error to stderr
+     */
+    static void writeToConsole(LogLevel, std::string_view);
+
+    std::unique_ptr<Slot[]> slots_;
+    alignas(64) std::atomic<std::size_t> enqueue_pos_{0};
+    alignas(64) std::atomic<std::size_t> dequeue_pos_{0};
+    std::atomic<uint32_t> wakeups_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<LogLevel> level_{LogLevel::Info};
+
+    std::mutex sink_mutex_;
+    Sink sink_;
+    std::jthread drainer_;
+};
\ No newline at end of file
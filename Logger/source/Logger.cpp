@@ -0,0 +1,161 @@
+#include "Logger/Logger.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+static_assert((Logger::CAPACITY & (Logger::CAPACITY - 1)) == 0, "Ring capacity must be a power of two");
+
+void LogLine::append(std::string_view text) noexcept
+{
+    const std::size_t length = std::min(text.size(), CAPACITY - size_);
+    std::memcpy(text_.data() + size_, text.data(), length);
+    size_ += length;
+}
+
+Logger& Logger::instance()
+{
+    static Logger logger;
+    return logger;
+}
+
+Logger::Logger() : slots_(std::make_unique<Slot[]>(CAPACITY))
+{
+    for (std::size_t i = 0; i < CAPACITY; ++i) slots_[i].sequence.store(i, std::memory_order_relaxed);
+
+    if (const char* level = std::getenv(LOG_LEVEL_ENV.c_str()))
+    {
+        try
+        {
+            level_.store(parseLevel(level), std::memory_order_relaxed);
+        }
+        catch (const std::runtime_error&)
+        {
+        }
+    }
+
+    drainer_ = std::jthread([this](std::stop_token stop_token) { drain(stop_token); });
+}
+
+Logger::~Logger()
+{
+    drainer_.request_stop();
+    wakeups_.fetch_add(1);
+    wakeups_.notify_all();
+    drainer_.join();
+}
+
+LogLevel Logger::parseLevel(std::string_view name)
+{
+    if (name == "debug")
+        return LogLevel::Debug;
+    if (name == "info")
+        return LogLevel::Info;
+    if (name == "warning")
+        return LogLevel::Warning;
+    if (name == "error")
+        return LogLevel::Error;
+    throw std::runtime_error(ERROR_LOG_LEVEL + std::string(name));
+}
+
+void Logger::setLevel(LogLevel level) noexcept { level_.store(level, std::memory_order_relaxed); }
+
+LogLevel Logger::level() const noexcept { return level_.load(std::memory_order_relaxed); }
+
+uint64_t Logger::dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
+Logger::Slot* Logger::acquireSlot() noexcept
+{
+    std::size_t position = enqueue_pos_.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        Slot& slot = slots_[position & (CAPACITY - 1)];
+        const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        const auto difference = static_cast<std::ptrdiff_t>(sequence - position);
+
+        if (difference == 0)
+        {
+            if (enqueue_pos_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                return &slot;
+        }
+        else if (difference < 0)
+        {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        else
+        {
+            position = enqueue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void Logger::commitSlot(Slot* slot) noexcept
+{
+    // The slot still carries the sequence equal to its reserved position
+    slot->sequence.store(slot->sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    wakeups_.fetch_add(1);
+    wakeups_.notify_one();
+}
+
+void Logger::drain(std::stop_token stop_token)
+{
+    while (!stop_token.stop_requested())
+    {
+        const uint32_t seen = wakeups_.load();
+        if (drainAvailable() == 0)
+            wakeups_.wait(seen);
+    }
+    drainAvailable();
+}
+
+std::size_t Logger::drainAvailable()
+{
+    std::lock_guard<std::mutex> lock(sink_mutex_);
+
+    std::size_t position = dequeue_pos_.load(std::memory_order_relaxed);
+    std::size_t written = 0;
+    for (;; ++position, ++written)
+    {
+        Slot& slot = slots_[position & (CAPACITY - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != position + 1)
+            break;
+
+        if (sink_)
+            sink_(slot.level, slot.line.view());
+        else
+            writeToConsole(slot.level, slot.line.view());
+        slot.sequence.store(position + CAPACITY, std::memory_order_release);
+    }
+
+    if (written != 0 && !sink_)
+        std::fflush(nullptr);
+    dequeue_pos_.store(position, std::memory_order_release);
+    return written;
+}
+
+void Logger::writeToConsole(LogLevel level, std::string_view text)
+{
+    std::FILE* stream = level >= LogLevel::Warning ? stderr : stdout;
+    std::fwrite(text.data(), 1, text.size(), stream);
+    std::fputc('\n', stream);
+}
+
+void Logger::setSink(Sink sink)
+{
+    std::lock_guard<std::mutex> lock(sink_mutex_);
+    sink_ = std::move(sink);
+}
+
+void Logger::flush()
+{
+    const std::size_t target = enqueue_pos_.load(std::memory_order_acquire);
+    while (dequeue_pos_.load(std::memory_order_acquire) < target)
+    {
+        wakeups_.fetch_add(1);
+        wakeups_.notify_one();
+        std::this_thread::yield();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+static const std::string ERROR_METRICS_WRITE = "Cannot write metrics file: ";
+
+/**
+ * @class Counter
+ * @brief Monotonic counter sharded per thread
+ *
+ * Every thread increments its own cache-line aligned slot with a relaxed
+ * atomic add, so concurrent writers never contend. Reading sums all slots.
+ */
+class Counter
+{
+   public:
+    /**
+     * @brief Add to the counter
+     * @param delta Amount to add
+     */
+    void increment(uint64_t delta = 1) noexcept;
+
+    /**
+     * @brief Get the current counter value
+     * @return Sum over all thread slots
+     */
+    [[nodiscard]] uint64_t value() const noexcept;
+
+   private:
+    static constexpr std::size_t SHARDS = 16;
+
+    struct alignas(64) Shard
+    {
+        std::atomic<uint64_t> value{0};
+    };
+
+    std::array<Shard, SHARDS> shards_;
+};
+
+/**
+ * @struct HistogramSnapshot
+ * @brief Point-in-time copy of a LatencyHistogram
+ */
+struct HistogramSnapshot
+{
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    std::vector<uint64_t> buckets;
+
+    /**
+     * @brief Estimate a quantile
+     * @param quantile Value in range [0, 1]
+     * @return Upper bound (in nanoseconds) of the bucket holding the quantile
+     */
+    [[nodiscard]] uint64_t percentile(double) const;
+};
+
+/**
+ * @class LatencyHistogram
+ * @brief HDR-style log-linear histogram of durations in nanoseconds
+ *
+ * Values below 2^SUB_BITS are counted exactly, larger values fall into one of
+ * 2^SUB_BITS linear sub-buckets per power of two, giving a relative error of
+ * at most 1/2^SUB_BITS. Recording is two relaxed atomic adds.
+ */
+class LatencyHistogram
+{
+   public:
+    static constexpr unsigned SUB_BITS = 3;
+    static constexpr unsigned MAX_BITS = 36;
+    static constexpr std::size_t SUB_COUNT = std::size_t{1} << SUB_BITS;
+    static constexpr std::size_t BUCKET_COUNT = SUB_COUNT + (MAX_BITS - SUB_BITS + 1) * SUB_COUNT;
+
+    /**
+     * @brief Record a duration
+     * @param nanoseconds Duration to record, clamped to 2^MAX_BITS
+     */
+    void record(uint64_t) noexcept;
+
+    /**
+     * @brief Record a duration
+     * @param duration Duration to record
+     */
+    void record(std::chrono::nanoseconds duration) noexcept { record(static_cast<uint64_t>(duration.count())); }
+
+    /**
+     * @brief Copy the current bucket counts
+     * @return Histogram snapshot
+     */
+    [[nodiscard]] HistogramSnapshot snapshot() const;
+
+    /**
+     * @brief Get the bucket index a value falls into
+     * @param nanoseconds Value to classify
+     * @return Bucket index in range [0, BUCKET_COUNT)
+     */
+    [[nodiscard]] static std::size_t bucketIndex(uint64_t) noexcept;
+
+    /**
+     * @brief Get the largest value belonging to a bucket
+     * @param index Bucket index
+     * @return Inclusive upper bound in nanoseconds
+     */
+    [[nodiscard]] static uint64_t bucketUpperBound(std::size_t) noexcept;
+
+   private:
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets_{};
+    std::atomic<uint64_t> sum_{0};
+};
+
+/**
+ * @class ScopedTimer
+ * @brief Records the lifetime of the scope into a histogram
+ */
+class ScopedTimer
+{
+   public:
+    /**
+     * @brief Start timing
+     * @param histogram Destination histogram, nullptr disables timing
+     */
+    explicit ScopedTimer(LatencyHistogram* histogram)
+        : histogram_(histogram),
+          start_(histogram ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{})
+    {
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    ~ScopedTimer()
+    {
+        if (histogram_)
+            histogram_->record(std::chrono::steady_clock::now() - start_);
+    }
+
+   private:
+    LatencyHistogram* histogram_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+/**
+ * @class MetricsRegistry
+ * @brief Process-wide registry of named counters and histograms
+ *
+ * Metrics are looked up once (under a mutex) and the returned references stay
+ * valid for the lifetime of the process, so hot paths keep the reference and
+ * never touch the registry again.
+ */
+class MetricsRegistry
+{
+   public:
+    using Labels = std::map<std::string, std::string>;
+
+    /**
+     * @brief Get the process-wide registry
+     * @return Registry instance
+     */
+    static MetricsRegistry& instance();
+
+    /**
+     * @brief Get or create a counter
+     * @param name Metric name
+     * @param labels Label set distinguishing the series
+     * @return Counter reference valid for the registry lifetime
+     */
+    Counter& counter(const std::string&, const Labels& = {});
+
+    /**
+     * @brief Get or create a latency histogram
+     * @param name Metric name
+     * @param labels Label set distinguishing the series
+     * @return Histogram reference valid for the registry lifetime
+     */
+    LatencyHistogram& histogram(const std::string&, const Labels& = {});
+
+    /**
+     * @brief Get all counter values
+     * @return Map of series identifier (`name{labels}`) to value
+     */
+    [[nodiscard]] std::map<std::string, uint64_t> counterValues() const;
+
+    /**
+     * @brief Get snapshots of all histograms
+     * @return Map of series identifier (`name{labels}`) to snapshot
+     */
+    [[nodiscard]] std::map<std::string, HistogramSnapshot> histogramSnapshots() const;
+
+    /**
+     * @brief Render all metrics in Prometheus text exposition format
+     * @return Exposition text, histogram values in seconds
+     */
+    [[nodiscard]] std::string renderPrometheus() const;
+
+    /**
+     * @brief Atomically write the Prometheus text to a file
+     * @param path Destination file path
+     * @throw std::runtime_error If the file cannot be written
+     */
+    void dumpPrometheus(const std::string&) const;
+
+   private:
+    template <typename Metric>
+    using Family = std::map<std::string, std::map<std::string, std::unique_ptr<Metric>>>;
+
+    mutable std::mutex mutex_;
+    Family<Counter> counters_;
+    Family<LatencyHistogram> histograms_;
+};
\ No newline at end of file
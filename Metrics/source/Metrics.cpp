@@ -0,0 +1,209 @@
+#include "Metrics/Metrics.hpp"
+
+#include <bit>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+static std::size_t shardIndex() noexcept
+{
+    static std::atomic<std::size_t> next{0};
+    thread_local const std::size_t index = next.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+static std::string escapeLabel(const std::string& value)
+{
+    std::string result;
+    result.reserve(value.size());
+    for (char c : value)
+    {
+        if (c == '\\' || c == '"')
+            result += '\\';
+        if (c == '\n')
+        {
+            result += "\\n";
+            continue;
+        }
+        result += c;
+    }
+    return result;
+}
+
+static std::string renderLabels(const MetricsRegistry::Labels& labels)
+{
+    if (labels.empty())
+        return {};
+
+    std::string result = "{";
+    for (const auto& [key, value] : labels)
+    {
+        if (result.size() > 1)
+            result += ',';
+        result += key + "=\"" + escapeLabel(value) + '"';
+    }
+    return result + '}';
+}
+
+void Counter::increment(uint64_t delta) noexcept
+{
+    shards_[shardIndex() % SHARDS].value.fetch_add(delta, std::memory_order_relaxed);
+}
+
+uint64_t Counter::value() const noexcept
+{
+    uint64_t total = 0;
+    for (const auto& shard : shards_) total += shard.value.load(std::memory_order_relaxed);
+    return total;
+}
+
+std::size_t LatencyHistogram::bucketIndex(uint64_t value) noexcept
+{
+    if (value < SUB_COUNT)
+        return static_cast<std::size_t>(value);
+
+    const unsigned msb = std::bit_width(value) - 1;
+    if (msb > MAX_BITS)
+        return BUCKET_COUNT - 1;
+
+    const unsigned shift = msb - SUB_BITS;
+    const uint64_t mantissa = (value >> shift) & (SUB_COUNT - 1);
+    return SUB_COUNT + shift * SUB_COUNT + static_cast<std::size_t>(mantissa);
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(std::size_t index) noexcept
+{
+    if (index < SUB_COUNT)
+        return index;
+
+    const std::size_t shift = (index - SUB_COUNT) / SUB_COUNT;
+    const uint64_t mantissa = (index - SUB_COUNT) % SUB_COUNT;
+    return ((SUB_COUNT | mantissa) << shift) + ((uint64_t{1} << shift) - 1);
+}
+
+void LatencyHistogram::record(uint64_t value) noexcept
+{
+    buckets_[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(value, std::memory_order_relaxed);
+}
+
+HistogramSnapshot LatencyHistogram::snapshot() const
+{
+    HistogramSnapshot result;
+    result.buckets.resize(BUCKET_COUNT);
+    for (std::size_t i = 0; i < BUCKET_COUNT; ++i)
+    {
+        result.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+        result.count += result.buckets[i];
+    }
+    result.sum = sum_.load(std::memory_order_relaxed);
+    return result;
+}
+
+uint64_t HistogramSnapshot::percentile(double quantile) const
+{
+    if (count == 0)
+        return 0;
+
+    const auto rank = static_cast<uint64_t>(quantile * static_cast<double>(count - 1)) + 1;
+    uint64_t seen = 0;
+    for (std::size_t i = 0; i < buckets.size(); ++i)
+    {
+        seen += buckets[i];
+        if (seen >= rank)
+            return LatencyHistogram::bucketUpperBound(i);
+    }
+    return LatencyHistogram::bucketUpperBound(buckets.size() - 1);
+}
+
+MetricsRegistry& MetricsRegistry::instance()
+{
+    static MetricsRegistry registry;
+    return registry;
+}
+
+Counter& MetricsRegistry::counter(const std::string& name, const Labels& labels)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& slot = counters_[name][renderLabels(labels)];
+    if (!slot)
+        slot = std::make_unique<Counter>();
+    return *slot;
+}
+
+LatencyHistogram& MetricsRegistry::histogram(const std::string& name, const Labels& labels)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& slot = histograms_[name][renderLabels(labels)];
+    if (!slot)
+        slot = std::make_unique<LatencyHistogram>();
+    return *slot;
+}
+
+std::map<std::string, uint64_t> MetricsRegistry::counterValues() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::map<std::string, uint64_t> result;
+    for (const auto& [name, series] : counters_)
+        for (const auto& [labels, counter] : series) result[name + labels] = counter->value();
+    return result;
+}
+
+std::map<std::string, HistogramSnapshot> MetricsRegistry::histogramSnapshots() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::map<std::string, HistogramSnapshot> result;
+    for (const auto& [name, series] : histograms_)
+        for (const auto& [labels, histogram] : series) result[name + labels] = histogram->snapshot();
+    return result;
+}
+
+std::string MetricsRegistry::renderPrometheus() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::ostringstream out;
+
+    for (const auto& [name, series] : counters_)
+    {
+        out << "# TYPE " << name << " counter\n";
+        for (const auto& [labels, counter] : series) out << name << labels << ' ' << counter->value() << '\n';
+    }
+
+    for (const auto& [name, series] : histograms_)
+    {
+        out << "# TYPE " << name << " histogram\n";
+        for (const auto& [labels, histogram] : series)
+        {
+            const auto snapshot = histogram->snapshot();
+            // Labels are rendered as `{...}`; `le` has to be merged into the same set.
+            const std::string prefix = labels.empty() ? "{" : labels.substr(0, labels.size() - 1) + ',';
+
+            uint64_t cumulative = 0;
+            for (std::size_t i = 0; i < snapshot.buckets.size(); ++i)
+            {
+                if (snapshot.buckets[i] == 0)
+                    continue;
+                cumulative += snapshot.buckets[i];
+                out << name << "_bucket" << prefix << "le=\""
+                    << static_cast<double>(LatencyHistogram::bucketUpperBound(i)) / 1e9 << "\"} " << cumulative << '\n';
+            }
+            out << name << "_bucket" << prefix << "le=\"+Inf\"} " << snapshot.count << '\n';
+            out << name << "_sum" << labels << ' ' << static_cast<double>(snapshot.sum) / 1e9 << '\n';
+            out << name << "_count" << labels << ' ' << snapshot.count << '\n';
+        }
+    }
+    return out.str();
+}
+
+void MetricsRegistry::dumpPrometheus(const std::string& path) const
+{
+    const std::string text = renderPrometheus();
+    const std::string temp_path = path + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::trunc);
+        if (!file || !(file << text))
+            throw std::runtime_error(ERROR_METRICS_WRITE + temp_path);
+    }
+    std::filesystem::rename(temp_path, path);
+}
\ No newline at end of file
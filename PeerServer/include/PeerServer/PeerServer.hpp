@@ -0,0 +1,89 @@
+#pragma once
+
+#include <sdbus-c++/sdbus-c++.h>
+
+#include <atomic>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <thread>
+
+static const std::string ERROR_SOCKET = "Cannot listen on peer socket: ";
+
+/**
+ * @class PeerServer
+ * @brief Accepts direct D-Bus peer connections on a private unix socket
+ *
+ * Each accepted client gets its own server-side sdbus connection with a
+ * dedicated event loop thread, so calls and signals skip the bus daemon.
+ * The owner is notified when a peer connects (to register objects on it)
+ * and after it disconnects (to drop them again).
+ */
+class PeerServer
+{
+   public:
+    using ConnectionHandler = std::function<void(sdbus::IConnection&)>;
+
+    /**
+     * @brief Construct a new PeerServer
+     * @param socket_path Filesystem path of the listening socket
+     * @param on_connect Called for every new peer before its event loop starts
+     * @param on_disconnect Called after a peer's event loop has finished
+     */
+    PeerServer(std::string, ConnectionHandler, ConnectionHandler);
+
+    PeerServer(const PeerServer&) = delete;
+    PeerServer& operator=(const PeerServer&) = delete;
+
+    /**
+     * @brief Stop accepting, close all peers and remove the socket file
+     */
+    ~PeerServer();
+
+    /**
+     * @brief Bind the socket and start accepting peers in the background
+     * @throws std::runtime_error if the socket cannot be created
+     */
+    void start();
+
+    /**
+     * @brief Invoke a function for every live peer connection
+     * @param function Function to call
+     */
+    void forEachConnection(const ConnectionHandler&);
+
+   private:
+    /**
+     * @struct Peer
+     * @brief One accepted connection and its event loop thread
+     */
+    struct Peer
+    {
+        std::unique_ptr<sdbus::IConnection> connection;
+        std::thread loop;
+        std::atomic<bool> closed{false};
+    };
+
+    /**
+     * @brief Accept connections until stop is requested
+     * @param stop_token Stop request of the accept thread
+     */
+    void acceptLoop(std::stop_token);
+
+    /**
+     * @brief Join and release peers whose event loop has finished
+     * @param all Also stop peers that are still running
+     */
+    void reapPeers(bool);
+
+    std::string socket_path_;
+    ConnectionHandler on_connect_;
+    ConnectionHandler on_disconnect_;
+    int listen_fd_ = -1;
+    std::mutex mutex_;
+    std::list<Peer> peers_;
+    std::jthread accept_thread_;
+};
\ No newline at end of file
@@ -0,0 +1,145 @@
+#include "PeerServer/PeerServer.hpp"
+
+#include <Logger/Logger.hpp>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+static constexpr int ACCEPT_POLL_MS = 200;
+
+PeerServer::PeerServer(std::string socket_path, ConnectionHandler on_connect, ConnectionHandler on_disconnect)
+    : socket_path_(std::move(socket_path)), on_connect_(std::move(on_connect)), on_disconnect_(std::move(on_disconnect))
+{
+}
+
+PeerServer::~PeerServer()
+{
+    if (accept_thread_.joinable())
+    {
+        accept_thread_.request_stop();
+        accept_thread_.join();
+    }
+    reapPeers(true);
+
+    if (listen_fd_ >= 0)
+    {
+        ::close(listen_fd_);
+        ::unlink(socket_path_.c_str());
+    }
+}
+
+void PeerServer::start()
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socket_path_.size() >= sizeof(address.sun_path))
+        throw std::runtime_error(ERROR_SOCKET + socket_path_ + " (path too long)");
+    std::strncpy(address.sun_path, socket_path_.c_str(), sizeof(address.sun_path) - 1);
+
+    listen_fd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0)
+        throw std::runtime_error(ERROR_SOCKET + socket_path_ + ": " + std::strerror(errno));
+
+    ::unlink(socket_path_.c_str());
+    if (::bind(listen_fd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0 ||
+        ::chmod(socket_path_.c_str(), S_IRUSR | S_IWUSR) < 0 || ::listen(listen_fd_, SOMAXCONN) < 0)
+    {
+        const std::string reason = std::strerror(errno);
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        throw std::runtime_error(ERROR_SOCKET + socket_path_ + ": " + reason);
+    }
+
+    accept_thread_ = std::jthread([this](std::stop_token stop_token) { acceptLoop(stop_token); });
+}
+
+void PeerServer::forEachConnection(const ConnectionHandler& function)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& peer : peers_)
+        if (!peer.closed)
+            function(*peer.connection);
+}
+
+void PeerServer::acceptLoop(std::stop_token stop_token)
+{
+    while (!stop_token.stop_requested())
+    {
+        reapPeers(false);
+
+        pollfd descriptor{listen_fd_, POLLIN, 0};
+        if (::poll(&descriptor, 1, ACCEPT_POLL_MS) <= 0 || !(descriptor.revents & POLLIN))
+            continue;
+
+        const int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0)
+            continue;
+
+        std::unique_ptr<sdbus::IConnection> connection;
+        try
+        {
+            // The server bus owns the descriptor from here on, also on failure.
+            connection = sdbus::createServerBus(fd);
+        }
+        catch (const sdbus::Error& e)
+        {
+            Logger::instance().error("Error accepting peer connection: ", e.what());
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& peer = peers_.emplace_back();
+        peer.connection = std::move(connection);
+        try
+        {
+            on_connect_(*peer.connection);
+        }
+        catch (const std::exception& e)
+        {
+            Logger::instance().error("Error registering peer connection: ", e.what());
+            on_disconnect_(*peer.connection);
+            peers_.pop_back();
+            continue;
+        }
+
+        peer.loop = std::thread(
+            [&peer]
+            {
+                try
+                {
+                    peer.connection->enterEventLoop();
+                }
+                catch (const sdbus::Error&)
+                {
+                    // The peer hung up; the connection is reaped by the accept loop.
+                }
+                peer.closed = true;
+            });
+    }
+}
+
+void PeerServer::reapPeers(bool all)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = peers_.begin(); it != peers_.end();)
+    {
+        if (!all && !it->closed)
+        {
+            ++it;
+            continue;
+        }
+
+        if (!it->closed)
+            it->connection->leaveEventLoop();
+        if (it->loop.joinable())
+            it->loop.join();
+        on_disconnect_(*it->connection);
+        it = peers_.erase(it);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+static const std::string ERROR_RATE_LIMITED = "com.system.configurationManager.Error.RateLimited";
+
+/**
+ * @struct RateLimit
+ * @brief Token bucket parameters
+ */
+struct RateLimit
+{
+    double rate = 0;    ///< Calls per second refilled into the bucket, 0 disables the limit
+    double burst = 1;   ///< Bucket size: calls allowed at once after an idle period
+};
+
+/**
+ * @class RateLimiter
+ * @brief Per-sender token buckets
+ *
+ * Each sender (a D-Bus unique name such as `:1.42`) gets its own bucket,
+ * created full on its first call. Buckets that have refilled completely carry
+ * no state and are dropped when the table grows past MAX_IDLE_BUCKETS, so
+ * short-lived senders do not accumulate.
+ *
+ * Thread-safe.
+ */
+class RateLimiter
+{
+   public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::size_t MAX_IDLE_BUCKETS = 4096;
+
+    /**
+     * @brief Construct a limiter
+     * @param limit Initial limit, unlimited by default
+     */
+    explicit RateLimiter(RateLimit = {});
+
+    /**
+     * @brief Replace the limit; existing buckets keep their tokens, clamped to the new burst
+     * @param limit New limit
+     */
+    void setLimit(RateLimit);
+
+    /**
+     * @brief Get the current limit
+     * @return Limit
+     */
+    [[nodiscard]] RateLimit limit() const;
+
+    /**
+     * @brief Take one token from a sender's bucket
+     * @param sender Sender identity
+     * @param now Current time
+     * @return false if the sender exceeded its rate and the call must be rejected
+     */
+    bool tryAcquire(const std::string&, Clock::time_point = Clock::now());
+
+    /**
+     * @brief Get the number of tracked senders
+     * @return Bucket count
+     */
+    [[nodiscard]] std::size_t senders() const;
+
+   private:
+    /**
+     * @struct Bucket
+     * @brief Tokens of one sender at the time of its last call
+     */
+    struct Bucket
+    {
+        double tokens;
+        Clock::time_point updated;
+    };
+
+    /**
+     * @brief Refill a bucket up to now, the lock is held
+     * @param bucket Bucket to refill
+     * @param now Current time
+     */
+    void refill(Bucket&, Clock::time_point) const;
+
+    /**
+     * @brief Drop the buckets that are full again, the lock is held
+     * @param now Current time
+     */
+    void pruneIdle(Clock::time_point);
+
+    mutable std::mutex mutex_;
+    RateLimit limit_;
+    std::unordered_map<std::string, Bucket> buckets_;
+};
\ No newline at end of file
@@ -0,0 +1,65 @@
+#include "RateLimiter/RateLimiter.hpp"
+
+#include <algorithm>
+
+RateLimiter::RateLimiter(RateLimit limit) : limit_(limit) {}
+
+void RateLimiter::setLimit(RateLimit limit)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    limit_ = limit;
+    for (auto& [sender, bucket] : buckets_) bucket.tokens = std::min(bucket.tokens, std::max(limit_.burst, 1.0));
+}
+
+RateLimit RateLimiter::limit() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return limit_;
+}
+
+void RateLimiter::refill(Bucket& bucket, Clock::time_point now) const
+{
+    const std::chrono::duration<double> elapsed = now - bucket.updated;
+    if (elapsed.count() > 0)
+    {
+        bucket.tokens = std::min(std::max(limit_.burst, 1.0), bucket.tokens + elapsed.count() * limit_.rate);
+        bucket.updated = now;
+    }
+}
+
+bool RateLimiter::tryAcquire(const std::string& sender, Clock::time_point now)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (limit_.rate <= 0)
+        return true;
+
+    auto it = buckets_.find(sender);
+    if (it == buckets_.end())
+    {
+        if (buckets_.size() >= MAX_IDLE_BUCKETS)
+            pruneIdle(now);
+        it = buckets_.emplace(sender, Bucket{std::max(limit_.burst, 1.0), now}).first;
+    }
+
+    refill(it->second, now);
+    if (it->second.tokens < 1)
+        return false;
+    it->second.tokens -= 1;
+    return true;
+}
+
+std::size_t RateLimiter::senders() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return buckets_.size();
+}
+
+void RateLimiter::pruneIdle(Clock::time_point now)
+{
+    const double full = std::max(limit_.burst, 1.0);
+    for (auto it = buckets_.begin(); it != buckets_.end();)
+    {
+        refill(it->second, now);
+        it = it->second.tokens >= full ? buckets_.erase(it) : std::next(it);
+    }
+}
\ No newline at end of file
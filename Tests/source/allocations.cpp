@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include <sdbus-c++/sdbus-c++.h>
+
+#include <AppConfig/AppConfig.hpp>
+#include <DBusConfigAdapter/DBusConfigAdapter.hpp>
+#include <cstddef>
+
+// Counts the heap allocations of the current thread, for read path allocation checks. malloc, calloc and realloc
+// are interposed rather than operator new, because sd-bus allocates with them directly (operator new ends up in
+// malloc as well). The replacement is global, so these tests live in their own executable and leave the main test
+// binary untouched
+static thread_local std::size_t allocations = 0;
+
+extern "C"
+{
+void* __libc_malloc(std::size_t);
+void* __libc_calloc(std::size_t, std::size_t);
+void* __libc_realloc(void*, std::size_t);
+void __libc_free(void*);
+
+void* malloc(std::size_t size)
+{
+    ++allocations;
+    return __libc_malloc(size);
+}
+
+void* calloc(std::size_t count, std::size_t size)
+{
+    ++allocations;
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* memory, std::size_t size)
+{
+    ++allocations;
+    return __libc_realloc(memory, size);
+}
+
+void free(void* memory) { __libc_free(memory); }
+}
+
+class AppConfigAllocationTest : public ::testing::Test
+{
+   protected:
+    std::map<std::string, sdbus::Variant> test_config{{"Timeout", sdbus::Variant(uint32_t{1000})},
+                                                      {"TimeoutPhrase", sdbus::Variant(std::string{"Test"})},
+                                                      {"DebugMode", sdbus::Variant(true)}};
+};
+
+TEST_F(AppConfigAllocationTest, ForEachParameterDoesNotAllocate)
+{
+    AppConfig config("testApp", test_config);
+
+    std::size_t visited = 0;
+    const std::size_t before = allocations;
+    config.forEachParameter([&visited](const std::string&, const ConfigValue&) { ++visited; });
+
+    EXPECT_EQ(allocations - before, 0);
+    EXPECT_EQ(visited, 3);
+}
+
+TEST_F(AppConfigAllocationTest, ConfigurationReplyAllocatesOnlyInsideSdBus)
+{
+    std::unique_ptr<sdbus::IConnection> connection;
+    try
+    {
+        connection = sdbus::createSessionBusConnection();
+    }
+    catch (const sdbus::Error& e)
+    {
+        GTEST_SKIP() << "No session bus: " << e.what();
+    }
+
+    for (int i = 0; i < 100; ++i) test_config.emplace("Key" + std::to_string(i), std::string(1000, 'v'));
+    DBusConfigAdapter adapter(std::make_unique<AppConfig>("testApp", test_config), *connection);
+
+    // What sd-bus itself needs: copying an identical sealed body into a fresh message
+    AppConfig same_config("testApp", test_config);
+    auto body = sdbus::createPlainMessage();
+    DBusConfigAdapter::marshalConfiguration(body, same_config);
+    body.seal();
+    const auto copyBody = [&body]
+    {
+        auto message = sdbus::createPlainMessage();
+        body.rewind(true);
+        const std::size_t before = allocations;
+        body.copyTo(message, true);
+        return allocations - before;
+    };
+    const auto fillReply = [&adapter]
+    {
+        auto reply = sdbus::createPlainMessage();
+        const std::size_t before = allocations;
+        adapter.appendConfigurationReply(reply);
+        return allocations - before;
+    };
+
+    // The first calls set up per-thread state such as metric shards
+    copyBody();
+    fillReply();
+
+    // Copies of keys or values, or marshalling from the storage again, would show up on top of sd-bus's own copy
+    EXPECT_EQ(fillReply(), copyBody());
+}
\ No newline at end of file
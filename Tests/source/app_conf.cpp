@@ -2,6 +2,7 @@
 #include <sdbus-c++/sdbus-c++.h>
 
 #include <AppConfig/AppConfig.hpp>
+#include <DBusConfigAdapter/DBusConfigAdapter.hpp>
 #include <thread>
 
 class AppConfigTest : public ::testing::Test
@@ -63,6 +64,17 @@ TEST_F(AppConfigTest, SetParameterAddsNewValue)
     EXPECT_EQ(params["RetryCount"].get<uint32_t>(), 3);
 }
 
+TEST_F(AppConfigTest, GetParameterReturnsSingleValue)
+{
+    AppConfig config("testApp", test_config);
+
+    EXPECT_EQ(config.getParameter("Timeout")->get<uint32_t>(), 1000u);
+    EXPECT_FALSE(config.getParameter("Missing").has_value());
+
+    config.setParameter("Timeout", sdbus::Variant(std::string{"never"}));
+    EXPECT_EQ(config.getParameter("Timeout")->asString(), "never");
+}
+
 TEST_F(AppConfigTest, ThreadSafetyCheck)
 {
     AppConfig config("testApp", test_config);
@@ -117,4 +129,4 @@ TEST_F(AppConfigTest, HandlesDifferentVariantTypes)
     EXPECT_EQ(params["UIntValue"].get<uint32_t>(), 42);
     EXPECT_EQ(params["StringValue"].get<std::string>(), "Hello");
     EXPECT_EQ(params["BoolValue"].get<bool>(), true);
-}
+}
\ No newline at end of file
@@ -0,0 +1,183 @@
+#include <gtest/gtest.h>
+
+#include <ConfConfigFileManager/ConfConfigFileManager.hpp>
+#include <ExtensionConfigFileManager/ExtensionConfigFileManager.hpp>
+#include <JsonConfigFileManager/JsonConfigFileManager.hpp>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+
+namespace fs = std::filesystem;
+
+class ConfConfigFileManagerTest : public ::testing::Test
+{
+   protected:
+    void SetUp() override
+    {
+        temp_dir = fs::temp_directory_path() / "conf_manager_test";
+        fs::create_directory(temp_dir);
+    }
+
+    void TearDown() override { fs::remove_all(temp_dir); }
+
+    fs::path temp_dir;
+};
+
+TEST_F(ConfConfigFileManagerTest, LoadValidConfig)
+{
+    const auto config_path = temp_dir / "valid.conf";
+    std::ofstream(config_path) << "# legacy player settings\n"
+                                  "Timeout = 1000\n"
+                                  "TimeoutPhrase = Hello there  ; greeting\n";
+
+    ConfConfigFileManager manager;
+    auto config = manager.load(config_path.string());
+
+    EXPECT_EQ(config["Timeout"].get<uint32_t>(), 1000);
+    EXPECT_EQ(config["TimeoutPhrase"].get<std::string>(), "Hello there");
+}
+
+TEST_F(ConfConfigFileManagerTest, InfersValueTypes)
+{
+    auto config = ConfConfigFileManager::parse("\xEF\xBB\xBF"
+                                               "Enabled=true\r\n"
+                                               "Offset = -5\n"
+                                               "Big = 5000000000\n"
+                                               "Ratio = 0.25\n"
+                                               "Quoted = \"42\"  # still a string\n"
+                                               "Escaped = \"a \\\"b\\\"\\n#c\"\n"
+                                               "Path = /tmp/a#b\n"
+                                               "Empty =\n"
+                                               "\n"
+                                               "[video]\n"
+                                               "Codec = h264\n"
+                                               "Timeout = 1\n"
+                                               "Timeout = 2\n",
+                                               "inline");
+
+    EXPECT_TRUE(config["Enabled"].get<bool>());
+    EXPECT_EQ(config["Offset"].get<int32_t>(), -5);
+    EXPECT_EQ(config["Big"].get<uint64_t>(), 5000000000ULL);
+    EXPECT_DOUBLE_EQ(config["Ratio"].get<double>(), 0.25);
+    EXPECT_EQ(config["Quoted"].get<std::string>(), "42");
+    EXPECT_EQ(config["Escaped"].get<std::string>(), "a \"b\"\n#c");
+    EXPECT_EQ(config["Path"].get<std::string>(), "/tmp/a#b");
+    EXPECT_EQ(config["Empty"].get<std::string>(), "");
+    EXPECT_EQ(config["video.Codec"].get<std::string>(), "h264");
+    EXPECT_EQ(config["video.Timeout"].get<uint32_t>(), 2);
+    EXPECT_EQ(config.size(), 10);
+}
+
+TEST_F(ConfConfigFileManagerTest, ReportsTheBrokenLine)
+{
+    try
+    {
+        (void)ConfConfigFileManager::parse("Timeout = 1\nTimeoutPhrase \"Hello\"\n", "broken.conf");
+        FAIL() << "Malformed line accepted";
+    }
+    catch (const std::runtime_error& e)
+    {
+        EXPECT_NE(std::string(e.what()).find("broken.conf:2"), std::string::npos) << e.what();
+    }
+
+    EXPECT_THROW((void)ConfConfigFileManager::parse("Phrase = \"open\n", "x"), std::runtime_error);
+    EXPECT_THROW((void)ConfConfigFileManager::parse("Phrase = \"a\" b\n", "x"), std::runtime_error);
+    EXPECT_THROW((void)ConfConfigFileManager::parse("[video\n", "x"), std::runtime_error);
+    EXPECT_THROW((void)ConfConfigFileManager::parse(" = 1\n", "x"), std::runtime_error);
+
+    ConfConfigFileManager manager;
+    EXPECT_THROW(manager.load("/nonexistent/file.conf"), std::runtime_error);
+}
+
+TEST_F(ConfConfigFileManagerTest, LoadMissingTimeout)
+{
+    const auto config_path = temp_dir / "missing_timeout.conf";
+    std::ofstream(config_path) << "TimeoutPhrase = Hello\n";
+
+    ConfConfigFileManager manager;
+    EXPECT_THROW(manager.load(config_path.string()), std::runtime_error);
+    EXPECT_NO_THROW(manager.loadLayer(config_path.string()));
+}
+
+TEST_F(ConfConfigFileManagerTest, SavedFileLoadsWithTheSameTypes)
+{
+    const auto config_path = temp_dir / "saved.conf";
+    const std::map<std::string, sdbus::Variant> config = {{"Timeout", sdbus::Variant(uint32_t{2000})},
+                                                          {"TimeoutPhrase", sdbus::Variant(std::string{"say \"hi\""})},
+                                                          {"Number", sdbus::Variant(std::string{"17"})},
+                                                          {"Offset", sdbus::Variant(int32_t{-3})},
+                                                          {"Ratio", sdbus::Variant(2.0)},
+                                                          {"Enabled", sdbus::Variant(false)}};
+
+    ConfConfigFileManager manager;
+    manager.save(config_path.string(), config);
+    auto loaded = manager.load(config_path.string());
+
+    EXPECT_EQ(loaded.size(), config.size());
+    EXPECT_EQ(loaded["Timeout"].get<uint32_t>(), 2000);
+    EXPECT_EQ(loaded["TimeoutPhrase"].get<std::string>(), "say \"hi\"");
+    EXPECT_EQ(loaded["Number"].get<std::string>(), "17");
+    EXPECT_EQ(loaded["Offset"].get<int32_t>(), -3);
+    EXPECT_DOUBLE_EQ(loaded["Ratio"].get<double>(), 2.0);
+    EXPECT_FALSE(loaded["Enabled"].get<bool>());
+}
+
+TEST_F(ConfConfigFileManagerTest, SavedNumbersKeepTheirTypes)
+{
+    const auto config_path = temp_dir / "typed.conf";
+    const std::map<std::string, sdbus::Variant> config = {
+        {"Byte", sdbus::Variant(uint8_t{7})},
+        {"Short", sdbus::Variant(int16_t{-3})},
+        {"Port", sdbus::Variant(uint16_t{8080})},
+        {"Count", sdbus::Variant(int32_t{5})},
+        {"Small64", sdbus::Variant(int64_t{-5})},
+        {"SmallU64", sdbus::Variant(uint64_t{5})},
+        {"Large64", sdbus::Variant(int64_t{-5000000000})},
+        {"NotANumber", sdbus::Variant(std::numeric_limits<double>::quiet_NaN())},
+        {"Infinity", sdbus::Variant(std::numeric_limits<double>::infinity())},
+        {"MinusInfinity", sdbus::Variant(-std::numeric_limits<double>::infinity())}};
+
+    ConfConfigFileManager manager;
+    manager.save(config_path.string(), config);
+    auto loaded = manager.loadLayer(config_path.string());
+
+    EXPECT_EQ(loaded.size(), config.size());
+    EXPECT_EQ(loaded["Byte"].get<uint8_t>(), 7);
+    EXPECT_EQ(loaded["Short"].get<int16_t>(), -3);
+    EXPECT_EQ(loaded["Port"].get<uint16_t>(), 8080);
+    EXPECT_EQ(loaded["Count"].get<int32_t>(), 5);
+    EXPECT_EQ(loaded["Small64"].get<int64_t>(), -5);
+    EXPECT_EQ(loaded["SmallU64"].get<uint64_t>(), 5);
+    EXPECT_EQ(loaded["Large64"].get<int64_t>(), -5000000000);
+    EXPECT_TRUE(std::isnan(loaded["NotANumber"].get<double>()));
+    EXPECT_EQ(loaded["Infinity"].get<double>(), std::numeric_limits<double>::infinity());
+    EXPECT_EQ(loaded["MinusInfinity"].get<double>(), -std::numeric_limits<double>::infinity());
+}
+
+TEST_F(ConfConfigFileManagerTest, TypeAnnotationNeedsAValidNumber)
+{
+    const auto config = ConfConfigFileManager::parse("A = uint16 8080\nB = byte 300\nC = double trouble\n", "x.conf");
+
+    EXPECT_EQ(config.at("A").get<uint16_t>(), 8080);
+    EXPECT_EQ(config.at("B").get<std::string>(), "byte 300");
+    EXPECT_EQ(config.at("C").get<std::string>(), "double trouble");
+}
+
+TEST_F(ConfConfigFileManagerTest, ExtensionSelectsTheFormat)
+{
+    std::ofstream(temp_dir / "legacy.conf") << "Timeout = 1000\nTimeoutPhrase = Legacy\n";
+    std::ofstream(temp_dir / "modern.json") << R"({"Timeout": 500, "TimeoutPhrase": "Modern"})";
+
+    ExtensionConfigFileManager manager(std::make_unique<JsonConfigFileManager>());
+    manager.add(".conf", std::make_unique<ConfConfigFileManager>());
+
+    EXPECT_EQ(manager.load((temp_dir / "legacy.conf").string())["TimeoutPhrase"].get<std::string>(), "Legacy");
+    EXPECT_EQ(manager.load((temp_dir / "modern.json").string())["TimeoutPhrase"].get<std::string>(), "Modern");
+
+    manager.save((temp_dir / "copy.conf").string(), manager.load((temp_dir / "modern.json").string()));
+    std::ifstream copy(temp_dir / "copy.conf");
+    std::string first_line;
+    std::getline(copy, first_line);
+    EXPECT_EQ(first_line, "Timeout = 500");
+}
\ No newline at end of file
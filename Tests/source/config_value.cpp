@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include <sdbus-c++/sdbus-c++.h>
+
+#include <ConfigValue/ConfigValue.hpp>
+#include <map>
+#include <sys/mman.h>
+#include <unistd.h>
+
+TEST(ConfigValueTest, ScalarsAreStoredInline)
+{
+    EXPECT_EQ(sizeof(ConfigValue), 16);
+
+    ConfigValue timeout(uint32_t{1000});
+    EXPECT_EQ(timeout.type(), ConfigValue::Type::UInt32);
+    EXPECT_EQ(timeout.signature(), 'u');
+    EXPECT_EQ(timeout.get<uint32_t>(), 1000);
+    EXPECT_EQ(ConfigValue(true).get<bool>(), true);
+    EXPECT_EQ(ConfigValue(-2.5).get<double>(), -2.5);
+    EXPECT_THROW(timeout.get<int32_t>(), std::runtime_error);
+}
+
+TEST(ConfigValueTest, ShortAndLongStrings)
+{
+    const std::string long_text(100, 'x');
+    ConfigValue short_value("Hello");
+    ConfigValue long_value(long_text);
+
+    EXPECT_EQ(short_value.asString(), "Hello");
+    EXPECT_EQ(long_value.get<std::string>(), long_text);
+    EXPECT_THROW(short_value.get<uint32_t>(), std::runtime_error);
+
+    ConfigValue copy = long_value;
+    ConfigValue moved = std::move(long_value);
+    EXPECT_EQ(copy, moved);
+    EXPECT_EQ(copy.asString().data(), moved.asString().data());
+    EXPECT_EQ(moved.useCount(), 2u);
+    EXPECT_EQ(short_value.useCount(), 0u);
+
+    copy = short_value;
+    EXPECT_EQ(copy.asString(), "Hello");
+    EXPECT_EQ(moved.useCount(), 1u);
+    EXPECT_EQ(moved.get<std::string>(), long_text);
+}
+
+TEST(ConfigValueTest, VariantRoundTrip)
+{
+    const std::map<std::string, sdbus::Variant> config = {{"Bool", sdbus::Variant(true)},
+                                                          {"Byte", sdbus::Variant(uint8_t{7})},
+                                                          {"Int16", sdbus::Variant(int16_t{-7})},
+                                                          {"UInt16", sdbus::Variant(uint16_t{7})},
+                                                          {"Int32", sdbus::Variant(int32_t{-70000})},
+                                                          {"UInt32", sdbus::Variant(uint32_t{70000})},
+                                                          {"Int64", sdbus::Variant(int64_t{-1} << 40)},
+                                                          {"UInt64", sdbus::Variant(uint64_t{1} << 40)},
+                                                          {"Double", sdbus::Variant(0.25)},
+                                                          {"String", sdbus::Variant(std::string{"text"})}};
+
+    for (const auto& [key, variant] : config)
+    {
+        const auto value = ConfigValue::fromVariant(variant);
+        const auto back = value.toVariant();
+        EXPECT_EQ(back.peekValueType(), variant.peekValueType()) << key;
+        EXPECT_EQ(ConfigValue::fromVariant(back), value) << key;
+    }
+    EXPECT_EQ(ConfigValue::fromVariant(config.at("Int64")).get<int64_t>(), int64_t{-1} << 40);
+}
+
+TEST(ConfigValueTest, EqualityComparesTypeAndValue)
+{
+    EXPECT_EQ(ConfigValue(int32_t{1}), ConfigValue(int32_t{1}));
+    EXPECT_NE(ConfigValue(int32_t{1}), ConfigValue(uint32_t{1}));
+    EXPECT_NE(ConfigValue("a"), ConfigValue("b"));
+}
+
+TEST(ConfigValueTest, SealedStringsLiveInMemfds)
+{
+    const std::string bundle(100000, 'c');
+    const ConfigValue sealed = ConfigValue::sealed(bundle);
+
+    ASSERT_GE(sealed.descriptor(), 0);
+    EXPECT_EQ(sealed.type(), ConfigValue::Type::String);
+    EXPECT_EQ(sealed.asString(), bundle);
+    EXPECT_EQ(sealed, ConfigValue(bundle));
+
+    const ConfigValue copy = sealed;
+    EXPECT_EQ(copy.descriptor(), sealed.descriptor());
+    EXPECT_EQ(sealed.useCount(), 2u);
+
+    // A receiver maps the same pages through its own descriptor
+    const ConfigValue mapped = ConfigValue::fromDescriptor(sealed.descriptor());
+    EXPECT_NE(mapped.descriptor(), sealed.descriptor());
+    EXPECT_EQ(mapped.asString(), bundle);
+
+    EXPECT_EQ(ConfigValue::sealed("short").descriptor(), -1);
+}
+
+TEST(ConfigValueTest, UnsealedDescriptorsAreRejected)
+{
+    const int fd = ::memfd_create("unsealed", MFD_CLOEXEC);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(::write(fd, "value", 6), 6);
+
+    EXPECT_THROW(ConfigValue::fromDescriptor(fd), std::runtime_error);
+    ::close(fd);
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include <sdbus-c++/sdbus-c++.h>
+
+#include <AppConfig/AppConfig.hpp>
+#include <ContentStore/ContentStore.hpp>
+#include <map>
+
+TEST(ContentStoreTest, EqualParameterSetsAreShared)
+{
+    ContentStore& store = ContentStore::instance();
+    const ContentStore::Parameters parameters = {{"Timeout", ConfigValue(uint32_t{1000})},
+                                                 {"Mode", ConfigValue("fast")}};
+
+    const auto first = store.internParameters(parameters);
+    const auto second = store.internParameters(parameters);
+    EXPECT_EQ(first, second);
+
+    auto changed = parameters;
+    changed["Mode"] = ConfigValue("slow");
+    const auto third = store.internParameters(changed);
+    EXPECT_NE(first, third);
+    EXPECT_EQ(third->at("Mode").asString(), "slow");
+}
+
+TEST(ContentStoreTest, LongStringsAreSharedAcrossSets)
+{
+    ContentStore& store = ContentStore::instance();
+    const std::string banner(200, 'b');
+
+    const auto first = store.internParameters({{"Banner", ConfigValue(banner)}, {"Id", ConfigValue(int32_t{1})}});
+    const auto second = store.internParameters({{"Banner", ConfigValue(banner)}, {"Id", ConfigValue(int32_t{2})}});
+    ASSERT_NE(first, second);
+    EXPECT_EQ(first->at("Banner").asString().data(), second->at("Banner").asString().data());
+
+    const ConfigValue value = store.internValue(ConfigValue(banner));
+    EXPECT_EQ(value.asString().data(), first->at("Banner").asString().data());
+}
+
+TEST(ContentStoreTest, EqualConfigurationsAreShared)
+{
+    ContentStore& store = ContentStore::instance();
+    const ContentStore::Configuration configuration = {{"Timeout", sdbus::Variant(uint32_t{1000})},
+                                                       {"Mode", sdbus::Variant(std::string("fast"))}};
+
+    const auto first = store.internConfiguration(configuration);
+    EXPECT_EQ(first, store.internConfiguration(configuration));
+
+    auto changed = configuration;
+    changed["Timeout"] = sdbus::Variant(int32_t{1000});
+    EXPECT_NE(first, store.internConfiguration(changed));
+}
+
+TEST(ContentStoreTest, ChangedApplicationDivergesFromSharedCopy)
+{
+    const std::map<std::string, sdbus::Variant> config = {{"Timeout", sdbus::Variant(uint32_t{1000})},
+                                                          {"Mode", sdbus::Variant(std::string("shared-mode"))}};
+    AppConfig first("first", config);
+    AppConfig second("second", config);
+    const std::size_t shared_sets = ContentStore::instance().parameterSets();
+
+    first.setParameter("Timeout", sdbus::Variant(uint32_t{5}));
+    first.setParameter("Mode", sdbus::Variant(std::string("private")));
+
+    EXPECT_EQ(first.getAllParameters().at("Timeout").get<uint32_t>(), 5u);
+    EXPECT_EQ(first.getAllParameters().at("Mode").get<std::string>(), "private");
+    EXPECT_EQ(second.getAllParameters().at("Timeout").get<uint32_t>(), 1000u);
+    EXPECT_EQ(second.getAllParameters().at("Mode").get<std::string>(), "shared-mode");
+    EXPECT_EQ(ContentStore::instance().parameterSets(), shared_sets);
+
+    AppConfig third("third", config);
+    EXPECT_EQ(third.getAllParameters().at("Timeout").get<uint32_t>(), 1000u);
+}
+
+TEST(ContentStoreTest, LargeStringsAreSealed)
+{
+    ContentStore& store = ContentStore::instance();
+    store.setSealAbove(1000);
+
+    const ConfigValue large = store.internValue(ConfigValue(std::string(5000, 'r')));
+    const ConfigValue small = store.internValue(ConfigValue(std::string(500, 's')));
+    store.setSealAbove(0);
+
+    EXPECT_GE(large.descriptor(), 0);
+    EXPECT_EQ(large.asString(), std::string(5000, 'r'));
+    EXPECT_EQ(small.descriptor(), -1);
+}
\ No newline at end of file
@@ -2,10 +2,17 @@
 #include <sdbus-c++/sdbus-c++.h>
 
 #include <AppConfig/AppConfig.hpp>
+#include <ConfigChangePipeline/ConfigChangePipeline.hpp>
+#include <ConfigNamespaceWatcher/ConfigNamespaceWatcher.hpp>
+#include <ContentStore/ContentStore.hpp>
 #include <DBusConfigAdapter/DBusConfigAdapter.hpp>
+#include <DispatchScheduler/DispatchScheduler.hpp>
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <future>
 #include <thread>
+#include <tuple>
 
 class MockConfigStorage : public IConfigStorage
 {
@@ -218,4 +225,620 @@ TEST_F(DBusConfigAdapterTest, ConcurrentAccess)
         .storeResultsTo(result);
 
     EXPECT_EQ(result.size(), THREAD_COUNT * ITERATIONS);
+}
+
+TEST_F(DBusConfigAdapterTest, KeySignalIsFilteredByMatchRule)
+{
+    std::promise<std::string> signal_promise;
+    auto signal_future = signal_promise.get_future();
+    std::atomic<int> received{0};
+
+    auto slot = connection_->addMatch(
+        "type='signal',path='/com/system/configurationManager/Application/testApp',"
+        "interface='com.system.configurationManager.Application.Configuration',"
+        "member='configurationKeyChanged',arg0='watched'",
+        [&](sdbus::Message& message)
+        {
+            std::string key;
+            sdbus::Variant value;
+            message >> key >> value;
+            if (received++ == 0)
+                signal_promise.set_value(key);
+        });
+
+    auto proxy =
+        sdbus::createProxy(*connection_, "test.config.manager", "/com/system/configurationManager/Application/testApp");
+
+    proxy->callMethod("ChangeConfiguration")
+        .onInterface("com.system.configurationManager.Application.Configuration")
+        .withArguments("ignored", sdbus::Variant(1))
+        .withTimeout(std::chrono::milliseconds(500));
+
+    proxy->callMethod("ChangeConfiguration")
+        .onInterface("com.system.configurationManager.Application.Configuration")
+        .withArguments("watched", sdbus::Variant(2))
+        .withTimeout(std::chrono::milliseconds(500));
+
+    ASSERT_EQ(signal_future.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+    EXPECT_EQ(signal_future.get(), "watched");
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(received.load(), 1);
+}
+
+TEST_F(DBusConfigAdapterTest, PipelinedChangesComplete)
+{
+    constexpr uint32_t CHANGES = 200;
+    ConfigChangePipeline pipeline("testApp", 8, "test.config.manager");
+
+    std::vector<std::future<void>> replies;
+    for (uint32_t i = 0; i < CHANGES; ++i) replies.push_back(pipeline.change("pipelined", sdbus::Variant(i)));
+
+    for (auto& reply : replies)
+    {
+        ASSERT_EQ(reply.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+        EXPECT_NO_THROW(reply.get());
+    }
+    EXPECT_EQ(pipeline.inFlight(), 0);
+
+    std::map<std::string, sdbus::Variant> result;
+    sdbus::createProxy(*connection_, "test.config.manager", "/com/system/configurationManager/Application/testApp")
+        ->callMethod("GetConfiguration")
+        .onInterface("com.system.configurationManager.Application.Configuration")
+        .storeResultsTo(result);
+    EXPECT_EQ(result["pipelined"].get<uint32_t>(), CHANGES - 1);
+}
+
+TEST_F(DBusConfigAdapterTest, PostedChangesAreApplied)
+{
+    ConfigChangePipeline pipeline("testApp", 8, "test.config.manager");
+    for (int32_t i = 0; i < 50; ++i) pipeline.post("posted", sdbus::Variant(i));
+
+    // Calls of one connection are handled in order, so this reply comes after every posted change
+    auto reply = pipeline.change("marker", sdbus::Variant(true));
+    ASSERT_EQ(reply.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+
+    std::map<std::string, sdbus::Variant> result;
+    sdbus::createProxy(*connection_, "test.config.manager", "/com/system/configurationManager/Application/testApp")
+        ->callMethod("GetConfiguration")
+        .onInterface("com.system.configurationManager.Application.Configuration")
+        .storeResultsTo(result);
+    EXPECT_EQ(result["posted"].get<int32_t>(), 49);
+}
+
+TEST_F(DBusConfigAdapterTest, NamespaceWatcherFollowsAllApplications)
+{
+    auto other = std::make_unique<DBusConfigAdapter>(
+        std::make_unique<MockConfigStorage>("otherApp", std::map<std::string, sdbus::Variant>{
+                                                            {"Mode", sdbus::Variant(std::string("fast"))}}),
+        *connection_);
+    other->registerDBusInterface();
+
+    // Stands in for the manager's bulk fetch
+    auto manager = sdbus::createObject(*connection_, "/com/system/configurationManager");
+    manager->registerMethod("GetConfigurations")
+        .onInterface("com.system.configurationManager.Manager")
+        .implementedAs(
+            [&](const std::vector<std::string>& apps)
+            {
+                std::map<std::string, std::map<std::string, sdbus::Variant>> result;
+                for (const auto* adapter : {adapter_.get(), other.get()})
+                {
+                    if (apps.empty() || std::find(apps.begin(), apps.end(), adapter->getAppName()) != apps.end())
+                        result.emplace(adapter->getAppName(), adapter->getConfiguration());
+                }
+                return result;
+            });
+    manager->finishRegistration();
+
+    std::promise<std::string> change_promise;
+    auto change_future = change_promise.get_future();
+    ConfigNamespaceWatcher watcher("test.config.manager");
+    watcher.setChangeListener(
+        [&](const std::string& app_name, const std::string& key, const sdbus::Variant&)
+        {
+            if (key == "Mode")
+                change_promise.set_value(app_name);
+        });
+    watcher.start();
+
+    EXPECT_EQ(watcher.applications(), (std::vector<std::string>{"otherApp", "testApp"}));
+    EXPECT_EQ(watcher.get("otherApp", "Mode")->get<std::string>(), "fast");
+
+    sdbus::createProxy(*connection_, "test.config.manager", "/com/system/configurationManager/Application/otherApp")
+        ->callMethod("ChangeConfiguration")
+        .onInterface("com.system.configurationManager.Application.Configuration")
+        .withArguments("Mode", sdbus::Variant(std::string("slow")));
+
+    ASSERT_EQ(change_future.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+    EXPECT_EQ(change_future.get(), "otherApp");
+    EXPECT_EQ(watcher.get("otherApp", "Mode")->get<std::string>(), "slow");
+    EXPECT_FALSE(watcher.get("testApp", "Mode").has_value());
+}
+
+TEST_F(DBusConfigAdapterTest, NamespaceWatcherDecodesLargeStrings)
+{
+    ContentStore::instance().setSealAbove(64);
+    auto large = std::make_unique<DBusConfigAdapter>(
+        std::make_unique<AppConfig>("largeApp", std::map<std::string, sdbus::Variant>{
+                                                    {"Bundle", sdbus::Variant(std::string(100, 'a'))}}),
+        *connection_);
+    large->registerDBusInterface();
+
+    auto manager = sdbus::createObject(*connection_, "/com/system/configurationManager");
+    manager->registerMethod("GetConfigurations")
+        .onInterface("com.system.configurationManager.Manager")
+        .implementedAs(
+            [&](const std::vector<std::string>&)
+            {
+                return std::map<std::string, std::map<std::string, sdbus::Variant>>{
+                    {"largeApp", large->getConfiguration()}};
+            });
+    manager->finishRegistration();
+
+    std::promise<std::string> change_promise;
+    ConfigNamespaceWatcher watcher("test.config.manager");
+    watcher.setChangeListener(
+        [&](const std::string&, const std::string& key, const sdbus::Variant& value)
+        {
+            if (key == "Bundle")
+                change_promise.set_value(value.peekValueType());
+        });
+    watcher.start();
+    EXPECT_EQ(watcher.get("largeApp", "Bundle")->peekValueType(), "s");
+
+    const std::string bundle(200, 'b');
+    sdbus::createProxy(*connection_, "test.config.manager", "/com/system/configurationManager/Application/largeApp")
+        ->callMethod("ChangeConfiguration")
+        .onInterface("com.system.configurationManager.Application.Configuration")
+        .withArguments("Bundle", sdbus::Variant(bundle));
+
+    auto change_future = change_promise.get_future();
+    ASSERT_EQ(change_future.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+    // Sent as a descriptor, cached and reported like the fetched value
+    EXPECT_EQ(change_future.get(), "s");
+    EXPECT_EQ(watcher.get("largeApp", "Bundle")->get<std::string>(), bundle);
+    ContentStore::instance().setSealAbove(0);
+}
+
+TEST_F(DBusConfigAdapterTest, NamespaceWatcherSkipsStaleSignals)
+{
+    // An application object that signals whatever versions the test chooses
+    const std::string interface = "com.system.configurationManager.Application.Configuration";
+    auto app = sdbus::createObject(*connection_, "/com/system/configurationManager/Application/fakeApp");
+    app->registerMethod("GetChangesSince")
+        .onInterface(interface)
+        .implementedAs([](uint64_t)
+                       { return std::make_tuple(uint64_t{5}, true, std::map<std::string, sdbus::Variant>{}); });
+    app->registerSignal("configurationKeyChanged")
+        .onInterface(interface)
+        .withParameters<std::string, sdbus::Variant, uint64_t>("key", "value", "version");
+    app->finishRegistration();
+
+    auto manager = sdbus::createObject(*connection_, "/com/system/configurationManager");
+    manager->registerMethod("GetConfigurations")
+        .onInterface("com.system.configurationManager.Manager")
+        .implementedAs(
+            [](const std::vector<std::string>&)
+            {
+                return std::map<std::string, std::map<std::string, sdbus::Variant>>{
+                    {"fakeApp", {{"Mode", sdbus::Variant(std::string("v5"))}}}};
+            });
+    manager->finishRegistration();
+
+    std::vector<std::string> seen;
+    std::promise<void> done_promise;
+    ConfigNamespaceWatcher watcher("test.config.manager");
+    watcher.setChangeListener(
+        [&](const std::string&, const std::string&, const sdbus::Variant& value)
+        {
+            seen.push_back(value.get<std::string>());
+            if (seen.back() == "v7")
+                done_promise.set_value();
+        });
+    watcher.start();
+
+    const auto emit = [&](const std::string& value, uint64_t version)
+    {
+        app->emitSignal("configurationKeyChanged")
+            .onInterface(interface)
+            .withArguments(std::string("Mode"), sdbus::Variant(value), version);
+    };
+    emit("v4", 4);  // Older than the fetched configuration
+    emit("v6", 6);
+    emit("v5", 5);  // Delivered late
+    emit("v7", 7);
+
+    auto done_future = done_promise.get_future();
+    ASSERT_EQ(done_future.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+    EXPECT_EQ(seen, (std::vector<std::string>{"v6", "v7"}));
+    EXPECT_EQ(watcher.get("fakeApp", "Mode")->get<std::string>(), "v7");
+}
+
+TEST_F(DBusConfigAdapterTest, KeysAreExposedAsProperties)
+{
+    adapter_->setPropertiesPolicy({true, 8});
+    auto proxy =
+        sdbus::createProxy(*connection_, "test.config.manager", "/com/system/configurationManager/Application/testApp");
+    proxy->callMethod("ChangeConfiguration")
+        .onInterface("com.system.configurationManager.Application.Configuration")
+        .withArguments("Small", sdbus::Variant(int32_t{1}));
+    proxy->callMethod("ChangeConfiguration")
+        .onInterface("com.system.configurationManager.Application.Configuration")
+        .withArguments("Large", sdbus::Variant(std::string(64, 'x')));
+
+    // Signals of the changes above may still be on their way, only the one caused by Set counts
+    std::promise<std::size_t> changed_promise;
+    auto changed_future = changed_promise.get_future();
+    auto slot = connection_->addMatch(
+        "type='signal',path='/com/system/configurationManager/Application/testApp',"
+        "interface='org.freedesktop.DBus.Properties',member='PropertiesChanged'",
+        [&](sdbus::Message& message)
+        {
+            std::string interface;
+            std::map<std::string, sdbus::Variant> changed;
+            std::vector<std::string> invalidated;
+            message >> interface >> changed >> invalidated;
+            const auto it = changed.find("Small");
+            if (it != changed.end() && it->second.get<int32_t>() == 2)
+                changed_promise.set_value(changed.size());
+        });
+
+    sdbus::Variant small;
+    proxy->callMethod("Get")
+        .onInterface("org.freedesktop.DBus.Properties")
+        .withArguments("com.system.configurationManager.Application.Configuration", "Small")
+        .storeResultsTo(small);
+    EXPECT_EQ(small.get<int32_t>(), 1);
+
+    proxy->callMethod("Set")
+        .onInterface("org.freedesktop.DBus.Properties")
+        .withArguments("com.system.configurationManager.Application.Configuration", "Small",
+                       sdbus::Variant(int32_t{2}));
+    ASSERT_EQ(changed_future.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+    EXPECT_EQ(changed_future.get(), 1u);
+    EXPECT_EQ(adapter_->getConfiguration()["Small"].get<int32_t>(), 2);
+
+    std::map<std::string, sdbus::Variant> all;
+    proxy->callMethod("GetAll")
+        .onInterface("org.freedesktop.DBus.Properties")
+        .withArguments("com.system.configurationManager.Application.Configuration")
+        .storeResultsTo(all);
+    EXPECT_EQ(all["Large"].get<std::string>(), std::string(64, 'x'));
+}
+
+TEST_F(DBusConfigAdapterTest, LargePropertiesAreInvalidatedOnly)
+{
+    adapter_->setPropertiesPolicy({true, 8});
+
+    std::promise<std::pair<std::size_t, std::vector<std::string>>> changed_promise;
+    auto changed_future = changed_promise.get_future();
+    auto slot = connection_->addMatch(
+        "type='signal',path='/com/system/configurationManager/Application/testApp',"
+        "interface='org.freedesktop.DBus.Properties',member='PropertiesChanged'",
+        [&](sdbus::Message& message)
+        {
+            std::string interface;
+            std::map<std::string, sdbus::Variant> changed;
+            std::vector<std::string> invalidated;
+            message >> interface >> changed >> invalidated;
+            changed_promise.set_value({changed.size(), invalidated});
+        });
+
+    adapter_->applyChanges({{"Large", sdbus::Variant(std::string(65, 'y'))}});
+    ASSERT_EQ(changed_future.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+    const auto [changed, invalidated] = changed_future.get();
+    EXPECT_EQ(changed, 0u);
+    EXPECT_EQ(invalidated, std::vector<std::string>{"Large"});
+}
+
+TEST_F(DBusConfigAdapterTest, WaitForChangeIsAnsweredByTheNextChange)
+{
+    TimerService timers;
+    DBusConfigAdapter adapter(std::make_unique<MockConfigStorage>("waitApp"), *connection_);
+    adapter.setTimerService(&timers);
+    adapter.registerDBusInterface();
+
+    auto waiting = std::async(std::launch::async,
+                              []
+                              {
+                                  uint64_t version = 0;
+                                  bool complete = false;
+                                  std::map<std::string, sdbus::Variant> changes;
+                                  sdbus::createProxy(*connection_, "test.config.manager",
+                                                     "/com/system/configurationManager/Application/waitApp")
+                                      ->callMethod("WaitForChange")
+                                      .onInterface("com.system.configurationManager.Application.Configuration")
+                                      .withArguments(uint64_t{0}, uint32_t{5000})
+                                      .withTimeout(std::chrono::seconds(10))
+                                      .storeResultsTo(version, complete, changes);
+                                  return std::make_tuple(version, complete, changes);
+                              });
+
+    for (int i = 0; i < 50 && adapter.parkedWaiters() == 0; ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ASSERT_EQ(adapter.parkedWaiters(), 1);
+    EXPECT_EQ(waiting.wait_for(std::chrono::milliseconds(100)), std::future_status::timeout);
+
+    adapter.applyChanges({{"woken", sdbus::Variant(7)}});
+
+    ASSERT_EQ(waiting.wait_for(std::chrono::seconds(2)), std::future_status::ready);
+    auto [version, complete, changes] = waiting.get();
+    EXPECT_EQ(version, 1);
+    EXPECT_TRUE(complete);
+    EXPECT_EQ(changes["woken"].get<int32_t>(), 7);
+    EXPECT_EQ(adapter.parkedWaiters(), 0);
+    EXPECT_EQ(timers.pending(), 0);
+}
+
+TEST_F(DBusConfigAdapterTest, WaitForChangeTimesOut)
+{
+    TimerService timers;
+    DBusConfigAdapter adapter(std::make_unique<MockConfigStorage>("waitApp"), *connection_);
+    adapter.setTimerService(&timers);
+    adapter.registerDBusInterface();
+
+    uint64_t version = 1;
+    bool complete = false;
+    std::map<std::string, sdbus::Variant> changes{{"stale", sdbus::Variant(true)}};
+    const auto start = std::chrono::steady_clock::now();
+    sdbus::createProxy(*connection_, "test.config.manager", "/com/system/configurationManager/Application/waitApp")
+        ->callMethod("WaitForChange")
+        .onInterface("com.system.configurationManager.Application.Configuration")
+        .withArguments(uint64_t{0}, uint32_t{200})
+        .withTimeout(std::chrono::seconds(5))
+        .storeResultsTo(version, complete, changes);
+
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(200));
+    EXPECT_EQ(version, 0);
+    EXPECT_TRUE(complete);
+    EXPECT_TRUE(changes.empty());
+    EXPECT_EQ(adapter.parkedWaiters(), 0);
+}
+
+TEST_F(DBusConfigAdapterTest, WaitForChangeRacingItsTimeoutIsAnswered)
+{
+    TimerService timers;
+    DBusConfigAdapter adapter(std::make_unique<MockConfigStorage>("raceApp"), *connection_);
+    adapter.setTimerService(&timers);
+    adapter.registerDBusInterface();
+
+    for (int round = 0; round < 20; ++round)
+    {
+        const uint64_t since = adapter.version();
+        auto waiting = std::async(std::launch::async,
+                                  [since]
+                                  {
+                                      uint64_t version = 0;
+                                      bool complete = false;
+                                      std::map<std::string, sdbus::Variant> changes;
+                                      sdbus::createProxy(*connection_, "test.config.manager",
+                                                         "/com/system/configurationManager/Application/raceApp")
+                                          ->callMethod("WaitForChange")
+                                          .onInterface("com.system.configurationManager.Application.Configuration")
+                                          .withArguments(since, uint32_t{20})
+                                          .withTimeout(std::chrono::seconds(2))
+                                          .storeResultsTo(version, complete, changes);
+                                      return version;
+                                  });
+
+        for (int i = 0; i < 50 && adapter.parkedWaiters() == 0; ++i)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        // Lands before, during or after the expiry of the waiter
+        std::this_thread::sleep_for(std::chrono::milliseconds(15 + round % 10));
+        adapter.applyChanges({{"round", sdbus::Variant(round)}});
+
+        ASSERT_EQ(waiting.wait_for(std::chrono::seconds(3)), std::future_status::ready) << "round " << round;
+        EXPECT_NO_THROW(EXPECT_GE(waiting.get(), since)) << "round " << round;
+    }
+    EXPECT_EQ(adapter.parkedWaiters(), 0);
+}
+
+TEST_F(DBusConfigAdapterTest, TemporaryOverridesExpire)
+{
+    TimerService timers;
+    TimerWheel wheel(timers, std::chrono::milliseconds(10));
+    DBusConfigAdapter adapter(
+        std::make_unique<MockConfigStorage>("ttlApp",
+                                            std::map<std::string, sdbus::Variant>{{"Timeout", sdbus::Variant(1000)}}),
+        *connection_);
+    adapter.setExpiryWheel(&wheel);
+    adapter.registerDBusInterface();
+
+    std::promise<int32_t> reverted;
+    auto slot = connection_->addMatch(
+        "type='signal',path='/com/system/configurationManager/Application/ttlApp',member='configurationKeyChanged'",
+        [&reverted, seen = 0](sdbus::Message& message) mutable
+        {
+            std::string key;
+            sdbus::Variant value;
+            message >> key >> value;
+            if (++seen == 2)
+                reverted.set_value(value.get<int32_t>());
+        });
+
+    auto proxy =
+        sdbus::createProxy(*connection_, "test.config.manager", "/com/system/configurationManager/Application/ttlApp");
+    proxy->callMethod("ChangeConfigurationWithTTL")
+        .onInterface("com.system.configurationManager.Application.Configuration")
+        .withArguments("Timeout", sdbus::Variant(5000), uint32_t{200});
+    EXPECT_EQ(adapter.getConfiguration()["Timeout"].get<int32_t>(), 5000);
+    EXPECT_EQ(adapter.temporaryOverrides(), 1);
+
+    auto reverted_value = reverted.get_future();
+    ASSERT_EQ(reverted_value.wait_for(std::chrono::seconds(2)), std::future_status::ready);
+    EXPECT_EQ(reverted_value.get(), 1000);
+    EXPECT_EQ(adapter.getConfiguration()["Timeout"].get<int32_t>(), 1000);
+    EXPECT_EQ(adapter.temporaryOverrides(), 0);
+
+    // Only keys with a value underneath can be overridden temporarily
+    EXPECT_THROW(proxy->callMethod("ChangeConfigurationWithTTL")
+                     .onInterface("com.system.configurationManager.Application.Configuration")
+                     .withArguments("Missing", sdbus::Variant(1), uint32_t{200}),
+                 sdbus::Error);
+}
+
+TEST_F(DBusConfigAdapterTest, DerivedKeysFollowTheirInputs)
+{
+    DBusConfigAdapter adapter(std::make_unique<MockConfigStorage>(
+                                  "derivedApp",
+                                  std::map<std::string, sdbus::Variant>{
+                                      {"Timeout", sdbus::Variant(1000)},
+                                      {"Derived:Budget", sdbus::Variant(std::string{"60000 / Timeout"})}}),
+                              *connection_);
+    adapter.registerDBusInterface();
+    EXPECT_EQ(adapter.getConfiguration()["Budget"].get<int64_t>(), 60);
+
+    std::promise<int64_t> budget;
+    auto slot = connection_->addMatch(
+        "type='signal',path='/com/system/configurationManager/Application/derivedApp',"
+        "member='configurationKeyChanged',arg0='Budget'",
+        [&budget](sdbus::Message& message)
+        {
+            std::string key;
+            sdbus::Variant value;
+            message >> key >> value;
+            budget.set_value(value.get<int64_t>());
+        });
+
+    auto proxy = sdbus::createProxy(*connection_, "test.config.manager",
+                                    "/com/system/configurationManager/Application/derivedApp");
+    proxy->callMethod("ChangeConfiguration")
+        .onInterface("com.system.configurationManager.Application.Configuration")
+        .withArguments("Timeout", sdbus::Variant(2000));
+    EXPECT_EQ(adapter.getConfiguration()["Budget"].get<int64_t>(), 30);
+
+    auto signalled = budget.get_future();
+    ASSERT_EQ(signalled.wait_for(std::chrono::seconds(2)), std::future_status::ready);
+    EXPECT_EQ(signalled.get(), 30);
+
+    // Derived keys are read-only, and declarations must not form cycles
+    EXPECT_THROW(proxy->callMethod("ChangeConfiguration")
+                     .onInterface("com.system.configurationManager.Application.Configuration")
+                     .withArguments("Budget", sdbus::Variant(int64_t{5})),
+                 sdbus::Error);
+    EXPECT_THROW(proxy->callMethod("ChangeConfiguration")
+                     .onInterface("com.system.configurationManager.Application.Configuration")
+                     .withArguments("Derived:Timeout", sdbus::Variant(std::string{"Budget * 2"})),
+                 sdbus::Error);
+    EXPECT_EQ(adapter.getConfiguration()["Timeout"].get<int32_t>(), 2000);
+}
+
+TEST_F(DBusConfigAdapterTest, CatchUpReadsCountAgainstTheReadLimit)
+{
+    adapter_->setReadRateLimit({0.01, 2});
+    auto proxy =
+        sdbus::createProxy(*connection_, "test.config.manager", "/com/system/configurationManager/Application/testApp");
+
+    uint64_t version = 0;
+    bool complete = false;
+    std::map<std::string, sdbus::Variant> changes;
+    auto changesSince = [&]
+    {
+        proxy->callMethod("GetChangesSince")
+            .onInterface("com.system.configurationManager.Application.Configuration")
+            .withArguments(uint64_t{0})
+            .storeResultsTo(version, complete, changes);
+    };
+    EXPECT_NO_THROW(changesSince());
+    EXPECT_NO_THROW(changesSince());
+    EXPECT_THROW(changesSince(), sdbus::Error);
+
+    // The bucket is shared with every other read of the same sender
+    EXPECT_THROW(proxy->callMethod("GetConfiguration")
+                     .onInterface("com.system.configurationManager.Application.Configuration"),
+                 sdbus::Error);
+}
+
+TEST_F(DBusConfigAdapterTest, KeyChangedSignalCarriesTheVersion)
+{
+    std::promise<uint64_t> signalled;
+    auto slot = connection_->addMatch(
+        "type='signal',path='/com/system/configurationManager/Application/testApp',"
+        "member='configurationKeyChanged',arg0='watched'",
+        [&signalled](sdbus::Message& message)
+        {
+            std::string key;
+            sdbus::Variant value;
+            uint64_t version = 0;
+            message >> key >> value >> version;
+            signalled.set_value(version);
+        });
+
+    auto proxy =
+        sdbus::createProxy(*connection_, "test.config.manager", "/com/system/configurationManager/Application/testApp");
+    proxy->callMethod("ChangeConfiguration")
+        .onInterface("com.system.configurationManager.Application.Configuration")
+        .withArguments("watched", sdbus::Variant(2));
+
+    auto future = signalled.get_future();
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+    const uint64_t signalled_version = future.get();
+    EXPECT_EQ(signalled_version, adapter_->version());
+
+    // A client that applied the signal has nothing left to catch up on
+    uint64_t version = 0;
+    bool complete = false;
+    std::map<std::string, sdbus::Variant> changes;
+    proxy->callMethod("GetChangesSince")
+        .onInterface("com.system.configurationManager.Application.Configuration")
+        .withArguments(signalled_version)
+        .storeResultsTo(version, complete, changes);
+    EXPECT_EQ(version, signalled_version);
+    EXPECT_TRUE(complete);
+    EXPECT_TRUE(changes.empty());
+}
+
+TEST_F(DBusConfigAdapterTest, KeySignalsOfABurstLeaveInVersionOrder)
+{
+    // One slot per queue: most flushes find the signal queue full or a flush already queued
+    DispatchScheduler scheduler({1, 1, 1, 1});
+    adapter_->setScheduler(&scheduler);
+
+    std::mutex mutex;
+    std::vector<std::pair<uint64_t, int32_t>> received;
+    auto slot = connection_->addMatch(
+        "type='signal',path='/com/system/configurationManager/Application/testApp',"
+        "member='configurationKeyChanged',arg0='watched'",
+        [&mutex, &received](sdbus::Message& message)
+        {
+            std::string key;
+            sdbus::Variant value;
+            uint64_t version = 0;
+            message >> key >> value >> version;
+            std::lock_guard<std::mutex> lock(mutex);
+            received.emplace_back(version, value.get<int32_t>());
+        });
+
+    auto proxy =
+        sdbus::createProxy(*connection_, "test.config.manager", "/com/system/configurationManager/Application/testApp");
+    constexpr int32_t CHANGES = 100;
+    for (int32_t i = 1; i <= CHANGES; ++i)
+        proxy->callMethod("ChangeConfiguration")
+            .onInterface("com.system.configurationManager.Application.Configuration")
+            .withArguments("watched", sdbus::Variant(i));
+    scheduler.drain(adapter_.get());
+    adapter_->setScheduler(nullptr);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_FALSE(received.empty());
+    for (std::size_t i = 1; i < received.size(); ++i) EXPECT_LT(received[i - 1].first, received[i].first);
+    // Coalesced signals may skip values, never the last one
+    EXPECT_EQ(received.back().first, adapter_->version());
+    EXPECT_EQ(received.back().second, CHANGES);
+}
+
+TEST_F(DBusConfigAdapterTest, WritesWaitForTheSharedWriteLock)
+{
+    std::recursive_mutex writes;
+    adapter_->setWriteMutex(&writes);
+
+    std::unique_lock<std::recursive_mutex> owner(writes);
+    std::thread writer([this] { adapter_->applyChanges({{"locked", sdbus::Variant(1)}}); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(adapter_->getConfiguration().contains("locked"));
+
+    owner.unlock();
+    writer.join();
+    EXPECT_EQ(adapter_->getConfiguration()["locked"].get<int32_t>(), 1);
 }
\ No newline at end of file
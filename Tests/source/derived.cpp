@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+
+#include <DerivedKeys/DerivedKeys.hpp>
+
+class DerivedKeysTest : public ::testing::Test
+{
+   protected:
+    DerivedKeys::Lookup lookup()
+    {
+        return [this](const std::string& key) -> std::optional<ConfigValue>
+        {
+            ++reads[key];
+            const auto it = values.find(key);
+            if (it == values.end())
+                return std::nullopt;
+            return it->second;
+        };
+    }
+
+    std::map<std::string, ConfigValue> values{{"Timeout", ConfigValue(uint32_t{1000})},
+                                              {"Retries", ConfigValue(int32_t{3})},
+                                              {"Ratio", ConfigValue(0.5)},
+                                              {"Enabled", ConfigValue(true)},
+                                              {"Name", ConfigValue("player")}};
+    std::map<std::string, int> reads;
+    DerivedKeys derived;
+};
+
+TEST_F(DerivedKeysTest, RecognizesDeclarations)
+{
+    EXPECT_EQ(DerivedKeys::declaredKey("Derived:Budget"), "Budget");
+    EXPECT_FALSE(DerivedKeys::declaredKey("Budget"));
+    EXPECT_FALSE(DerivedKeys::declaredKey("Derived:"));
+}
+
+TEST_F(DerivedKeysTest, EvaluatesArithmetic)
+{
+    derived.define("Total", "Timeout * (Retries + 1)");
+    derived.define("Budget", "max(1, 60000 / Timeout) - -2 % 3");
+    derived.define("Scaled", "Timeout * Ratio + Enabled");
+    derived.define("Low", "min(Retries, 7, 2.5)");
+
+    std::vector<std::string> failed;
+    auto result = derived.evaluateAll(lookup(), &failed);
+
+    EXPECT_TRUE(failed.empty());
+    EXPECT_EQ(result.at("Total").get<int64_t>(), 4000);
+    EXPECT_EQ(result.at("Budget").get<int64_t>(), 62);
+    EXPECT_DOUBLE_EQ(result.at("Scaled").get<double>(), 501.0);
+    EXPECT_DOUBLE_EQ(result.at("Low").get<double>(), 2.5);
+}
+
+TEST_F(DerivedKeysTest, RecomputesOnlyAffectedKeysInOrder)
+{
+    derived.define("Total", "Timeout * Retries");
+    derived.define("Half", "Total / 2");
+    derived.define("Scaled", "Ratio * 10");
+
+    values["Retries"] = ConfigValue(int32_t{4});
+    reads.clear();
+    auto result = derived.recompute({"Retries"}, lookup());
+
+    ASSERT_EQ(result.size(), 2);
+    EXPECT_EQ(result.at("Total").get<int64_t>(), 4000);
+    // Half reads the new Total, not the stored one
+    EXPECT_EQ(result.at("Half").get<int64_t>(), 2000);
+    EXPECT_FALSE(reads.contains("Total"));
+    EXPECT_FALSE(reads.contains("Ratio"));
+
+    EXPECT_TRUE(derived.recompute({"Name"}, lookup()).empty());
+}
+
+TEST_F(DerivedKeysTest, RejectsCyclesAndSyntaxErrors)
+{
+    derived.define("A", "B + 1");
+    derived.define("B", "Timeout");
+
+    EXPECT_THROW(derived.define("B", "A * 2"), std::runtime_error);
+    EXPECT_THROW(derived.define("C", "C"), std::runtime_error);
+    EXPECT_THROW(derived.check("D", "Timeout +"), std::runtime_error);
+    EXPECT_THROW(derived.define("D", "sqrt(Timeout)"), std::runtime_error);
+    EXPECT_THROW(derived.define("D", "(Timeout"), std::runtime_error);
+    EXPECT_EQ(derived.size(), 2);
+
+    // The failed redefinition left B as it was
+    EXPECT_EQ(derived.evaluateAll(lookup()).at("A").get<int64_t>(), 1001);
+
+    derived.define("A", "");
+    EXPECT_FALSE(derived.defines("A"));
+    derived.define("B", "A * 2");
+    EXPECT_TRUE(derived.defines("B"));
+}
+
+TEST_F(DerivedKeysTest, ReportsKeysThatCannotBeEvaluated)
+{
+    derived.define("Zero", "Timeout / (Retries - 3)");
+    derived.define("Text", "Name + 1");
+    derived.define("Missing", "Unknown * 2");
+    derived.define("Dependent", "Zero + 1");
+    derived.define("Overflow", "9223372036854775807 + Retries");
+    derived.define("Fine", "Retries");
+
+    std::vector<std::string> failed;
+    auto result = derived.evaluateAll(lookup(), &failed);
+
+    ASSERT_EQ(result.size(), 1);
+    EXPECT_EQ(result.at("Fine").get<int64_t>(), 3);
+    std::sort(failed.begin(), failed.end());
+    EXPECT_EQ(failed, (std::vector<std::string>{"Dependent", "Missing", "Overflow", "Text", "Zero"}));
+}
+
+TEST_F(DerivedKeysTest, LimitsLengthAndNesting)
+{
+    EXPECT_THROW(derived.check("X", std::string(200000, '(') + "1"), std::runtime_error);
+    EXPECT_THROW(derived.check("X", std::string(200000, '-') + "1"), std::runtime_error);
+    EXPECT_THROW(derived.check("X", std::string(MAX_EXPRESSION_DEPTH + 1, '(') + "1" +
+                                        std::string(MAX_EXPRESSION_DEPTH + 1, ')')),
+                 std::runtime_error);
+    EXPECT_THROW(derived.check("X", std::string(MAX_EXPRESSION_DEPTH + 1, '-') + "1"), std::runtime_error);
+
+    std::string sum = "1";
+    while (sum.size() + 2 <= MAX_EXPRESSION_LENGTH) sum += "+1";
+    EXPECT_NO_THROW(derived.check("X", sum));
+    EXPECT_THROW(derived.check("X", sum + "+1"), std::runtime_error);
+
+    derived.define("Nested", std::string(MAX_EXPRESSION_DEPTH - 1, '(') + "Retries" +
+                                 std::string(MAX_EXPRESSION_DEPTH - 1, ')'));
+    EXPECT_EQ(derived.evaluateAll(lookup()).at("Nested").get<int64_t>(), 3);
+}
\ No newline at end of file
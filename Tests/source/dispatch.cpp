@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+
+#include <DispatchScheduler/DispatchScheduler.hpp>
+#include <atomic>
+#include <future>
+#include <string>
+#include <vector>
+
+class DispatchSchedulerTest : public ::testing::Test
+{
+   protected:
+    /**
+     * @brief Occupy the worker until release() so that tasks pile up in the queues
+     */
+    void block(DispatchScheduler& scheduler)
+    {
+        auto started = std::make_shared<std::promise<void>>();
+        auto started_future = started->get_future();
+        scheduler.submit(DispatchClass::Signal, this,
+                         [started, released = released_future]
+                         {
+                             started->set_value();
+                             released.wait();
+                         });
+        started_future.wait();
+    }
+
+    void release() { released_.set_value(); }
+
+    std::promise<void> released_;
+    std::shared_future<void> released_future = released_.get_future().share();
+};
+
+TEST_F(DispatchSchedulerTest, ReadsAreNotStarvedByWrites)
+{
+    DispatchScheduler scheduler({4, 1, 1, 1024});
+    std::vector<char> order;
+    std::mutex mutex;
+    auto record = [&order, &mutex](char type)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        order.push_back(type);
+    };
+
+    block(scheduler);
+    for (int i = 0; i < 20; ++i) scheduler.submit(DispatchClass::Write, this, [&record] { record('w'); });
+    for (int i = 0; i < 8; ++i) scheduler.submit(DispatchClass::Read, this, [&record] { record('r'); });
+    release();
+    scheduler.drain(this);
+
+    ASSERT_EQ(order.size(), 28);
+    // Every read is served within the first two rounds of four reads and one write
+    const auto last_read = std::string(order.begin(), order.end()).rfind('r');
+    EXPECT_LT(last_read, 10);
+}
+
+TEST_F(DispatchSchedulerTest, RejectsTasksWhenQueueIsFull)
+{
+    DispatchScheduler scheduler({1, 1, 1, 2});
+    block(scheduler);
+
+    EXPECT_TRUE(scheduler.submit(DispatchClass::Write, this, [] {}));
+    EXPECT_TRUE(scheduler.submit(DispatchClass::Write, this, [] {}));
+    EXPECT_FALSE(scheduler.submit(DispatchClass::Write, this, [] {}));
+    EXPECT_TRUE(scheduler.submit(DispatchClass::Read, this, [] {}));
+    EXPECT_EQ(scheduler.queued(DispatchClass::Write), 2);
+
+    release();
+    scheduler.drain(this);
+    EXPECT_EQ(scheduler.queued(DispatchClass::Write), 0);
+}
+
+TEST_F(DispatchSchedulerTest, DrainWaitsOnlyForOwner)
+{
+    DispatchScheduler scheduler;
+    std::atomic<int> done{0};
+    int owner = 0;
+
+    for (int i = 0; i < 100; ++i) scheduler.submit(DispatchClass::Read, &owner, [&done] { ++done; });
+    scheduler.drain(&owner);
+    EXPECT_EQ(done.load(), 100);
+
+    // Draining an owner without tasks returns immediately
+    int idle = 0;
+    scheduler.drain(&idle);
+}
\ No newline at end of file
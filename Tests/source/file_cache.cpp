@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include <sdbus-c++/sdbus-c++.h>
+
+#include <ConfigFileCache/ConfigFileCache.hpp>
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+class ConfigFileCacheTest : public ::testing::Test
+{
+   protected:
+    void SetUp() override
+    {
+        dir = fs::temp_directory_path() /
+              (std::string("file_cache_") + ::testing::UnitTest::GetInstance()->current_test_info()->name());
+        fs::remove_all(dir);
+        fs::create_directories(dir);
+        cache_path = (dir / "configs.cache").string();
+        file = (dir / "app.json").string();
+        write(file, "first");
+    }
+
+    void TearDown() override { fs::remove_all(dir); }
+
+    static void write(const std::string& path, const std::string& content)
+    {
+        std::ofstream stream(path, std::ios::trunc);
+        stream << content;
+    }
+
+    ConfigFileCache::Config load()
+    {
+        ConfigFileCache cache(cache_path);
+        auto config = cache.load(file, parse);
+        cache.save();
+        return config;
+    }
+
+    fs::path dir;
+    std::string cache_path;
+    std::string file;
+    int parsed = 0;
+    ConfigFileCache::Parser parse = [this](const std::string& path)
+    {
+        ++parsed;
+        std::ifstream stream(path);
+        std::string content;
+        stream >> content;
+        return ConfigFileCache::Config{{"Content", sdbus::Variant(content)}, {"Timeout", sdbus::Variant(uint32_t{7})}};
+    };
+};
+
+TEST_F(ConfigFileCacheTest, UnchangedFilesAreNotParsedAgain)
+{
+    EXPECT_EQ(load()["Content"].get<std::string>(), "first");
+    EXPECT_EQ(parsed, 1);
+
+    auto config = load();
+    EXPECT_EQ(parsed, 1);
+    EXPECT_EQ(config["Content"].get<std::string>(), "first");
+    EXPECT_EQ(config["Timeout"].get<uint32_t>(), 7);
+}
+
+TEST_F(ConfigFileCacheTest, ModifiedFilesAreParsed)
+{
+    load();
+    write(file, "second");
+    fs::last_write_time(file, fs::last_write_time(file) + std::chrono::seconds(1));
+
+    EXPECT_EQ(load()["Content"].get<std::string>(), "second");
+    EXPECT_EQ(parsed, 2);
+}
+
+TEST_F(ConfigFileCacheTest, TouchedFilesAreReusedByHash)
+{
+    load();
+    fs::last_write_time(file, fs::last_write_time(file) + std::chrono::seconds(1));
+
+    ConfigFileCache cache(cache_path);
+    EXPECT_EQ(cache.load(file, parse)["Content"].get<std::string>(), "first");
+    EXPECT_EQ(parsed, 1);
+    EXPECT_EQ(cache.hits(), 1);
+}
+
+TEST_F(ConfigFileCacheTest, CorruptCacheIsIgnored)
+{
+    load();
+    {
+        std::fstream stream(cache_path, std::ios::in | std::ios::out | std::ios::binary);
+        stream.seekp(-1, std::ios::end);
+        stream.put('\x7f');
+    }
+
+    EXPECT_EQ(load()["Content"].get<std::string>(), "first");
+    EXPECT_EQ(parsed, 2);
+    load();
+    EXPECT_EQ(parsed, 2);
+}
+
+TEST_F(ConfigFileCacheTest, FilesChangedWhileParsedAreNotCached)
+{
+    {
+        ConfigFileCache cache(cache_path);
+        // The file is rewritten between hashing and parsing
+        cache.load(file,
+                   [this](const std::string& path)
+                   {
+                       write(path, "second");
+                       fs::last_write_time(path, fs::last_write_time(path) + std::chrono::seconds(1));
+                       return parse(path);
+                   });
+        cache.save();
+    }
+
+    // Restored content must not be matched by its hash to the values parsed from the other content
+    write(file, "first");
+    fs::last_write_time(file, fs::last_write_time(file) + std::chrono::seconds(2));
+    EXPECT_EQ(load()["Content"].get<std::string>(), "first");
+    EXPECT_EQ(parsed, 2);
+}
\ No newline at end of file
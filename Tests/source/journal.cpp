@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include <sdbus-c++/sdbus-c++.h>
+
+#include <ChangeJournal/ChangeJournal.hpp>
+
+#include <filesystem>
+#include <fstream>
+
+class ChangeJournalTest : public ::testing::Test
+{
+   protected:
+    void SetUp() override
+    {
+        path = std::filesystem::temp_directory_path() /
+               (std::string("journal_") + ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".bin");
+        std::filesystem::remove(path);
+    }
+
+    void TearDown() override { std::filesystem::remove(path); }
+
+    std::filesystem::path path;
+};
+
+TEST_F(ChangeJournalTest, ReplaysOverridesAfterReopen)
+{
+    {
+        ChangeJournal journal(path.string());
+        journal.append({JournalRecord::Kind::Override, "app", 1, "Timeout", sdbus::Variant(uint32_t{100})});
+        journal.append({JournalRecord::Kind::Derived, "app", 2, "TimeoutPhrase", sdbus::Variant(std::string{"x"})});
+        journal.append({JournalRecord::Kind::Override, "app", 3, "Timeout", sdbus::Variant(uint32_t{300})});
+    }
+
+    ChangeJournal journal(path.string());
+    auto histories = journal.replay();
+
+    ASSERT_EQ(histories.size(), 1);
+    const auto& history = histories["app"];
+    EXPECT_EQ(history.version, 3);
+    EXPECT_EQ(history.base_version, 0);
+    EXPECT_EQ(history.key_versions.at("Timeout"), 3);
+    EXPECT_EQ(history.key_versions.at("TimeoutPhrase"), 2);
+    ASSERT_EQ(history.overrides.size(), 1);
+    EXPECT_EQ(history.overrides.at("Timeout").get<uint32_t>(), 300);
+}
+
+TEST_F(ChangeJournalTest, DropsTornRecord)
+{
+    std::size_t valid_size = 0;
+    std::size_t full_size = 0;
+    {
+        ChangeJournal journal(path.string());
+        journal.append({JournalRecord::Kind::Override, "app", 1, "Timeout", sdbus::Variant(uint32_t{100})});
+        valid_size = journal.size();
+        journal.append({JournalRecord::Kind::Override, "app", 2, "Timeout", sdbus::Variant(uint32_t{200})});
+        full_size = journal.size();
+    }
+
+    // Corrupt the last byte of the second record's payload
+    {
+        const auto offset = static_cast<std::streamoff>(64 + full_size - 1);
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(offset);
+        file.put('\x7f');
+    }
+
+    ChangeJournal journal(path.string());
+    EXPECT_EQ(journal.size(), valid_size);
+    auto records = journal.records();
+    ASSERT_EQ(records.size(), 1);
+    EXPECT_EQ(records[0].value.get<uint32_t>(), 100);
+
+    journal.append({JournalRecord::Kind::Override, "app", 2, "Timeout", sdbus::Variant(uint32_t{250})});
+    EXPECT_EQ(journal.replay()["app"].overrides.at("Timeout").get<uint32_t>(), 250);
+}
+
+TEST_F(ChangeJournalTest, ResetKeepsCheckpoints)
+{
+    ChangeJournal journal(path.string());
+    journal.append({JournalRecord::Kind::Override, "app", 5, "Timeout", sdbus::Variant(uint32_t{100})});
+    journal.reset({{"app", 5}});
+
+    auto histories = journal.replay();
+    EXPECT_EQ(histories["app"].base_version, 5);
+    EXPECT_EQ(histories["app"].version, 5);
+    EXPECT_TRUE(histories["app"].overrides.empty());
+}
+
+TEST_F(ChangeJournalTest, RemovedEndsHistory)
+{
+    ChangeJournal journal(path.string());
+    journal.append({JournalRecord::Kind::Override, "app", 1, "Timeout", sdbus::Variant(uint32_t{100})});
+    journal.append({JournalRecord::Kind::Removed, "app", 1, {}, {}});
+    journal.append({JournalRecord::Kind::Override, "other", 1, "Timeout", sdbus::Variant(uint32_t{7})});
+
+    auto histories = journal.replay();
+    ASSERT_EQ(histories.size(), 1);
+    EXPECT_EQ(histories.count("other"), 1);
+}
\ No newline at end of file
@@ -89,4 +89,22 @@ TEST_F(JsonConfigFileManagerTest, SaveConfig)
 
     EXPECT_EQ(j["Timeout"], 2000);
     EXPECT_EQ(j["TimeoutPhrase"], "New phrase");
+}
+
+TEST_F(JsonConfigFileManagerTest, LoadLayerSkipsValidation)
+{
+    const auto config_path = temp_dir / "layer.json";
+    std::ofstream(config_path) << R"({
+        "ConfigGroup": "video"
+    })";
+
+    JsonConfigFileManager manager;
+    auto layer = manager.loadLayer(config_path.string());
+
+    EXPECT_EQ(layer["ConfigGroup"].get<std::string>(), "video");
+    EXPECT_THROW(manager.validate(layer), std::runtime_error);
+
+    layer["Timeout"] = sdbus::Variant(uint32_t{1000});
+    layer["TimeoutPhrase"] = sdbus::Variant(std::string{"Hello"});
+    EXPECT_NO_THROW(manager.validate(layer));
 }
\ No newline at end of file
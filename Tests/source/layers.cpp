@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include <sdbus-c++/sdbus-c++.h>
+
+#include <ConfigLayers/ConfigLayers.hpp>
+
+class ConfigLayersTest : public ::testing::Test
+{
+   protected:
+    void SetUp() override
+    {
+        layers.setLayer(DEFAULTS_LAYER, {{"Timeout", sdbus::Variant(uint32_t{1000})},
+                                         {"TimeoutPhrase", sdbus::Variant(std::string{"Default"})}});
+        layers.setLayer("group/video", {{"Timeout", sdbus::Variant(uint32_t{500})}});
+
+        layers.addApplication("player", {{"ConfigGroup", sdbus::Variant(std::string{"video"})}});
+        layers.addApplication("editor", {{"TimeoutPhrase", sdbus::Variant(std::string{"Editor"})}});
+    }
+
+    ConfigLayers layers;
+};
+
+TEST_F(ConfigLayersTest, ResolvesLayersInOrder)
+{
+    auto player = layers.effective("player");
+    EXPECT_EQ(player.size(), 2);
+    EXPECT_EQ(player["Timeout"].get<uint32_t>(), 500);
+    EXPECT_EQ(player["TimeoutPhrase"].get<std::string>(), "Default");
+
+    auto editor = layers.effective("editor");
+    EXPECT_EQ(editor["Timeout"].get<uint32_t>(), 1000);
+    EXPECT_EQ(editor["TimeoutPhrase"].get<std::string>(), "Editor");
+}
+
+TEST_F(ConfigLayersTest, GroupChangeOnlyAffectsMembers)
+{
+    auto changes = layers.setLayerValue("group/video", "TimeoutPhrase", sdbus::Variant(std::string{"Video"}));
+
+    ASSERT_EQ(changes.size(), 1);
+    EXPECT_EQ(changes["player"].size(), 1);
+    EXPECT_EQ(changes["player"]["TimeoutPhrase"].get<std::string>(), "Video");
+}
+
+TEST_F(ConfigLayersTest, DefaultsChangeSkipsShadowedApplications)
+{
+    auto changes = layers.setLayerValue(DEFAULTS_LAYER, "Timeout", sdbus::Variant(uint32_t{3000}));
+
+    ASSERT_EQ(changes.size(), 1);
+    EXPECT_EQ(changes["editor"]["Timeout"].get<uint32_t>(), 3000);
+
+    changes = layers.setLayerValue(DEFAULTS_LAYER, "Timeout", sdbus::Variant(uint32_t{3000}));
+    EXPECT_TRUE(changes.empty());
+}
+
+TEST_F(ConfigLayersTest, RuntimeOverridesShadowLayers)
+{
+    layers.setOverride("player", "Timeout", sdbus::Variant(uint32_t{42}));
+
+    auto changes = layers.setLayerValue("group/video", "Timeout", sdbus::Variant(uint32_t{600}));
+    EXPECT_TRUE(changes.empty());
+    EXPECT_EQ(layers.effective("player")["Timeout"].get<uint32_t>(), 42);
+}
+
+TEST_F(ConfigLayersTest, TemporaryOverridesRevealTheValueUnderneath)
+{
+    layers.setOverride("player", "Timeout", sdbus::Variant(uint32_t{42}));
+    layers.setTemporary("player", "Timeout", sdbus::Variant(uint32_t{9000}));
+    EXPECT_EQ(layers.effective("player")["Timeout"].get<uint32_t>(), 9000);
+
+    // Only the permanent override is written to the file
+    const auto file = layers.flattenOverrides("player");
+    ASSERT_TRUE(file.has_value());
+    EXPECT_EQ(file->at("Timeout").get<uint32_t>(), 42);
+    EXPECT_EQ(layers.effective("player")["Timeout"].get<uint32_t>(), 9000);
+
+    const auto underneath = layers.clearTemporary("player", "Timeout");
+    ASSERT_TRUE(underneath.has_value());
+    EXPECT_EQ(underneath->get<uint32_t>(), 42);
+    EXPECT_FALSE(layers.clearTemporary("player", "Timeout").has_value());
+
+    // A permanent change replaces the temporary override, so its expiry has nothing to revert
+    layers.setTemporary("editor", "Timeout", sdbus::Variant(uint32_t{9000}));
+    layers.setOverride("editor", "Timeout", sdbus::Variant(uint32_t{7}));
+    EXPECT_FALSE(layers.clearTemporary("editor", "Timeout").has_value());
+    EXPECT_EQ(layers.effective("editor")["Timeout"].get<uint32_t>(), 7);
+}
+
+TEST_F(ConfigLayersTest, RejectsInvalidLayerNames)
+{
+    EXPECT_THROW(layers.setLayerValue("group/../escape", "Timeout", sdbus::Variant(uint32_t{1})), std::runtime_error);
+    EXPECT_THROW(layers.layer("application/player"), std::runtime_error);
+    EXPECT_THROW(layers.setOverride("unknown", "Timeout", sdbus::Variant(uint32_t{1})), std::runtime_error);
+}
\ No newline at end of file
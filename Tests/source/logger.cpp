@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include <Logger/Logger.hpp>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class LoggerTest : public ::testing::Test
+{
+   protected:
+    void SetUp() override
+    {
+        Logger::instance().flush();
+        Logger::instance().setSink(
+            [this](LogLevel level, std::string_view text)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                records.emplace_back(level, std::string(text));
+            });
+        previous_level = Logger::instance().level();
+        Logger::instance().setLevel(LogLevel::Info);
+    }
+
+    void TearDown() override
+    {
+        Logger::instance().flush();
+        Logger::instance().setSink({});
+        Logger::instance().setLevel(previous_level);
+    }
+
+    std::mutex mutex;
+    std::vector<std::pair<LogLevel, std::string>> records;
+    LogLevel previous_level = LogLevel::Info;
+};
+
+TEST_F(LoggerTest, FormatsArguments)
+{
+    const std::string phrase = "phrase";
+    Logger::instance().info("Timeout: ", 1500u, "ms, ratio ", 0.5, ", enabled ", true, ", ", phrase, '!');
+    Logger::instance().flush();
+
+    ASSERT_EQ(records.size(), 1);
+    EXPECT_EQ(records[0].first, LogLevel::Info);
+    EXPECT_EQ(records[0].second, "Timeout: 1500ms, ratio 0.5, enabled true, phrase!");
+}
+
+TEST_F(LoggerTest, SkipsRecordsBelowLevel)
+{
+    Logger::instance().debug("hidden");
+    Logger::instance().warning("shown");
+    Logger::instance().setLevel(LogLevel::Debug);
+    Logger::instance().debug("now shown");
+    Logger::instance().flush();
+
+    ASSERT_EQ(records.size(), 2);
+    EXPECT_EQ(records[0].second, "shown");
+    EXPECT_EQ(records[1].second, "now shown");
+}
+
+TEST_F(LoggerTest, TruncatesLongRecords)
+{
+    Logger::instance().error(std::string(1000, 'x'), 42);
+    Logger::instance().flush();
+
+    ASSERT_EQ(records.size(), 1);
+    EXPECT_EQ(records[0].second, std::string(LogLine::CAPACITY, 'x'));
+}
+
+TEST_F(LoggerTest, ParsesLevelNames)
+{
+    EXPECT_EQ(Logger::parseLevel("debug"), LogLevel::Debug);
+    EXPECT_EQ(Logger::parseLevel("error"), LogLevel::Error);
+    EXPECT_THROW(Logger::parseLevel("verbose"), std::runtime_error);
+}
+
+TEST_F(LoggerTest, ConcurrentProducersLoseNothingButOverflow)
+{
+    constexpr int THREAD_COUNT = 4;
+    constexpr int ITERATIONS = 5000;
+
+    const uint64_t dropped_before = Logger::instance().dropped();
+    std::vector<std::thread> threads;
+    for (int i = 0; i < THREAD_COUNT; ++i)
+    {
+        threads.emplace_back(
+            [i]
+            {
+                for (int j = 0; j < ITERATIONS; ++j) Logger::instance().info("thread ", i, " record ", j);
+            });
+    }
+    for (auto& t : threads) t.join();
+    Logger::instance().flush();
+
+    const uint64_t dropped = Logger::instance().dropped() - dropped_before;
+    EXPECT_EQ(records.size() + dropped, THREAD_COUNT * ITERATIONS);
+    for (const auto& [level, text] : records) EXPECT_EQ(text.rfind("thread ", 0), 0);
+}
\ No newline at end of file
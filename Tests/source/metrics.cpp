@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+
+#include <Metrics/Metrics.hpp>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+TEST(CounterTest, SumsIncrementsFromAllThreads)
+{
+    Counter counter;
+    const int iterations = 10000;
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i)
+        threads.emplace_back(
+            [&counter, iterations]
+            {
+                for (int j = 0; j < iterations; ++j) counter.increment();
+            });
+    for (auto& t : threads) t.join();
+
+    EXPECT_EQ(counter.value(), 4u * iterations);
+}
+
+TEST(LatencyHistogramTest, BucketBoundsContainTheirValues)
+{
+    for (uint64_t value : {0ull, 7ull, 8ull, 15ull, 16ull, 17ull, 1000ull, 123456789ull})
+    {
+        const auto index = LatencyHistogram::bucketIndex(value);
+        EXPECT_GE(LatencyHistogram::bucketUpperBound(index), value);
+        if (index > 0)
+        {
+            EXPECT_LT(LatencyHistogram::bucketUpperBound(index - 1), value);
+        }
+    }
+}
+
+TEST(LatencyHistogramTest, PercentilesAreWithinRelativeError)
+{
+    LatencyHistogram histogram;
+    for (uint64_t i = 1; i <= 1000; ++i) histogram.record(i * 1000);
+
+    const auto snapshot = histogram.snapshot();
+    EXPECT_EQ(snapshot.count, 1000u);
+    EXPECT_EQ(snapshot.sum, 500500000u);
+    EXPECT_NEAR(static_cast<double>(snapshot.percentile(0.5)), 500000.0, 500000.0 / LatencyHistogram::SUB_COUNT);
+    EXPECT_NEAR(static_cast<double>(snapshot.percentile(0.99)), 990000.0, 990000.0 / LatencyHistogram::SUB_COUNT);
+}
+
+TEST(LatencyHistogramTest, ClampsHugeValuesIntoLastBucket)
+{
+    LatencyHistogram histogram;
+    histogram.record(UINT64_MAX / 2);
+
+    const auto snapshot = histogram.snapshot();
+    EXPECT_EQ(snapshot.buckets.back(), 1u);
+}
+
+TEST(MetricsRegistryTest, ReturnsSameSeriesForSameLabels)
+{
+    MetricsRegistry registry;
+    auto& first = registry.counter("test_total", {{"app", "a"}});
+    auto& second = registry.counter("test_total", {{"app", "a"}});
+    auto& other = registry.counter("test_total", {{"app", "b"}});
+
+    EXPECT_EQ(&first, &second);
+    EXPECT_NE(&first, &other);
+}
+
+TEST(MetricsRegistryTest, RendersPrometheusText)
+{
+    MetricsRegistry registry;
+    registry.counter("test_calls_total", {{"app", "a\"b"}}).increment(3);
+    registry.histogram("test_duration_seconds", {{"app", "a"}}).record(std::chrono::microseconds(5));
+
+    const auto text = registry.renderPrometheus();
+    EXPECT_NE(text.find("# TYPE test_calls_total counter"), std::string::npos);
+    EXPECT_NE(text.find("test_calls_total{app=\"a\\\"b\"} 3"), std::string::npos);
+    EXPECT_NE(text.find("# TYPE test_duration_seconds histogram"), std::string::npos);
+    EXPECT_NE(text.find("test_duration_seconds_bucket{app=\"a\",le=\"+Inf\"} 1"), std::string::npos);
+    EXPECT_NE(text.find("test_duration_seconds_count{app=\"a\"} 1"), std::string::npos);
+}
+
+TEST(MetricsRegistryTest, RecordsEveryCallFromHotLoops)
+{
+    MetricsRegistry registry;
+    auto& counter = registry.counter("bench_total");
+    auto& histogram = registry.histogram("bench_seconds");
+    const int iterations = 1000000;
+
+    for (int i = 0; i < iterations; ++i)
+    {
+        counter.increment();
+        histogram.record(static_cast<uint64_t>(i));
+    }
+    for (int i = 0; i < iterations; ++i) ScopedTimer timer(&histogram);
+
+    EXPECT_EQ(counter.value(), static_cast<uint64_t>(iterations));
+    EXPECT_EQ(histogram.snapshot().count, static_cast<uint64_t>(2 * iterations));
+}
\ No newline at end of file
@@ -0,0 +1,87 @@
+#include <Metrics/Metrics.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+// Reports the cost of the hot-path instruments. Nothing is asserted: the numbers depend on the machine and are
+// meant to be compared between builds, not to fail a run.
+
+namespace
+{
+volatile uint64_t sink = 0;
+
+template <typename Body>
+double nanosecondsPerCall(int iterations, Body body)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) body(i);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / iterations;
+}
+
+void report(const char* name, double nanoseconds, double baseline)
+{
+    std::printf("%-34s %8.2f ns/call  (%+.2f ns over the empty loop)\n", name, nanoseconds, nanoseconds - baseline);
+}
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    const int iterations = argc > 1 ? std::atoi(argv[1]) : 10000000;
+    if (iterations <= 0)
+    {
+        std::fprintf(stderr, "Usage: %s [iterations]\n", argv[0]);
+        return 1;
+    }
+
+    MetricsRegistry registry;
+    auto& counter = registry.counter("bench_total");
+    auto& histogram = registry.histogram("bench_seconds");
+
+    const double baseline = nanosecondsPerCall(iterations, [](int i) { sink = sink + static_cast<uint64_t>(i); });
+    report("empty loop", baseline, baseline);
+    report("Counter::increment", nanosecondsPerCall(iterations, [&counter](int) { counter.increment(); }), baseline);
+    report("LatencyHistogram::record",
+           nanosecondsPerCall(iterations, [&histogram](int i) { histogram.record(static_cast<uint64_t>(i)); }),
+           baseline);
+    report("counter + histogram",
+           nanosecondsPerCall(iterations,
+                              [&counter, &histogram](int i)
+                              {
+                                  counter.increment();
+                                  histogram.record(static_cast<uint64_t>(i));
+                              }),
+           baseline);
+    report("ScopedTimer", nanosecondsPerCall(iterations, [&histogram](int) { ScopedTimer timer(&histogram); }),
+           baseline);
+    report("ScopedTimer (disabled)", nanosecondsPerCall(iterations, [](int) { ScopedTimer timer(nullptr); }),
+           baseline);
+
+    const unsigned threads = std::max(2u, std::thread::hardware_concurrency());
+    std::vector<std::thread> workers;
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned t = 0; t < threads; ++t)
+        workers.emplace_back(
+            [&counter, &histogram, iterations]
+            {
+                for (int i = 0; i < iterations; ++i)
+                {
+                    counter.increment();
+                    histogram.record(static_cast<uint64_t>(i));
+                }
+            });
+    for (auto& worker : workers) worker.join();
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    const double contended =
+        static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / iterations;
+    std::printf("%-34s %8.2f ns/call  (%u threads, wall time per iteration)\n", "counter + histogram, contended",
+                contended, threads);
+
+    std::printf("recorded %llu increments, %llu samples\n", static_cast<unsigned long long>(counter.value()),
+                static_cast<unsigned long long>(histogram.snapshot().count));
+    return 0;
+}
\ No newline at end of file
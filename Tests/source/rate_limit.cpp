@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+
+#include <RateLimiter/RateLimiter.hpp>
+
+using namespace std::chrono_literals;
+
+TEST(RateLimiterTest, UnlimitedByDefault)
+{
+    RateLimiter limiter;
+    for (int i = 0; i < 1000; ++i) EXPECT_TRUE(limiter.tryAcquire(":1.1"));
+    EXPECT_EQ(limiter.senders(), 0);
+}
+
+TEST(RateLimiterTest, AllowsBurstThenRefillsAtRate)
+{
+    RateLimiter limiter({10, 3});
+    const auto start = RateLimiter::Clock::now();
+
+    EXPECT_TRUE(limiter.tryAcquire(":1.1", start));
+    EXPECT_TRUE(limiter.tryAcquire(":1.1", start));
+    EXPECT_TRUE(limiter.tryAcquire(":1.1", start));
+    EXPECT_FALSE(limiter.tryAcquire(":1.1", start));
+
+    // One token every 100 ms
+    EXPECT_FALSE(limiter.tryAcquire(":1.1", start + 50ms));
+    EXPECT_TRUE(limiter.tryAcquire(":1.1", start + 100ms));
+    EXPECT_FALSE(limiter.tryAcquire(":1.1", start + 100ms));
+}
+
+TEST(RateLimiterTest, SendersHaveSeparateBuckets)
+{
+    RateLimiter limiter({1, 1});
+    const auto now = RateLimiter::Clock::now();
+
+    EXPECT_TRUE(limiter.tryAcquire(":1.1", now));
+    EXPECT_FALSE(limiter.tryAcquire(":1.1", now));
+    EXPECT_TRUE(limiter.tryAcquire(":1.2", now));
+    EXPECT_EQ(limiter.senders(), 2);
+}
+
+TEST(RateLimiterTest, PrunesIdleSenders)
+{
+    RateLimiter limiter({100, 1});
+    const auto start = RateLimiter::Clock::now();
+    for (std::size_t i = 0; i < RateLimiter::MAX_IDLE_BUCKETS; ++i)
+        limiter.tryAcquire(":1." + std::to_string(i), start);
+    EXPECT_EQ(limiter.senders(), RateLimiter::MAX_IDLE_BUCKETS);
+
+    // Every bucket has refilled after a second, so the next new sender clears them
+    limiter.tryAcquire(":2.0", start + 1s);
+    EXPECT_EQ(limiter.senders(), 1);
+}
\ No newline at end of file
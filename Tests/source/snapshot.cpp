@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include <sdbus-c++/sdbus-c++.h>
+
+#include <AppConfig/AppConfig.hpp>
+#include <BinaryCodec/BinaryCodec.hpp>
+#include <ConfigSnapshot/ConfigSnapshot.hpp>
+#include <ContentStore/ContentStore.hpp>
+
+class SnapshotTest : public ::testing::Test
+{
+   protected:
+    void SetUp() override
+    {
+        test_config = {{"Timeout", sdbus::Variant(uint32_t{1000})},
+                       {"TimeoutPhrase", sdbus::Variant(std::string{"Test"})},
+                       {"Offset", sdbus::Variant(int32_t{-5})},
+                       {"DebugMode", sdbus::Variant(true)}};
+    }
+
+    std::map<std::string, sdbus::Variant> test_config;
+};
+
+TEST_F(SnapshotTest, BinaryCodecRoundTrip)
+{
+    std::string buffer;
+    BinaryWriter(buffer).writeConfiguration(test_config);
+
+    BinaryReader reader(buffer.data(), buffer.size());
+    auto config = reader.readConfiguration();
+
+    EXPECT_TRUE(reader.atEnd());
+    EXPECT_EQ(config.size(), 4);
+    EXPECT_EQ(config["Timeout"].get<uint32_t>(), 1000);
+    EXPECT_EQ(config["TimeoutPhrase"].get<std::string>(), "Test");
+    EXPECT_EQ(config["Offset"].get<int32_t>(), -5);
+    EXPECT_EQ(config["DebugMode"].get<bool>(), true);
+}
+
+TEST_F(SnapshotTest, BinaryCodecRejectsTruncatedData)
+{
+    std::string buffer;
+    BinaryWriter(buffer).writeConfiguration(test_config);
+
+    BinaryReader reader(buffer.data(), buffer.size() - 1);
+    EXPECT_THROW(reader.readConfiguration(), std::runtime_error);
+}
+
+TEST_F(SnapshotTest, ReaderSeesPublishedConfiguration)
+{
+    SnapshotWriter writer("testApp", test_config);
+    const auto fd = writer.readOnlyFd();
+    SnapshotReader reader(fd.get());
+
+    uint64_t generation = 0;
+    auto config = reader.read(&generation);
+    ASSERT_TRUE(config.has_value());
+    EXPECT_EQ(generation, 1);
+    EXPECT_EQ((*config)["Timeout"].get<uint32_t>(), 1000);
+
+    test_config["Timeout"] = sdbus::Variant(uint32_t{2000});
+    writer.publish(test_config);
+
+    EXPECT_EQ(reader.generation(), 2);
+    config = reader.read(&generation);
+    ASSERT_TRUE(config.has_value());
+    EXPECT_EQ(generation, 2);
+    EXPECT_EQ((*config)["Timeout"].get<uint32_t>(), 2000);
+}
+
+TEST_F(SnapshotTest, GrowingConfigurationMovesToNewSegment)
+{
+    SnapshotWriter writer("testApp", test_config);
+    const auto old_fd = writer.readOnlyFd();
+    SnapshotReader old_reader(old_fd.get());
+
+    test_config["Large"] = sdbus::Variant(std::string(64 * 1024, 'x'));
+    writer.publish(test_config);
+
+    EXPECT_TRUE(old_reader.stale());
+    EXPECT_FALSE(old_reader.read().has_value());
+
+    const auto new_fd = writer.readOnlyFd();
+    SnapshotReader new_reader(new_fd.get());
+    auto config = new_reader.read();
+    ASSERT_TRUE(config.has_value());
+    EXPECT_EQ((*config)["Large"].get<std::string>().size(), 64 * 1024);
+    EXPECT_EQ(new_reader.generation(), 2);
+}
+
+TEST_F(SnapshotTest, StorageIsPublishedFromItsStoredValues)
+{
+    ContentStore::instance().setSealAbove(64);
+    test_config["Bundle"] = sdbus::Variant(std::string(100, 'b'));
+    AppConfig storage("testApp", test_config);
+    ContentStore::instance().setSealAbove(0);
+    ASSERT_GE(storage.getParameter("Bundle")->descriptor(), 0);
+
+    SnapshotWriter writer("testApp", storage);
+    const auto fd = writer.readOnlyFd();
+    SnapshotReader reader(fd.get());
+
+    auto config = reader.read();
+    ASSERT_TRUE(config.has_value());
+    EXPECT_EQ(config->size(), 5);
+    EXPECT_EQ((*config)["Offset"].get<int32_t>(), -5);
+    EXPECT_EQ((*config)["DebugMode"].get<bool>(), true);
+    // Sealed strings are published as their contents, the same as from a map
+    EXPECT_EQ((*config)["Bundle"].get<std::string>(), std::string(100, 'b'));
+
+    storage.setParameter("Timeout", sdbus::Variant(uint32_t{2000}));
+    writer.publish(storage);
+    EXPECT_EQ(reader.generation(), 2);
+    EXPECT_EQ((*reader.read())["Timeout"].get<uint32_t>(), 2000);
+}
\ No newline at end of file
@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+
+#include <TimerService/TimerService.hpp>
+#include <TimerWheel/TimerWheel.hpp>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+TEST(TimerServiceTest, FiresInDeadlineOrder)
+{
+    TimerService timers;
+    std::mutex mutex;
+    std::vector<int> order;
+    std::promise<void> done;
+    auto record = [&mutex, &order](int value)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        order.push_back(value);
+    };
+
+    timers.schedule(150ms,
+                    [&record, &done]
+                    {
+                        record(3);
+                        done.set_value();
+                    });
+    timers.schedule(50ms, [&record] { record(1); });
+    timers.schedule(100ms, [&record] { record(2); });
+
+    ASSERT_EQ(done.get_future().wait_for(2s), std::future_status::ready);
+    EXPECT_EQ(order, (std::vector<int>{1, 2, 3}));
+    EXPECT_EQ(timers.pending(), 0);
+}
+
+TEST(TimerServiceTest, CancelledTimersDoNotFire)
+{
+    TimerService timers;
+    std::atomic<int> fired{0};
+    std::promise<void> done;
+
+    std::vector<TimerService::TimerId> cancelled;
+    for (int i = 0; i < 1000; ++i) cancelled.push_back(timers.schedule(50ms, [&fired] { ++fired; }));
+    timers.schedule(100ms, [&done] { done.set_value(); });
+    for (const auto id : cancelled) EXPECT_TRUE(timers.cancel(id));
+    EXPECT_EQ(timers.pending(), 1);
+
+    ASSERT_EQ(done.get_future().wait_for(2s), std::future_status::ready);
+    EXPECT_EQ(fired.load(), 0);
+    EXPECT_FALSE(timers.cancel(cancelled.front()));
+}
+
+TEST(TimerServiceTest, CancelWaitsForRunningCallback)
+{
+    TimerService timers;
+    std::promise<void> started;
+    std::atomic<bool> finished{false};
+
+    const auto id = timers.schedule(0ms,
+                                    [&started, &finished]
+                                    {
+                                        started.set_value();
+                                        std::this_thread::sleep_for(100ms);
+                                        finished = true;
+                                    });
+    started.get_future().wait();
+
+    EXPECT_FALSE(timers.cancel(id));
+    EXPECT_TRUE(finished.load());
+}
+
+TEST(TimerWheelTest, FiresAfterDelayAcrossLevels)
+{
+    TimerService timers;
+    TimerWheel wheel(timers, 1ms);
+    std::mutex mutex;
+    std::vector<int> order;
+    std::promise<void> done;
+    const auto start = std::chrono::steady_clock::now();
+
+    // 300 ticks lie beyond the 64 slots of the first level and are cascaded down
+    wheel.schedule(300ms,
+                   [&mutex, &order, &done]
+                   {
+                       std::lock_guard<std::mutex> lock(mutex);
+                       order.push_back(300);
+                       done.set_value();
+                   });
+    for (const int delay : {150, 20, 90})
+        wheel.schedule(std::chrono::milliseconds(delay),
+                       [&mutex, &order, delay]
+                       {
+                           std::lock_guard<std::mutex> lock(mutex);
+                           order.push_back(delay);
+                       });
+
+    ASSERT_EQ(done.get_future().wait_for(2s), std::future_status::ready);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, 300ms);
+    EXPECT_EQ(order, (std::vector<int>{20, 90, 150, 300}));
+    EXPECT_EQ(wheel.pending(), 0);
+}
+
+TEST(TimerWheelTest, CancelsManyTimersCheaply)
+{
+    TimerService timers;
+    TimerWheel wheel(timers, 10ms);
+    std::atomic<int> fired{0};
+    std::promise<void> done;
+
+    std::vector<TimerWheel::TimerId> ids;
+    for (int i = 0; i < 100000; ++i)
+        ids.push_back(wheel.schedule(std::chrono::milliseconds(1000 + i % 5000), [&fired] { ++fired; }));
+    wheel.schedule(100ms, [&done] { done.set_value(); });
+    for (const auto id : ids) EXPECT_TRUE(wheel.cancel(id));
+    EXPECT_EQ(wheel.pending(), 1);
+
+    ASSERT_EQ(done.get_future().wait_for(2s), std::future_status::ready);
+    EXPECT_EQ(fired.load(), 0);
+    EXPECT_FALSE(wheel.cancel(ids.front()));
+}
\ No newline at end of file
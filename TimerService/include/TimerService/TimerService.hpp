@@ -0,0 +1,104 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class TimerService
+ * @brief One-shot timers run by a single thread in deadline order
+ *
+ * Deadlines are kept in a binary min-heap, so scheduling and firing cost
+ * O(log n) and the thread sleeps until the earliest deadline no matter how
+ * many timers are armed. Cancelling only forgets the callback; the stale heap
+ * entry is skipped when it comes up, and the heap is rebuilt when stale
+ * entries outnumber live ones.
+ *
+ * Callbacks run on the timer thread one at a time and must not block.
+ *
+ * Thread-safe.
+ */
+class TimerService
+{
+   public:
+    using Clock = std::chrono::steady_clock;
+    using TimerId = uint64_t;
+    using Callback = std::function<void()>;
+
+    /**
+     * @brief Start the timer thread
+     */
+    TimerService();
+
+    TimerService(const TimerService&) = delete;
+    TimerService& operator=(const TimerService&) = delete;
+
+    /**
+     * @brief Stop the timer thread; armed timers never fire
+     */
+    ~TimerService();
+
+    /**
+     * @brief Arm a timer
+     * @param delay Time until the callback runs
+     * @param callback Callback to run on the timer thread
+     * @return Identifier for cancel(), never 0
+     */
+    TimerId schedule(Clock::duration, Callback);
+
+    /**
+     * @brief Disarm a timer
+     *
+     * If the callback is running on another thread, waits until it returns, so
+     * the caller may destroy what the callback uses.
+     * @param id Identifier returned by schedule()
+     * @return true if the timer was armed and will not fire
+     */
+    bool cancel(TimerId);
+
+    /**
+     * @brief Get the number of armed timers
+     * @return Timers that have neither fired nor been cancelled
+     */
+    [[nodiscard]] std::size_t pending() const;
+
+   private:
+    /**
+     * @struct Deadline
+     * @brief Heap entry, ordered so that the earliest deadline is on top
+     */
+    struct Deadline
+    {
+        Clock::time_point when;
+        TimerId id;
+
+        bool operator>(const Deadline& other) const { return when > other.when; }
+    };
+
+    /**
+     * @brief Fire timers until stopped
+     * @param stop_token Stop request of the thread
+     */
+    void run(std::stop_token);
+
+    /**
+     * @brief Drop heap entries of cancelled timers, the lock is held
+     */
+    void compact();
+
+    std::priority_queue<Deadline, std::vector<Deadline>, std::greater<>> deadlines_;
+    std::unordered_map<TimerId, Callback> callbacks_;
+    TimerId next_id_ = 1;
+    TimerId running_ = 0;
+
+    mutable std::mutex mutex_;
+    std::condition_variable_any wake_;
+    std::condition_variable callback_done_;
+    std::jthread thread_;
+};
\ No newline at end of file
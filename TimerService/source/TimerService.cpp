@@ -0,0 +1,111 @@
+#include "TimerService/TimerService.hpp"
+
+#include <Logger/Logger.hpp>
+
+TimerService::TimerService()
+{
+    thread_ = std::jthread([this](std::stop_token stop_token) { run(stop_token); });
+}
+
+TimerService::~TimerService()
+{
+    thread_.request_stop();
+    if (thread_.joinable())
+        thread_.join();
+}
+
+TimerService::TimerId TimerService::schedule(Clock::duration delay, Callback callback)
+{
+    bool earliest;
+    TimerId id;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        id = next_id_++;
+        const Deadline deadline{Clock::now() + delay, id};
+        earliest = deadlines_.empty() || deadline.when < deadlines_.top().when;
+        deadlines_.push(deadline);
+        callbacks_.emplace(id, std::move(callback));
+    }
+    // Only a new earliest deadline shortens the sleep of the timer thread
+    if (earliest)
+        wake_.notify_one();
+    return id;
+}
+
+bool TimerService::cancel(TimerId id)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (callbacks_.erase(id) > 0)
+    {
+        if (deadlines_.size() > 2 * callbacks_.size() + 64)
+            compact();
+        return true;
+    }
+    if (std::this_thread::get_id() != thread_.get_id())
+        callback_done_.wait(lock, [this, id] { return running_ != id; });
+    return false;
+}
+
+std::size_t TimerService::pending() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return callbacks_.size();
+}
+
+void TimerService::compact()
+{
+    std::vector<Deadline> live;
+    live.reserve(callbacks_.size());
+    while (!deadlines_.empty())
+    {
+        if (callbacks_.contains(deadlines_.top().id))
+            live.push_back(deadlines_.top());
+        deadlines_.pop();
+    }
+    deadlines_ = decltype(deadlines_)(std::greater<>(), std::move(live));
+}
+
+void TimerService::run(std::stop_token stop_token)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_token.stop_requested())
+    {
+        if (deadlines_.empty())
+        {
+            wake_.wait(lock, stop_token, [this] { return !deadlines_.empty(); });
+            continue;
+        }
+
+        const Deadline next = deadlines_.top();
+        if (Clock::now() < next.when)
+        {
+            wake_.wait_until(lock, stop_token, next.when,
+                             [this, &next] { return deadlines_.empty() || deadlines_.top().when < next.when; });
+            continue;
+        }
+
+        deadlines_.pop();
+        const auto it = callbacks_.find(next.id);
+        if (it == callbacks_.end())
+            continue;
+
+        Callback callback = std::move(it->second);
+        callbacks_.erase(it);
+        running_ = next.id;
+        lock.unlock();
+
+        try
+        {
+            callback();
+        }
+        catch (const std::exception& e)
+        {
+            Logger::instance().error("Timer callback failed: ", e.what());
+        }
+        callback = nullptr;
+
+        lock.lock();
+        running_ = 0;
+        callback_done_.notify_all();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <TimerService/TimerService.hpp>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+static constexpr std::chrono::milliseconds DEFAULT_WHEEL_TICK{100};
+
+/**
+ * @class TimerWheel
+ * @brief Hierarchical timing wheel for large numbers of coarse one-shot timers
+ *
+ * Four levels of 64 slots cover 2^24 ticks (about 19 days at the default
+ * 100 ms tick); later deadlines wait in the top level and are placed again
+ * when it cascades. Scheduling and cancelling are O(1), and a tick only
+ * touches one level-0 slot, plus one slot of each higher level every 64^n
+ * ticks, however many timers are pending. Cancelled timers are skipped when
+ * their slot comes up.
+ *
+ * The wheel is turned by a TimerService timer that is armed only while timers
+ * are pending, so an idle wheel costs no wakeups. A late tick catches up on
+ * every tick it missed. Callbacks run on the TimerService thread, in deadline
+ * order at tick granularity, and fire at most one tick late.
+ *
+ * Thread-safe.
+ */
+class TimerWheel
+{
+   public:
+    using TimerId = uint64_t;
+    using Callback = std::function<void()>;
+
+    /**
+     * @brief Create an idle wheel
+     * @param timers Service turning the wheel, must outlive it
+     * @param tick Resolution of the wheel
+     */
+    explicit TimerWheel(TimerService&, std::chrono::milliseconds = DEFAULT_WHEEL_TICK);
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    /**
+     * @brief Stop turning the wheel; pending timers never fire
+     */
+    ~TimerWheel();
+
+    /**
+     * @brief Arm a timer
+     * @param delay Time until the callback runs, rounded up to whole ticks
+     * @param callback Callback to run on the TimerService thread
+     * @return Identifier for cancel(), never 0
+     */
+    TimerId schedule(std::chrono::milliseconds, Callback);
+
+    /**
+     * @brief Disarm a timer
+     *
+     * If the callback is running on another thread, waits until it returns.
+     * @param id Identifier returned by schedule()
+     * @return true if the timer was armed and will not fire
+     */
+    bool cancel(TimerId);
+
+    /**
+     * @brief Get the number of armed timers
+     * @return Timers that have neither fired nor been cancelled
+     */
+    [[nodiscard]] std::size_t pending() const;
+
+   private:
+    static constexpr std::size_t LEVELS = 4;
+    static constexpr unsigned SLOT_BITS = 6;
+    static constexpr std::size_t SLOTS = std::size_t{1} << SLOT_BITS;
+    static constexpr uint64_t SLOT_MASK = SLOTS - 1;
+
+    /**
+     * @struct Entry
+     * @brief Armed timer
+     */
+    struct Entry
+    {
+        uint64_t expiry;  ///< Tick the timer fires at
+        Callback callback;
+    };
+
+    using Due = std::vector<std::pair<TimerId, Callback>>;
+
+    /**
+     * @brief Get the tick a point in time falls into
+     * @param time Point in time
+     * @return Ticks since the wheel was created
+     */
+    [[nodiscard]] uint64_t tickAt(TimerService::Clock::time_point) const;
+
+    /**
+     * @brief Put a timer into the slot of its expiry relative to the current tick, the lock is held
+     * @param id Timer identifier
+     * @param expiry Tick the timer fires at, not before the current tick
+     */
+    void place(TimerId, uint64_t);
+
+    /**
+     * @brief Remove the ids of cancelled timers from every slot, the lock is held
+     */
+    void sweep();
+
+    /**
+     * @brief Move to the next tick, cascading higher levels and collecting due timers, the lock is held
+     * @param due Receives the timers that fire at the new tick
+     */
+    void advance(Due&);
+
+    /**
+     * @brief Arm the TimerService timer for the next tick if timers are pending, the lock is held
+     */
+    void arm();
+
+    /**
+     * @brief Catch up with the clock and run the due callbacks, called by the TimerService timer
+     */
+    void onTick();
+
+    TimerService& timers_;
+    std::chrono::milliseconds tick_;
+    TimerService::Clock::time_point start_;
+    uint64_t current_tick_ = 0;
+    std::array<std::array<std::vector<TimerId>, SLOTS>, LEVELS> slots_;
+    std::unordered_map<TimerId, Entry> entries_;
+    TimerId next_id_ = 1;
+    std::size_t stale_ = 0;  ///< Cancelled ids possibly left in slots
+
+    TimerService::TimerId tick_timer_ = 0;
+    std::unordered_set<TimerId> firing_;  ///< Collected by a tick and not run yet
+    TimerId running_ = 0;
+    bool ticking_ = false;
+    std::thread::id firing_thread_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable callback_done_;
+};
\ No newline at end of file
@@ -0,0 +1,198 @@
+#include "TimerWheel/TimerWheel.hpp"
+
+#include <Logger/Logger.hpp>
+#include <algorithm>
+
+TimerWheel::TimerWheel(TimerService& timers, std::chrono::milliseconds tick)
+    : timers_(timers), tick_(std::max(tick, std::chrono::milliseconds(1))), start_(TimerService::Clock::now())
+{
+}
+
+TimerWheel::~TimerWheel()
+{
+    TimerService::TimerId tick_timer;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        entries_.clear();
+        firing_.clear();
+        // A tick that already started may still be running the callback it collected
+        if (std::this_thread::get_id() != firing_thread_)
+            callback_done_.wait(lock, [this] { return !ticking_; });
+        tick_timer = tick_timer_;
+        tick_timer_ = 0;
+    }
+    // Also waits for a tick that has been started by the service but not taken the lock yet
+    if (tick_timer)
+        timers_.cancel(tick_timer);
+}
+
+uint64_t TimerWheel::tickAt(TimerService::Clock::time_point time) const
+{
+    return static_cast<uint64_t>((time - start_) / tick_);
+}
+
+TimerWheel::TimerId TimerWheel::schedule(std::chrono::milliseconds delay, Callback callback)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto now = TimerService::Clock::now();
+    if (entries_.empty())
+    {
+        // Nothing is pending: drop the ids of cancelled timers and jump to the present
+        for (auto& level : slots_)
+            for (auto& slot : level) slot.clear();
+        stale_ = 0;
+        current_tick_ = std::max(current_tick_, tickAt(now));
+    }
+
+    // The first tick boundary at or after the deadline
+    const TimerService::Clock::duration tick = tick_;
+    const auto deadline = now - start_ + std::max(delay, std::chrono::milliseconds(0));
+    const uint64_t expiry =
+        std::max(static_cast<uint64_t>((deadline.count() + tick.count() - 1) / tick.count()), current_tick_ + 1);
+
+    const TimerId id = next_id_++;
+    entries_.emplace(id, Entry{expiry, std::move(callback)});
+    place(id, expiry);
+    arm();
+    return id;
+}
+
+bool TimerWheel::cancel(TimerId id)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (entries_.erase(id) > 0)
+    {
+        // The id stays in its slot until the slot comes up or stale ids outnumber live ones
+        if (++stale_ > entries_.size() + 1024)
+            sweep();
+        return true;
+    }
+    if (running_ != id && firing_.erase(id) > 0)
+        return true;
+    if (std::this_thread::get_id() != firing_thread_)
+        callback_done_.wait(lock, [this, id] { return running_ != id; });
+    return false;
+}
+
+std::size_t TimerWheel::pending() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size() + firing_.size();
+}
+
+void TimerWheel::place(TimerId id, uint64_t expiry)
+{
+    const uint64_t delta = expiry - current_tick_;
+    for (std::size_t level = 0; level < LEVELS; ++level)
+    {
+        if (delta < (uint64_t{1} << (SLOT_BITS * (level + 1))))
+        {
+            slots_[level][(expiry >> (SLOT_BITS * level)) & SLOT_MASK].push_back(id);
+            return;
+        }
+    }
+
+    // Beyond the range of the wheel: wait in the last reachable top-level slot and be placed again from there
+    const uint64_t latest = current_tick_ + (uint64_t{1} << (SLOT_BITS * LEVELS)) - 1;
+    slots_[LEVELS - 1][(latest >> (SLOT_BITS * (LEVELS - 1))) & SLOT_MASK].push_back(id);
+}
+
+void TimerWheel::sweep()
+{
+    for (auto& level : slots_)
+    {
+        for (auto& slot : level)
+            std::erase_if(slot, [this](TimerId id) { return !entries_.contains(id); });
+    }
+    stale_ = 0;
+}
+
+void TimerWheel::advance(Due& due)
+{
+    ++current_tick_;
+
+    // Cascade from the highest level whose slot boundary was crossed, so its timers can land in lower slots
+    std::size_t top = 0;
+    while (top + 1 < LEVELS && (current_tick_ & ((uint64_t{1} << (SLOT_BITS * (top + 1))) - 1)) == 0) ++top;
+    for (std::size_t level = top; level > 0; --level)
+    {
+        std::vector<TimerId> ids;
+        ids.swap(slots_[level][(current_tick_ >> (SLOT_BITS * level)) & SLOT_MASK]);
+        for (const TimerId id : ids)
+        {
+            if (const auto it = entries_.find(id); it != entries_.end())
+                place(id, it->second.expiry);
+        }
+    }
+
+    std::vector<TimerId> ids;
+    ids.swap(slots_[0][current_tick_ & SLOT_MASK]);
+    for (const TimerId id : ids)
+    {
+        const auto it = entries_.find(id);
+        if (it == entries_.end())
+            continue;
+        if (it->second.expiry > current_tick_)
+        {
+            place(id, it->second.expiry);
+            continue;
+        }
+        due.emplace_back(id, std::move(it->second.callback));
+        firing_.insert(id);
+        entries_.erase(it);
+    }
+}
+
+void TimerWheel::arm()
+{
+    if (tick_timer_ || entries_.empty())
+        return;
+
+    const auto next = start_ + tick_ * static_cast<int64_t>(current_tick_ + 1);
+    tick_timer_ = timers_.schedule(std::max(next - TimerService::Clock::now(), TimerService::Clock::duration::zero()),
+                                   [this] { onTick(); });
+}
+
+void TimerWheel::onTick()
+{
+    Due due;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tick_timer_ = 0;
+        ticking_ = true;
+        firing_thread_ = std::this_thread::get_id();
+
+        const uint64_t target = tickAt(TimerService::Clock::now());
+        while (current_tick_ < target && !entries_.empty()) advance(due);
+        arm();
+    }
+
+    for (auto& [id, callback] : due)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (firing_.erase(id) == 0)
+                continue;
+            running_ = id;
+        }
+
+        try
+        {
+            callback();
+        }
+        catch (const std::exception& e)
+        {
+            Logger::instance().error("Timer wheel callback failed: ", e.what());
+        }
+        callback = nullptr;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = 0;
+        callback_done_.notify_all();
+    }
+
+    // Notified under the lock: the destructor may run as soon as it sees the tick finished
+    std::lock_guard<std::mutex> lock(mutex_);
+    ticking_ = false;
+    callback_done_.notify_all();
+}
\ No newline at end of file